@@ -0,0 +1,254 @@
+/**
+ ******************************************************************************
+ * @file    GPSDatalogArchive.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Exported datalog archives, memory-mapped for reading.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_DATALOG_ARCHIVE_H__
+#define __GPS_DATALOG_ARCHIVE_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "GPSProviderCommon.h"
+#include "GPSProvider.h"
+
+class GPSDatalogEngine; /* forward declaration */
+
+//
+// Archive file for exported datalogs, laid out so that a reader can map it
+// and use the records in place:
+//
+//  header, at offset 0 (little-endian)
+//      0  magic "GPSARC01"
+//      8  uint32 header size (64)
+//     12  uint32 record size (32)
+//     16  uint64 number of records
+//     24  uint64 offset of the time index
+//     32  uint32 index stride (records per index entry)
+//     36  uint32 number of index entries
+//     40  uint64 UTC time (ms) of the first record
+//     48  uint64 UTC time (ms) of the last record
+//     56  uint32 reserved (0)
+//     60  uint16 CRC-16/CCITT-FALSE of bytes 0..59
+//     62  uint16 reserved (0)
+//
+//  records, at offset 64, in time order: GPSDatalogArchive::Record_t
+//
+//  time index, 8-byte aligned: uint64 UTC time (ms) of records 0, stride,
+//  2 * stride, ...
+//
+// Opening an archive only reads the header: its cost does not depend on the
+// file size. A time range is found by a binary search over the index, then
+// over at most one stride of records.
+//
+//      GPSDatalogArchiveWriter writer;
+//      writer.create("track.gpa");
+//      writer.exportLog(datalog);
+//      writer.finish();
+//
+//      GPSDatalogArchive archive;
+//      archive.open("track.gpa");
+//      const GPSDatalogArchive::Record_t *begin, *end;
+//      archive.slice(fromMs, toMs, begin, end);
+//      for (const GPSDatalogArchive::Record_t *r = begin; r != end; r++) {
+//          ...
+//      }
+//
+
+class GPSDatalogArchive {
+public:
+    static const unsigned HEADER_SIZE = 64;
+
+    /** Records per index entry used by GPSDatalogArchiveWriter. */
+    static const unsigned INDEX_STRIDE = 1024;
+
+    /** A record, as stored in the file (32 bytes, naturally aligned) */
+    struct Record_t {
+        uint64_t utcTime;      /**< UTC time in millisecond */
+        int32_t  lat;          /**< 1e-7 degree */
+        int32_t  lon;          /**< 1e-7 degree */
+        int32_t  altitude;     /**< cm */
+        uint32_t odo;          /**< dm */
+        uint16_t speed;        /**< cm/s */
+        uint8_t  fix;
+        uint8_t  quality;
+        uint8_t  geo;
+        uint8_t  logMask;
+        uint8_t  statusBitmap;
+        uint8_t  reserved;
+    };
+
+    GPSDatalogArchive();
+    virtual ~GPSDatalogArchive();
+
+    /**
+     * Map an archive read-only.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_DATALOG_CFG if the file
+     *     is not a valid archive / GPS_ERROR_LOG_NOT_IMPLEMENTED on targets
+     *     without mmap() or big-endian hosts.
+     */
+    gps_provider_error_t open(const char *path);
+
+    void close(void);
+
+    bool isOpen(void) const {
+        return _map != NULL;
+    }
+
+    uint64_t getCount(void) const {
+        return _count;
+    }
+
+    /**
+     * @return the records, valid until close().
+     */
+    const Record_t *getRecords(void) const {
+        return _records;
+    }
+
+    uint64_t getFirstUtcMs(void) const {
+        return _firstUtcMs;
+    }
+
+    uint64_t getLastUtcMs(void) const {
+        return _lastUtcMs;
+    }
+
+    /**
+     * @return the position of the first record at or after utcMs,
+     *     getCount() if there is none.
+     */
+    uint64_t findRecord(uint64_t utcMs) const;
+
+    /**
+     * Select the records with fromMs <= utcTime < toMs; the pages of the
+     * range are announced to the kernel for read-ahead.
+     *
+     * @return the number of records in [begin, end).
+     */
+    uint64_t slice(uint64_t fromMs, uint64_t toMs, const Record_t *&begin, const Record_t *&end) const;
+
+    /**
+     * Convert a record into a query response.
+     */
+    static void toQueryResp(const Record_t &record, GPSProvider::LogQueryRespParams_t &resp);
+
+private:
+    void                        *_map;
+    size_t                      _mapSize;
+    const Record_t              *_records;
+    const uint64_t              *_index;
+    uint64_t                    _count;
+    uint32_t                    _stride;
+    uint32_t                    _indexCount;
+    uint64_t                    _firstUtcMs;
+    uint64_t                    _lastUtcMs;
+
+    /* disallow copy constructor and assignment operators */
+    GPSDatalogArchive(const GPSDatalogArchive&);
+    GPSDatalogArchive & operator= (const GPSDatalogArchive&);
+};
+
+class GPSDatalogArchiveWriter {
+public:
+    GPSDatalogArchiveWriter();
+    virtual ~GPSDatalogArchiveWriter();
+
+    /**
+     * Create (or truncate) an archive file.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_DATALOG_CFG.
+     */
+    gps_provider_error_t create(const char *path);
+
+    /**
+     * Append a record; records must come in time order.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_DATALOG_CFG if the
+     *     record is older than the previous one / GPS_ERROR_NO_MEM /
+     *     GPS_ERROR_DATALOG_STOP on I/O error.
+     */
+    gps_provider_error_t add(const GPSDatalogArchive::Record_t &record);
+
+    /**
+     * Append a log entry.
+     */
+    gps_provider_error_t add(const GPSProvider::LogQueryRespParams_t &entry);
+
+    /**
+     * Append every record of a datalog store, oldest first.
+     */
+    gps_provider_error_t exportLog(GPSDatalogEngine &log);
+
+    /**
+     * Write the index and the header, then close the file.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_DATALOG_STOP on I/O error.
+     */
+    gps_provider_error_t finish(void);
+
+    uint64_t getCount(void) const {
+        return _count;
+    }
+
+    /**
+     * Convert a log entry into a record.
+     */
+    static void fromQueryResp(const GPSProvider::LogQueryRespParams_t &entry, GPSDatalogArchive::Record_t &record);
+
+private:
+    static const unsigned BUFFER_RECORDS = 256;
+
+    bool flushBuffer(void);
+
+    FILE                        *_file;
+    uint64_t                    _count;
+    uint64_t                    _firstUtcMs;
+    uint64_t                    _lastUtcMs;
+    uint64_t                    *_index;
+    uint32_t                    _indexCount;
+    uint32_t                    _indexCapacity;
+    uint8_t                     *_buffer;
+    unsigned                    _buffered;
+    bool                        _failed;
+
+    /* disallow copy constructor and assignment operators */
+    GPSDatalogArchiveWriter(const GPSDatalogArchiveWriter&);
+    GPSDatalogArchiveWriter & operator= (const GPSDatalogArchiveWriter&);
+};
+
+#endif /* __GPS_DATALOG_ARCHIVE_H__ */
@@ -0,0 +1,179 @@
+/**
+ ******************************************************************************
+ * @file    GPSDatalogDownloader.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Batched, flow-controlled datalog download.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_DATALOG_DOWNLOADER_H__
+#define __GPS_DATALOG_DOWNLOADER_H__
+
+#include <stdint.h>
+#include "GPSProviderCommon.h"
+#include "GPSProvider.h"
+
+//
+// Downloads the datalog in batches filling a caller-provided buffer, instead
+// of one onLogQuery callback per entry.
+//
+// The log is pulled one buffer at a time: the next part is only requested
+// once the consumer took the whole buffer. A consumer that cannot keep up
+// returns less than it was given; the rest stays buffered, the download
+// pauses and delivery is retried at the next process(). Nothing is dropped.
+//
+// Backends holding the log on the host fill the buffer directly
+// (GPSProvider::logReqBulk()); otherwise each part is a logReqQuery() of
+// buffer size entries followed by logReqStatus(), whose answer closes it.
+//
+// The resume point (last delivered timestamp and how many entries of that
+// second were delivered) can be saved to continue after an interruption:
+//
+//      GPSDatalogDownloader download(gps);
+//      GPSProvider::LogQueryRespParams_t batch[256];
+//
+//      unsigned store(const GPSProvider::LogQueryRespParams_t *entries, unsigned count) {
+//          return count; /* entries consumed */
+//      }
+//      ...
+//      /* forward onLogStatus/onLogQuery to handleStatus()/handleQueryResp() */
+//      download.start(from, batch, 256, store);
+//      while (!download.isDone()) {
+//          gps.process();
+//          download.process();
+//      }
+//
+
+class GPSDatalogDownloader {
+public:
+    /** Where a download starts or resumes */
+    struct ResumePoint_t {
+        GPSProvider::Timestamp_t timestamp;  /**< first second to read */
+        unsigned                 skip;       /**< entries of that second already delivered */
+    };
+
+    /** Download counters */
+    struct DownloadStats_t {
+        uint32_t entries;       /**< entries delivered to the consumer */
+        uint32_t batches;       /**< consumer invocations */
+        uint32_t requests;      /**< parts requested to the backend */
+        uint32_t bulkRequests;  /**< parts read through logReqBulk() */
+        uint32_t stalls;        /**< deliveries the consumer did not fully take */
+    };
+
+    /**
+     * Consumer of a batch.
+     *
+     * @return the number of entries consumed (from the first one); less than
+     *     count pauses the download.
+     */
+    typedef unsigned (* LogBatchCallback_t)(const GPSProvider::LogQueryRespParams_t *entries, unsigned count);
+
+    explicit GPSDatalogDownloader(GPSProvider &gps);
+
+    /**
+     * Start downloading the entries from the resume point on.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_LOG_REQ_QUERY.
+     */
+    gps_provider_error_t start(const ResumePoint_t &from, GPSProvider::LogQueryRespParams_t *buffer,
+                               unsigned capacity, LogBatchCallback_t callback);
+
+    /**
+     * Stop the download; getResumePoint() tells where to resume. A part
+     * still in flight is discarded as its responses arrive.
+     */
+    void cancel(void);
+
+    /**
+     * To be called from the GPSProvider log status callback.
+     */
+    void handleStatus(const GPSProvider::LogStatusParams_t *params);
+
+    /**
+     * To be called from the GPSProvider log query callback.
+     */
+    void handleQueryResp(const GPSProvider::LogQueryRespParams_t *params);
+
+    /**
+     * Deliver buffered entries and request the next part when the buffer
+     * was taken.
+     */
+    void process(void);
+
+    /**
+     * @return true once every entry up to the end of the log was delivered.
+     */
+    bool isDone(void) const {
+        return _done;
+    }
+
+    bool isActive(void) const {
+        return _active;
+    }
+
+    const ResumePoint_t &getResumePoint(void) const {
+        return _resume;
+    }
+
+    void getStats(DownloadStats_t &stats) const {
+        stats = _stats;
+    }
+
+private:
+    void deliver(void);
+    void request(void);
+
+    GPSProvider                       &_gps;
+    GPSProvider::LogQueryRespParams_t *_buffer;
+    unsigned                          _capacity;
+    unsigned                          _head;       /* first entry not consumed */
+    unsigned                          _filled;
+    LogBatchCallback_t                _callback;
+
+    bool                              _active;
+    bool                              _done;
+    bool                              _pending;    /* query part in flight */
+    bool                              _last;       /* the part in the buffer ends the log */
+    bool                              _bulk;       /* backend supports logReqBulk() */
+    unsigned                          _skip;       /* responses to drop in the part in flight */
+    unsigned                          _abandoned;  /* cancelled parts still to be closed */
+    ResumePoint_t                     _resume;
+    DownloadStats_t                   _stats;
+
+    /* disallow copy constructor and assignment operators */
+    GPSDatalogDownloader(const GPSDatalogDownloader&);
+    GPSDatalogDownloader & operator= (const GPSDatalogDownloader&);
+};
+
+#endif /* __GPS_DATALOG_DOWNLOADER_H__ */
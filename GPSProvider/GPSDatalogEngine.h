@@ -0,0 +1,299 @@
+/**
+ ******************************************************************************
+ * @file    GPSDatalogEngine.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Host-side datalogging on a circular file store.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_DATALOG_ENGINE_H__
+#define __GPS_DATALOG_ENGINE_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include "GPSProviderCommon.h"
+#include "GPSProvider.h"
+#include "GPSLocalFrame.h"
+#include "GPSDatalog.h"
+
+//
+// Software datalogging for hosts with a file system, applying the GPSDatalog
+// criteria of the receiver-side logger:
+//
+//  - minRate:      seconds between two records;
+//  - minSpeed:     speed over ground (km/h) below which fixes are skipped;
+//  - minPosition:  distance (m) from the previous record below which fixes
+//                  are skipped;
+//  - logMask:      stored in every record and reported back by queries;
+//  - circular:     once full, the oldest records are overwritten, otherwise
+//                  new fixes are dropped;
+//  - buffer-full alarm: onLogStatus is raised when the store fills up.
+//
+//      GPSDatalogEngine log;
+//      log.open("track.log", 100000);
+//      log.configDatalog(&datalog);
+//      log.startDatalog();
+//      ...
+//      /* from the location callback */
+//      log.logFix(*newLocation, speedMps);
+//
+// The store is a file preallocated at open(): one header page followed by
+// fixed-size 32 byte records used as a ring. Records are accumulated in a
+// page buffer and only the dirty range of the page is written, when the page
+// is complete or on flush(); the header (ring position) is rewritten at the
+// same time. Every record carries a sequence number and a CRC, so records
+// written after the last header update are recovered by open().
+//
+
+class GPSDatalogEngine {
+public:
+    /** Size of a record in the store. */
+    static const unsigned RECORD_SIZE = 32;
+
+    /** Size of the header page and of the write buffer. */
+    static const unsigned PAGE_SIZE = 4096;
+
+    /** LogStatusParams_t::bufferStatus values */
+    enum BufferStatus_t {
+        BUFFER_STATUS_OK   = 0, /**< room left, or circular. */
+        BUFFER_STATUS_FULL = 1  /**< every entry used. */
+    };
+
+    /** A decoded record */
+    struct Record_t {
+        uint64_t utcTime;    /**< UTC time in millisecond */
+        uint32_t seq;        /**< sequence number, increasing by one */
+        double   lat;
+        double   lon;
+        float    altitude;   /**< meters */
+        float    speed;      /**< m/s */
+        uint8_t  fix;        /**< 1 if the fix was valid */
+        uint8_t  quality;    /**< satellites used */
+        uint8_t  logMask;
+        uint8_t  statusBitmap;
+    };
+
+    /** Store counters */
+    struct DatalogStats_t {
+        uint32_t fixes;        /**< fixes offered to logFix() while started */
+        uint32_t logged;       /**< records appended */
+        uint32_t filtered;     /**< fixes rejected by the GPSDatalog criteria */
+        uint32_t overwritten;  /**< oldest records replaced (circular) */
+        uint32_t dropped;      /**< fixes lost because the store was full */
+        uint32_t recovered;    /**< records found past the header by open() */
+        uint32_t dataWrites;   /**< record write operations */
+        uint32_t headerWrites; /**< header write operations */
+        uint64_t bytesWritten; /**< bytes written to the file, header included */
+    };
+
+    GPSDatalogEngine();
+    virtual ~GPSDatalogEngine();
+
+    /**
+     * Open the store at path, creating it with room for capacity records
+     * (an existing store keeps its own capacity and content).
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_DATALOG_CFG on failure.
+     */
+    gps_provider_error_t open(const char *path, unsigned capacity);
+
+    /**
+     * Flush and close the store.
+     */
+    void close(void);
+
+    bool isOpen(void) const {
+        return _file != NULL;
+    }
+
+    /**
+     * Apply the criteria of datalog; logging stays stopped.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_DATALOG_CFG.
+     */
+    gps_provider_error_t configDatalog(const GPSDatalog *datalog);
+
+    gps_provider_error_t startDatalog(void);
+
+    /**
+     * Stop logging and flush the store.
+     */
+    gps_provider_error_t stopDatalog(void);
+
+    /**
+     * Drop every record.
+     */
+    gps_provider_error_t eraseDatalog(void);
+
+    /**
+     * Offer a fix to the logger.
+     *
+     * @param speed speed over ground, m/s.
+     * @return true if a record was appended.
+     */
+    bool logFix(const GPSProvider::LocationUpdateParams_t &location, double speed);
+
+    /**
+     * Same as logFix(location, speed), with location already converted by
+     * a shared frame (used by the minPosition criterion).
+     */
+    bool logFix(const GPSProvider::LocationUpdateParams_t &location, double speed,
+                const GPSLocalFrame::Point_t &point);
+
+    /**
+     * Write the buffered records and the header.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_DATALOG_STOP on I/O error.
+     */
+    gps_provider_error_t flush(void);
+
+    /**
+     * Publish the store state through the log status callback.
+     */
+    gps_provider_error_t logReqStatus(void);
+
+    /**
+     * Publish through the log query callback up to query.entries records,
+     * starting from the first one logged at or after query.startTimestamp.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_LOG_REQ_QUERY.
+     */
+    gps_provider_error_t logReqQuery(const GPSProvider::LogQueryParams_t &query);
+
+    /**
+     * Store up to count query responses, skipping the first skip records
+     * logged at or after query.startTimestamp; records are read in page
+     * sized blocks.
+     *
+     * @param  count in: room in entries; out: entries stored.
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_LOG_REQ_QUERY.
+     */
+    gps_provider_error_t logReqBulk(const GPSProvider::LogQueryParams_t &query, unsigned skip,
+                                    GPSProvider::LogQueryRespParams_t *entries, unsigned &count);
+
+    /**
+     * @return the position of the first record logged at or after utcMs
+     *     (binary search, records being in time order).
+     */
+    unsigned findRecord(uint64_t utcMs);
+
+    /**
+     * Read the record at position index, 0 being the oldest.
+     *
+     * @return false if index is out of range or the record is corrupted.
+     */
+    bool readRecord(unsigned index, Record_t &record);
+
+    /**
+     * Convert a record into a query response.
+     */
+    static void toQueryResp(const Record_t &record, GPSProvider::LogQueryRespParams_t &resp);
+
+    void onLogStatus(GPSProvider::LogStatusCallback_t callback) {
+        _statusCallback = callback;
+    }
+
+    void onLogQuery(GPSProvider::LogQueryCallback_t callback) {
+        _queryCallback = callback;
+    }
+
+    unsigned getUsedEntries(void) const {
+        return _count;
+    }
+
+    unsigned getCapacity(void) const {
+        return _capacity;
+    }
+
+    bool isStarted(void) const {
+        return _started;
+    }
+
+    void getStats(DatalogStats_t &stats) const {
+        stats = _stats;
+    }
+
+protected:
+    static const unsigned RECORDS_PER_PAGE = PAGE_SIZE / RECORD_SIZE;
+
+    static void encode(const Record_t &record, uint8_t *out);
+    static bool decode(const uint8_t *in, Record_t &record);
+
+    bool readHeader(void);
+    bool writeHeader(void);
+    bool create(unsigned capacity);
+    void recover(void);
+    bool flushPage(void);
+    bool readSlot(unsigned slot, Record_t &record);
+    bool accepts(const GPSProvider::LocationUpdateParams_t &location, double speed,
+                 const GPSLocalFrame::Point_t &point) const;
+    void append(const Record_t &record);
+    void publishStatus(void);
+
+    FILE                             *_file;
+    unsigned                         _capacity;
+    unsigned                         _first;      /* slot of the oldest record */
+    unsigned                         _count;
+    uint32_t                         _nextSeq;
+
+    bool                             _configured;
+    bool                             _started;
+    bool                             _circular;
+    bool                             _fullAlarm;
+    bool                             _fullReported;
+    unsigned                         _minRate;
+    unsigned                         _minSpeed;
+    unsigned                         _minPosition;
+    uint8_t                          _logMask;
+
+    bool                             _haveLast;
+    uint64_t                         _lastTime;
+    GPSLocalFrame::Point_t           _lastPoint;
+    GPSLocalFrame                    _frame;
+
+    uint8_t                          _page[PAGE_SIZE];
+    unsigned                         _pageIndex;  /* page of the ring held in _page */
+    unsigned                         _dirtyBegin; /* dirty slot range within the page */
+    unsigned                         _dirtyEnd;
+
+    GPSProvider::LogStatusCallback_t _statusCallback;
+    GPSProvider::LogQueryCallback_t  _queryCallback;
+    DatalogStats_t                   _stats;
+
+private:
+    /* disallow copy constructor and assignment operators */
+    GPSDatalogEngine(const GPSDatalogEngine&);
+    GPSDatalogEngine & operator= (const GPSDatalogEngine&);
+};
+
+#endif /* __GPS_DATALOG_ENGINE_H__ */
@@ -0,0 +1,207 @@
+/**
+ ******************************************************************************
+ * @file    GPSDatalogMirror.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Host-side mirror of the receiver datalog.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_DATALOG_MIRROR_H__
+#define __GPS_DATALOG_MIRROR_H__
+
+#include <stdint.h>
+#include "GPSProviderCommon.h"
+#include "GPSProvider.h"
+
+//
+// Keeps a copy of the receiver datalog on the host, so that logReqQuery()
+// is answered without a round trip over the serial link.
+//
+// Every log status message (LogStatusParams_t) is compared with the mirror:
+// entries the receiver overwrote are dropped, and the ones logged since the
+// last sync are fetched with a single logReqQuery() starting at the last
+// mirrored timestamp. Each request is followed by logReqStatus(), whose
+// answer marks the end of the query responses.
+//
+// Entries are kept in a ring; one timestamp out of INDEX_STRIDE is copied to
+// a sparse index, so locating startTimestamp is a binary search over the
+// index followed by a scan of at most INDEX_STRIDE entries.
+//
+// GPSProvider callbacks carry no context, so the application forwards them:
+//
+//      GPSDatalogMirror mirror(gps, 4096);
+//
+//      void onLogStatus(const GPSProvider::LogStatusParams_t *params) {
+//          mirror.handleStatus(params);
+//      }
+//      void onLogQuery(const GPSProvider::LogQueryRespParams_t *params) {
+//          mirror.handleQueryResp(params);
+//      }
+//      ...
+//      gps.onLogStatus(onLogStatus);
+//      gps.onLogQuery(onLogQuery);
+//      mirror.onLogQuery(handleLogEntry);
+//      mirror.sync();
+//      while (true) {
+//          gps.process();
+//          mirror.process();
+//      }
+//      ...
+//      mirror.logReqQuery(query); /* entries come through handleLogEntry */
+//
+
+class GPSDatalogMirror {
+public:
+    /** Entries between two sparse index points. */
+    static const unsigned INDEX_STRIDE = 32;
+
+    /** Mirror counters */
+    struct MirrorStats_t {
+        uint32_t entries;            /**< entries currently mirrored */
+        uint32_t syncRequests;       /**< queries sent to fetch new entries */
+        uint32_t fetchedEntries;     /**< entries received while syncing */
+        uint32_t droppedEntries;     /**< entries dropped (overwritten or erased on the receiver) */
+        uint32_t localQueries;       /**< logReqQuery() answered from the mirror */
+        uint32_t forwardedQueries;   /**< logReqQuery() passed to the receiver */
+        uint32_t localEntries;       /**< entries delivered from the mirror */
+    };
+
+    /**
+     * @param gps      the provider driving the receiver.
+     * @param capacity entries kept on the host.
+     */
+    GPSDatalogMirror(GPSProvider &gps, unsigned capacity);
+    virtual ~GPSDatalogMirror();
+
+    /**
+     * Ask the receiver for its log status; the mirror catches up from the
+     * answer.
+     *
+     * @return the logReqStatus() error.
+     */
+    gps_provider_error_t sync(void);
+
+    /**
+     * To be called from the GPSProvider log status callback.
+     */
+    void handleStatus(const GPSProvider::LogStatusParams_t *params);
+
+    /**
+     * To be called from the GPSProvider log query callback.
+     */
+    void handleQueryResp(const GPSProvider::LogQueryRespParams_t *params);
+
+    /**
+     * Send the fetch request a status message made necessary (after
+     * GPSProvider::process()).
+     */
+    void process(void);
+
+    /**
+     * Same contract as GPSProvider::logReqQuery(): answered from the mirror
+     * when it is in sync with the receiver, forwarded otherwise.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_LOG_REQ_QUERY.
+     */
+    gps_provider_error_t logReqQuery(const GPSProvider::LogQueryParams_t &query);
+
+    /**
+     * Setup the application log query callback.
+     */
+    void onLogQuery(GPSProvider::LogQueryCallback_t callback) {
+        _queryCallback = callback;
+    }
+
+    /**
+     * @return true if the mirror holds every entry the receiver reported.
+     */
+    bool isSynced(void) const {
+        return _synced && (_requestCount == 0);
+    }
+
+    void getStats(MirrorStats_t &stats) const;
+
+    /**
+     * Drop every entry.
+     */
+    void clear(void);
+
+protected:
+    enum RequestKind_t {
+        REQUEST_SYNC,
+        REQUEST_FORWARD
+    };
+
+    /* chip requests in flight, each closed by a log status message */
+    struct Request_t {
+        RequestKind_t kind;
+        unsigned      skip;     /* responses already mirrored (same second) */
+        unsigned      fetched;  /* entries appended */
+    };
+
+    static const unsigned MAX_REQUESTS = 4;
+
+    uint64_t timeAt(uint32_t position) const;
+    uint32_t lowerBound(uint64_t utcMs) const;
+    void append(const GPSProvider::LogQueryRespParams_t &entry, uint64_t utcMs);
+    void dropBefore(uint64_t utcMs);
+    bool pushRequest(RequestKind_t kind, unsigned skip);
+    void check(void);
+
+    GPSProvider                       &_gps;
+    unsigned                          _capacity;
+    GPSProvider::LogQueryRespParams_t *_entries;  /* ring, by absolute position */
+    uint64_t                          *_index;    /* time of positions multiple of INDEX_STRIDE */
+    unsigned                          _indexCapacity;
+    uint32_t                          _base;      /* absolute position of the oldest entry */
+    uint32_t                          _count;
+
+    Request_t                         _requests[MAX_REQUESTS];
+    unsigned                          _requestHead;
+    unsigned                          _requestCount;
+
+    bool                              _haveStatus;
+    bool                              _checkPending;
+    bool                              _synced;
+    GPSProvider::LogStatusParams_t    _status;     /* last receiver status */
+
+    GPSProvider::LogQueryCallback_t   _queryCallback;
+    MirrorStats_t                     _stats;
+
+private:
+    /* disallow copy constructor and assignment operators */
+    GPSDatalogMirror(const GPSDatalogMirror&);
+    GPSDatalogMirror & operator= (const GPSDatalogMirror&);
+};
+
+#endif /* __GPS_DATALOG_MIRROR_H__ */
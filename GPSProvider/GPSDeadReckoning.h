@@ -0,0 +1,206 @@
+/**
+ ******************************************************************************
+ * @file    GPSDeadReckoning.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Kalman position estimate between low-power fixes.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_DEAD_RECKONING_H__
+#define __GPS_DEAD_RECKONING_H__
+
+#include <stdint.h>
+#include "GPSProvider.h"
+#include "GPSLocalFrame.h"
+
+//
+// Position between fixes, for POWER_LOW where the receiver hibernates and
+// lpmGetImmediateLocation() costs a wake-up:
+//
+//      GPSDeadReckoning dr;
+//      dr.setErrorThreshold(25.0);
+//      dr.onFixRequest(wakeReceiver);      /* gps.lpmGetImmediateLocation() */
+//      ...
+//      /* from the location callback */
+//      dr.update(*newLocation);
+//      ...
+//      GPSDeadReckoning::Estimate_t where;
+//      if (dr.locate(now, where)) {
+//          ... where.lat, where.lon, within where.errorRadius meters ...
+//      }
+//
+// Constant-velocity Kalman filter on a local east/north plane, driven by
+// white acceleration noise. Both axes share the same model and the same
+// measurements, so they share one 2x2 covariance. The error bound grows
+// with the time since the last fix. locate() calls the fix-request callback
+// once it exceeds the threshold, and not again until a fix arrives.
+//
+// errorRadius is 2DRMS (about 95% of the positions).
+//
+
+class GPSDeadReckoning {
+public:
+    /** Fix-request callback: wake the receiver up for a fix. */
+    typedef void (* FixRequestCallback_t)(void);
+
+    /** A position estimate */
+    struct Estimate_t {
+        double   lat;            /**< degrees */
+        double   lon;            /**< degrees */
+        double   velocityEast;   /**< m/s */
+        double   velocityNorth;  /**< m/s */
+        double   errorRadius;    /**< meters, 2DRMS */
+        uint64_t utcTime;        /**< time of the estimate (ms) */
+        uint64_t fixUtcTime;     /**< time of the last fix used (ms) */
+    };
+
+    /** Estimator counters */
+    struct EstimatorStats_t {
+        uint32_t updates;        /**< fixes applied */
+        uint32_t invalid;        /**< invalid fixes */
+        uint32_t rejected;       /**< fixes failing the innovation gate */
+        uint32_t restarts;       /**< filter restarts (first fix, gap, jump) */
+        uint32_t queries;        /**< locate() calls answered */
+        uint32_t fixRequests;    /**< fix-request callbacks issued */
+    };
+
+    GPSDeadReckoning();
+    virtual ~GPSDeadReckoning() {}
+
+    /**
+     * @param sigma standard deviation (meters) of a fix on each axis.
+     */
+    void setMeasurementNoise(double sigma);
+
+    /**
+     * @param sigma standard deviation (m/s^2) of the acceleration the model
+     *     does not account for; higher values follow turns faster.
+     */
+    void setProcessNoise(double sigma);
+
+    /**
+     * @param meters error radius above which locate() asks for a fix.
+     */
+    void setErrorThreshold(double meters) {
+        _threshold = meters;
+    }
+
+    /**
+     * @param ms time between fixes above which the filter restarts from the
+     *     next fix (default 10 minutes).
+     */
+    void setMaxGap(uint32_t ms) {
+        _maxGap = ms;
+    }
+
+    void onFixRequest(FixRequestCallback_t callback) {
+        _fixRequestCallback = callback;
+    }
+
+    /**
+     * Apply a fix.
+     *
+     * @return false if the fix is invalid or rejected as an outlier.
+     */
+    bool update(const GPSProvider::LocationUpdateParams_t &location);
+
+    /**
+     * Same as update(location), with location already converted by a
+     * shared frame.
+     */
+    bool update(const GPSProvider::LocationUpdateParams_t &location, const GPSLocalFrame::Point_t &point);
+
+    /**
+     * Estimate the position at utcTime without touching the receiver.
+     *
+     * @return false before the first fix.
+     */
+    bool predict(uint64_t utcTime, Estimate_t &estimate) const;
+
+    /**
+     * predict(), then issue a fix request if the error radius exceeds the
+     * threshold (or there is no estimate yet) and none is pending.
+     *
+     * @return false before the first fix.
+     */
+    bool locate(uint64_t utcTime, Estimate_t &estimate);
+
+    bool hasEstimate(void) const {
+        return _initialized;
+    }
+
+    /**
+     * Forget the state; the next fix restarts the filter.
+     */
+    void reset(void) {
+        _initialized = false;
+        _requestPending = false;
+    }
+
+    void getStats(EstimatorStats_t &stats) const {
+        stats = _stats;
+    }
+
+private:
+    void restart(const GPSLocalFrame::Point_t &point, uint64_t utcTime);
+    void propagate(double dt, double p[3]) const;
+    void requestFix(void);
+
+    double                      _r;          /* measurement variance (m^2) */
+    double                      _q;          /* acceleration spectral density (m^2/s^3) */
+    double                      _threshold;
+    uint32_t                    _maxGap;
+
+    bool                        _initialized;
+    bool                        _requestPending;
+    unsigned                    _rejectRun;
+    uint64_t                    _time;       /* ms, of the last fix */
+
+    /* plane tangent at the reference; the state is kept near it */
+    double                      _refLat;
+    double                      _refLon;
+    double                      _refCos;
+
+    double                      _x[2];       /* east, north (m) */
+    double                      _v[2];       /* east, north (m/s) */
+    double                      _p[3];       /* covariance: pos-pos, pos-vel, vel-vel */
+
+    FixRequestCallback_t        _fixRequestCallback;
+    EstimatorStats_t            _stats;
+
+    /* disallow copy constructor and assignment operators */
+    GPSDeadReckoning(const GPSDeadReckoning&);
+    GPSDeadReckoning & operator= (const GPSDeadReckoning&);
+};
+
+#endif /* __GPS_DEAD_RECKONING_H__ */
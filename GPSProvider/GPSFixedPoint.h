@@ -0,0 +1,310 @@
+/**
+ ******************************************************************************
+ * @file    GPSFixedPoint.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Fixed-point location representation and integer kernels.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_FIXED_POINT_H__
+#define __GPS_FIXED_POINT_H__
+
+#include <stdint.h>
+#include <math.h>
+#include "GPSProvider.h"
+#include "GPSProviderUtils.h"
+
+//
+// Locations as int32 in 1e-7 degree (the resolution of the receiver and of
+// the datalog records) and integer distance kernels, for parts without an
+// FPU where every double operation is a soft-float call.
+//
+// GPSProvider keeps its double API; Location_t and toFixed()/toDouble() are
+// the adapter. Components doing per-fence math on every fix select their
+// internal representation at compile time:
+//
+//      -DGPS_LOCATION_FIXED_POINT
+//
+//  GPSCoord_t      radians (double) / 1e-7 degree (int32)
+//  GPSCosine_t     double / Q30 (int32)
+//  GPSDistance2_t  squared meters (double) / squared 1e-7 degree of a
+//                  great circle (int64)
+//
+// The same macro moves the per-fix distances between fixes to distanceMm():
+// GPSLocalFrame points then carry their fixed-point coordinates, and the
+// odometer step and the datalog minPosition filter are integer only. The
+// step needs an integer square root, 16 compare-and-subtract steps for any
+// step under ~93 km. That is cheap against a soft-float sqrt(), but slower
+// than a hardware one: on a host with an FPU the fixed-point step costs
+// several times the double one (kernel.odo_step.* in test/benchmark).
+//
+// In fixed point a fix costs two float to int conversions; the distance
+// test against each fence is then integer only: two subtractions, one
+// 32x32 multiply for the longitude scale and two squares. The cosines and
+// squared radii are computed once, when a fence is configured.
+//
+
+#if defined(GPS_LOCATION_FIXED_POINT)
+typedef int32_t GPSCoord_t;
+typedef int32_t GPSCosine_t;
+typedef int64_t GPSDistance2_t;
+#else
+typedef double  GPSCoord_t;
+typedef double  GPSCosine_t;
+typedef double  GPSDistance2_t;
+#endif
+
+class GPSFixedPoint {
+public:
+    /** Fixed-point units per degree. */
+    static const int32_t UNITS_PER_DEG = 10000000;
+
+    /** Length (m) of one unit along a great circle. */
+    static double metersPerUnit(void) {
+        return GPS_EARTH_RADIUS_M * GPS_DEG_TO_RAD / UNITS_PER_DEG;
+    }
+
+    /** A location in fixed point */
+    struct Location_t {
+        int32_t  lat;       /**< 1e-7 degree */
+        int32_t  lon;       /**< 1e-7 degree */
+        int32_t  altitude;  /**< cm */
+        bool     valid;
+        uint64_t utcTime;   /**< UTC time in millisecond */
+    };
+
+    static int32_t toUnits(double degrees) {
+        return (int32_t)floor(degrees * UNITS_PER_DEG + 0.5);
+    }
+
+    static double toDegrees(int32_t units) {
+        return units / (double)UNITS_PER_DEG;
+    }
+
+    static void toFixed(const GPSProvider::LocationUpdateParams_t &location, Location_t &fixed) {
+        fixed.lat = toUnits(location.lat);
+        fixed.lon = toUnits(location.lon);
+        fixed.altitude = (int32_t)floor(location.altitude * 100.0 + 0.5);
+        fixed.valid = location.valid;
+        fixed.utcTime = location.utcTime;
+    }
+
+    static void toDouble(const Location_t &fixed, GPSProvider::LocationUpdateParams_t &location) {
+        location.lat = toDegrees(fixed.lat);
+        location.lon = toDegrees(fixed.lon);
+        location.altitude = (GPSProvider::Altitude_t)(fixed.altitude / 100.0);
+        location.valid = fixed.valid;
+        location.utcTime = fixed.utcTime;
+    }
+
+    /**
+     * cos(latitude) in Q30; uses the FPU/soft-float, meant for configuration
+     * time.
+     */
+    static int32_t cosQ30(int32_t lat) {
+        return (int32_t)floor(cos(toDegrees(lat) * GPS_DEG_TO_RAD) * (double)(1L << 30) + 0.5);
+    }
+
+    /**
+     * Squared equirectangular distance, in squared units, between (lat, lon)
+     * and (refLat, refLon), longitude scaled by cosLat (Q30).
+     */
+    static int64_t distance2(int32_t lat, int32_t lon, int32_t refLat, int32_t refLon, int32_t cosLat) {
+        int32_t dLat = lat - refLat;
+        int64_t dLon = (int64_t)lon - refLon;
+        if (dLon > 180 * (int64_t)UNITS_PER_DEG) {
+            dLon -= 360 * (int64_t)UNITS_PER_DEG;
+        } else if (dLon < -180 * (int64_t)UNITS_PER_DEG) {
+            dLon += 360 * (int64_t)UNITS_PER_DEG;
+        }
+        int64_t x = ((int64_t)(int32_t)dLon * cosLat) >> 30;
+        return (int64_t)dLat * dLat + x * x;
+    }
+
+    /**
+     * Double counterpart of distance2(): squared equirectangular distance
+     * (m^2) between positions in radians, longitude scaled by cosLat.
+     */
+    static double distance2Rad(double lat, double lon, double refLat, double refLon, double cosLat) {
+        double dLat = lat - refLat;
+        double dLon = lon - refLon;
+        if (dLon > GPS_PI) {
+            dLon -= 2.0 * GPS_PI;
+        } else if (dLon < -GPS_PI) {
+            dLon += 2.0 * GPS_PI;
+        }
+        double x = dLon * cosLat;
+        return (dLat * dLat + x * x) * (GPS_EARTH_RADIUS_M * GPS_EARTH_RADIUS_M);
+    }
+
+    /**
+     * floor(sqrt(value)), bit by bit: no multiply nor divide (16 steps).
+     */
+    static uint32_t isqrt32(uint32_t value) {
+        uint32_t root = 0;
+        uint32_t bit = 1UL << 30;
+        while (bit > value) {
+            bit >>= 2;
+        }
+        while (bit != 0) {
+            if (value >= root + bit) {
+                value -= root + bit;
+                root = (root >> 1) + bit;
+            } else {
+                root >>= 1;
+            }
+            bit >>= 2;
+        }
+        return root;
+    }
+
+    /**
+     * floor(sqrt(value)); values of 2^32 and above take twice the steps of
+     * isqrt32(), on 64 bit operands.
+     */
+    static uint32_t isqrt64(uint64_t value) {
+        if (value <= 0xFFFFFFFFULL) {
+            return isqrt32((uint32_t)value);
+        }
+        uint64_t root = 0;
+        uint64_t bit = (uint64_t)1 << 62;
+        while (bit > value) {
+            bit >>= 2;
+        }
+        while (bit != 0) {
+            if (value >= root + bit) {
+                value -= root + bit;
+                root = (root >> 1) + bit;
+            } else {
+                root >>= 1;
+            }
+            bit >>= 2;
+        }
+        return (uint32_t)root;
+    }
+
+    /**
+     * Distance in millimeters between two fixed-point positions, e.g. an
+     * odometer step; cosLat (Q30) is taken at their mean latitude.
+     */
+    static uint32_t distanceMm(int32_t lat1, int32_t lon1, int32_t lat2, int32_t lon2, int32_t cosLat) {
+        /* 11.1195 mm per unit, in Q16 */
+        static const uint64_t MM_PER_UNIT_Q16 = 728728;
+        static const int64_t NEAR = 1L << 23;   /* ~93 km */
+        int64_t dLat = (int64_t)lat2 - lat1;
+        int64_t dLon = (int64_t)lon2 - lon1;
+        if (dLon > 180 * (int64_t)UNITS_PER_DEG) {
+            dLon -= 360 * (int64_t)UNITS_PER_DEG;
+        } else if (dLon < -180 * (int64_t)UNITS_PER_DEG) {
+            dLon += 360 * (int64_t)UNITS_PER_DEG;
+        }
+        if ((dLat < NEAR) && (dLat > -NEAR) && (dLon < NEAR) && (dLon > -NEAR)) {
+            /* short steps are computed in Q8. Past ~2.8 m their square no
+             * longer fits 32 bits: it is scaled down by 4^shift instead of
+             * going through the 64 bit root, the root keeping 16
+             * significant bits. Rounding it to nearest keeps the lost bits
+             * from biasing a sum of steps. */
+            int64_t x = (dLon * cosLat) >> 22;
+            int64_t y = dLat << 8;
+            uint64_t square = (uint64_t)(x * x + y * y);
+            unsigned shift = 0;
+            while (square > 0xFFFFFFFFULL) {
+                square >>= 2;
+                shift++;
+            }
+            uint32_t root = isqrt32((uint32_t)square);
+            if ((uint32_t)square - root * root > root) {
+                root++;
+            }
+            uint64_t unitsQ8 = (uint64_t)root << shift;
+            return (uint32_t)((unitsQ8 * MM_PER_UNIT_Q16 + 0x800000) >> 24);
+        }
+        uint64_t units = isqrt64((uint64_t)distance2(lat2, lon2, lat1, lon1, cosLat));
+        return (uint32_t)((units * MM_PER_UNIT_Q16 + 0x8000) >> 16);
+    }
+
+    /*
+     * Representation selected by GPS_LOCATION_FIXED_POINT
+     */
+
+    static GPSCoord_t toCoord(double degrees) {
+#if defined(GPS_LOCATION_FIXED_POINT)
+        return toUnits(degrees);
+#else
+        return degrees * GPS_DEG_TO_RAD;
+#endif
+    }
+
+    static GPSCosine_t toCosine(double degrees) {
+#if defined(GPS_LOCATION_FIXED_POINT)
+        return cosQ30(toUnits(degrees));
+#else
+        return cos(degrees * GPS_DEG_TO_RAD);
+#endif
+    }
+
+    /**
+     * Squared length of a radius given in meters; negative radii map to a
+     * negative value that no distance matches.
+     */
+    static GPSDistance2_t toDistance2(double meters) {
+#if defined(GPS_LOCATION_FIXED_POINT)
+        if (meters < 0.0) {
+            return -1;
+        }
+        double units = meters / metersPerUnit();
+        return (GPSDistance2_t)(units * units);
+#else
+        return (meters < 0.0) ? -1.0 : meters * meters;
+#endif
+    }
+
+    static double toMeters(GPSDistance2_t distance2) {
+#if defined(GPS_LOCATION_FIXED_POINT)
+        return sqrt((double)distance2) * metersPerUnit();
+#else
+        return sqrt(distance2);
+#endif
+    }
+
+    static GPSDistance2_t coordDistance2(GPSCoord_t lat, GPSCoord_t lon, GPSCoord_t refLat, GPSCoord_t refLon,
+                                         GPSCosine_t cosLat) {
+#if defined(GPS_LOCATION_FIXED_POINT)
+        return distance2(lat, lon, refLat, refLon, cosLat);
+#else
+        return distance2Rad(lat, lon, refLat, refLon, cosLat);
+#endif
+    }
+};
+
+#endif /* __GPS_FIXED_POINT_H__ */
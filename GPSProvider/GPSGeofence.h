@@ -43,6 +43,18 @@ public:
     
     static const int NEVER_EXPIRE = -1;
 
+    /** Transition types (setTransitionTypes() bitmask) */
+    static const int GEOFENCE_TRANSITION_ENTER = 1;
+    static const int GEOFENCE_TRANSITION_EXIT  = 2;
+    static const int GEOFENCE_TRANSITION_DWELL = 4;
+
+    /** Fence shapes; non-circular fences keep their bounding circle in GeofenceCircle_t */
+    enum GeofenceShape_t {
+      SHAPE_CIRCLE,
+      SHAPE_POLYGON,
+      SHAPE_CORRIDOR
+    };
+
     struct GeofenceCircle_t {
       int id;
       bool enabled;
@@ -59,7 +71,8 @@ public:
     GPSGeofence() :
         _expirationDuration(-1),
         _notificationResponsiveness(0),
-        _transitionTypes(0) {
+        _transitionTypes(0),
+        _loiteringDelay(0) {
     }
     
     /** 
@@ -69,7 +82,11 @@ public:
         _geofenceCircle(geofenceCircle),
         _expirationDuration(-1),
         _notificationResponsiveness(0),
-        _transitionTypes(0) {
+        _transitionTypes(0),
+        _loiteringDelay(0) {
+    }
+
+    virtual ~GPSGeofence() {
     }
     
     void setGeofenceCircle(const GeofenceCircle_t &geofenceCircle) {
@@ -90,6 +107,31 @@ public:
       return _geofenceCircle;
     }
     
+    virtual GeofenceShape_t getShape(void) const {
+      return SHAPE_CIRCLE;
+    }
+
+    /**
+     * Exact status of a point (degrees) found within the bounding circle.
+     * Circles need no refinement: the current status is returned.
+     */
+    virtual int evaluateStatus(GPSProvider::LocationType_t lat, GPSProvider::LocationType_t lon) const {
+      (void)lat;
+      (void)lon;
+      return _geofenceCircle.status;
+    }
+
+    /**
+     * Distance (meters) from a point within the bounding circle to the
+     * nearest place where evaluateStatus() changes; negative if unknown.
+     * Circles are handled by their owner from GeofenceCircle_t.
+     */
+    virtual double boundaryDistance(GPSProvider::LocationType_t lat, GPSProvider::LocationType_t lon) const {
+      (void)lat;
+      (void)lon;
+      return -1.0;
+    }
+
     virtual void setExpirationDuration (long durationMillis) {
       _expirationDuration = durationMillis;
     }
@@ -102,11 +144,35 @@ public:
         _transitionTypes = transitionTypes;
     }
 
+    /**
+     * Time the device must stay inside before GEOFENCE_TRANSITION_DWELL.
+     */
+    virtual void setLoiteringDelay(int loiteringDelayMs) {
+        _loiteringDelay = loiteringDelayMs;
+    }
+
+    long getExpirationDuration(void) const {
+      return _expirationDuration;
+    }
+
+    int getNotificationResponsiveness(void) const {
+      return _notificationResponsiveness;
+    }
+
+    int getTransitionTypes(void) const {
+      return _transitionTypes;
+    }
+
+    int getLoiteringDelay(void) const {
+      return _loiteringDelay;
+    }
+
 protected:
     GeofenceCircle_t            _geofenceCircle;
     long                        _expirationDuration;
     int                         _notificationResponsiveness;
     int                         _transitionTypes;
+    int                         _loiteringDelay;
 
 private:
     /* disallow copy constructor and assignment operators */
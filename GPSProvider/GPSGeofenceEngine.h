@@ -0,0 +1,235 @@
+/**
+ ******************************************************************************
+ * @file    GPSGeofenceEngine.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Host-side evaluation of large circular geofence sets.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+#ifndef __GPS_GEOFENCE_ENGINE_H__
+#define __GPS_GEOFENCE_ENGINE_H__
+
+#include <stdint.h>
+#include "GPSProviderCommon.h"
+#include "GPSProvider.h"
+#include "GPSGeofence.h"
+#include "GPSFixedPoint.h"
+
+class GPSGeofenceIndex; /* forward declaration */
+
+//
+// Software geofencing for fence sets well beyond what the receiver supports.
+// Circles are kept in a structure-of-arrays layout with everything the test
+// needs precomputed (radians, cos(lat), squared inner/outer radii in meters),
+// so that checking a fix against the whole set is a straight SIMD loop
+// (SSE2/AVX on x86, NEON on AArch64, plain C elsewhere):
+//
+//      GPSGeofenceEngine engine;
+//      engine.configGeofences(fences, count);
+//      engine.onGeofenceStatusMessage(handleGeofenceStatus);
+//      ...
+//      /* from the location callback */
+//      engine.evaluate(*newLocation);
+//
+// For very large sets, setIndex() attaches a GPSGeofenceIndex: a fix is then
+// only tested against the fences of its grid cell, plus those it was inside
+// of (or near) at the previous fix.
+//
+// Polygon and corridor fences (GPSGeofenceShapes.h) go through the same
+// kernel using their bounding circle; only those the fix falls near are then
+// refined with GPSGeofence::evaluateStatus().
+//
+// Distances use the equirectangular approximation around each fence center;
+// the error stays well under the fence tolerance for radii up to tens of km.
+// With GPS_LOCATION_FIXED_POINT the fence columns and the kernel are integer
+// (GPSFixedPoint.h), for targets without an FPU.
+// GeofenceCircle_t::tolerance (meters) defines the width of the boundary
+// band reported as GEOFENCE_STATUS_BOUNDARY_CIRCLE.
+//
+
+class GPSGeofenceEngine {
+public:
+    GPSGeofenceEngine();
+    virtual ~GPSGeofenceEngine();
+
+    /**
+     * Preallocate room for capacity fences.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_NO_MEM on failure.
+     */
+    gps_provider_error_t reserve(unsigned capacity);
+
+    /**
+     * Replace the fence set. The GPSGeofence objects must outlive the engine
+     * configuration; their status is updated as transitions are detected.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_NO_MEM on failure (the
+     *     previous set and its index are kept).
+     */
+    gps_provider_error_t configGeofences(GPSGeofence *geofences[], unsigned geofenceCount);
+
+    /**
+     * Append a fence to the set; its status is reported at the next fix.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_NO_MEM on failure.
+     */
+    gps_provider_error_t addGeofence(GPSGeofence *geofence);
+
+    /**
+     * Reload the fence with the same GeofenceCircle_t::id after its circle
+     * was changed; a transition is reported at the next fix if any.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_GEOFENCE_CFG if unknown /
+     *     GPS_ERROR_NO_MEM (the previous circle is kept).
+     */
+    gps_provider_error_t updateGeofence(GPSGeofence *geofence);
+
+    /**
+     * Remove the fence with the given GeofenceCircle_t::id. The last fence
+     * takes its place in getStatus().
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_GEOFENCE_CFG if unknown.
+     */
+    gps_provider_error_t removeGeofence(int id);
+
+    /**
+     * Look candidates up in index instead of scanning every fence; the index
+     * is (re)built from the current set and kept up to date afterwards.
+     * NULL goes back to the linear scan.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_NO_MEM on failure (the
+     *     engine then stays on the linear scan).
+     */
+    gps_provider_error_t setIndex(GPSGeofenceIndex *index);
+
+    /**
+     * Test a fix against every fence and publish the transitions through
+     * the geofence status callback, once per fence whose status changed.
+     * Fences found OUTSIDE for the first time are not transitions: they
+     * are published together by a single callback with idAlarm -1.
+     *
+     * @return the number of transitions published.
+     */
+    unsigned evaluate(const GPSProvider::LocationUpdateParams_t &location);
+
+    /**
+     * Distance (meters) from a point (degrees) to the nearest place where
+     * the status of an enabled fence changes: the fix must move at least
+     * that far before evaluate() can report a transition.
+     *
+     * @return the distance, HUGE_VAL without enabled fences.
+     */
+    double getBoundaryDistance(GPSProvider::LocationType_t lat, GPSProvider::LocationType_t lon) const;
+
+    /**
+     * Publish the current status of the fence set (idAlarm is -1).
+     */
+    void reportStatus(void);
+
+    /**
+     * Setup the geofenceStatus callback.
+     */
+    void onGeofenceStatusMessage(GPSProvider::GeofenceStatusMessageCallback_t callback) {
+        _statusCallback = callback;
+    }
+
+    unsigned getGeofenceCount(void) const {
+        return _count;
+    }
+
+    /**
+     * @return GEOFENCE_STATUS_* of every fence, in configuration order.
+     */
+    const int *getStatus(void) const {
+        return _statusInt;
+    }
+
+    /**
+     * @return the number of fence tests performed since construction; with
+     *     an index this grows with the fence density, not the set size.
+     */
+    uint64_t getEvaluatedFences(void) const {
+        return _evaluated;
+    }
+
+protected:
+    /** Lanes processed per kernel iteration; arrays are padded to it. */
+    static const unsigned LANES = 4;
+
+    void setSlot(unsigned slot, GPSGeofence *geofence);
+    void clearSlot(unsigned slot);
+    void moveSlot(unsigned from, unsigned to);
+    unsigned findSlot(int id) const;
+    bool isActive(unsigned slot) const;
+    void rebuildActive(void);
+    gps_provider_error_t indexSlot(unsigned slot);
+    gps_provider_error_t indexFence(unsigned slot, GPSGeofence *geofence);
+    gps_provider_error_t rebuildIndex(void);
+    unsigned evaluateIndexed(const GPSProvider::LocationUpdateParams_t &location);
+    bool applyStatus(unsigned slot, uint8_t status);
+    void publish(int idAlarm, uint64_t utcTime);
+
+    GPSGeofence                                  **_fences;
+    int                                          *_ids;
+    int                                          *_statusInt;
+    GPSCoord_t                                   *_lat;
+    GPSCoord_t                                   *_lon;
+    GPSCosine_t                                  *_cosLat;
+    GPSDistance2_t                               *_inner2;    /* (radius - tolerance)^2 */
+    GPSDistance2_t                               *_outer2;    /* (radius + tolerance)^2 */
+    uint8_t                                      *_base;      /* 1 if enabled, 0 otherwise */
+    uint8_t                                      *_status;    /* current GEOFENCE_STATUS_* */
+    uint8_t                                      *_newStatus; /* kernel output */
+    uint8_t                                      *_shaped;    /* 1 for polygon/corridor fences */
+    uint32_t                                     *_mark;      /* epoch of the last test */
+    uint32_t                                     *_active;    /* inside/boundary/pending slots */
+    uint32_t                                     *_nextActive;
+
+    void                                         *_storage;
+    unsigned                                     _capacity;
+    unsigned                                     _count;
+    uint64_t                                     _evaluated;
+    unsigned                                     _shapedCount;
+
+    GPSGeofenceIndex                             *_index;
+    unsigned                                     _activeCount;
+    uint32_t                                     _epoch;
+
+    GPSProvider::GeofenceStatusMessageCallback_t _statusCallback;
+
+private:
+    /* disallow copy constructor and assignment operators */
+    GPSGeofenceEngine(const GPSGeofenceEngine&);
+    GPSGeofenceEngine & operator= (const GPSGeofenceEngine&);
+};
+
+#endif /* __GPS_GEOFENCE_ENGINE_H__ */
@@ -0,0 +1,179 @@
+/**
+ ******************************************************************************
+ * @file    GPSGeofenceIndex.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Uniform grid index over circular geofences.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_GEOFENCE_INDEX_H__
+#define __GPS_GEOFENCE_INDEX_H__
+
+#include <stdint.h>
+#include "GPSProviderCommon.h"
+
+//
+// Uniform lat/lon grid mapping each cell to the fences whose bounding box
+// overlaps it, so a fix only needs to be tested against the fences listed
+// in its own cell:
+//
+//      GPSGeofenceIndex index(1000.0);       // ~1 km cells
+//      index.insert(slot, lat, lon, radius);
+//      ...
+//      unsigned n;
+//      const uint32_t *candidates = index.query(fixLat, fixLon, n);
+//
+// Fences are identified by the caller's slot number. Cells live in an open
+// addressing hash table, so memory follows the populated area rather than
+// the whole globe. Fences covering more than MAX_CELLS_PER_FENCE cells (or
+// reaching a pole) are kept on a side list returned by every query.
+//
+// The bounding box matches the equirectangular test of GPSGeofenceEngine:
+// longitudes are scaled by cos() of the fence latitude.
+//
+
+class GPSGeofenceIndex {
+public:
+    static const uint32_t NONE = 0xFFFFFFFFUL;
+    static const unsigned MAX_CELLS_PER_FENCE = 64;
+
+    /** Index counters */
+    struct IndexStats_t {
+        uint32_t fences;       /**< fences indexed */
+        uint32_t cells;        /**< cells ever populated */
+        uint32_t entries;      /**< cell/fence pairs */
+        uint32_t oversize;     /**< fences on the side list */
+        uint64_t queries;      /**< query() calls */
+        uint64_t candidates;   /**< slots returned by query() */
+    };
+
+    /**
+     * @param cellSize grid pitch in meters (along a meridian).
+     */
+    explicit GPSGeofenceIndex(double cellSize = 1000.0);
+    virtual ~GPSGeofenceIndex();
+
+    /**
+     * Index the circle centered on lat/lon (degrees) of the given radius
+     * (meters) under slot. The slot must not be indexed already.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_NO_MEM on failure.
+     */
+    gps_provider_error_t insert(uint32_t slot, double lat, double lon, double radius);
+
+    /**
+     * Drop every entry of slot.
+     */
+    void remove(uint32_t slot);
+
+    /**
+     * Renumber the (indexed) fence at slot from as to; to must be free.
+     */
+    void move(uint32_t from, uint32_t to);
+
+    /**
+     * Drop every fence; the memory is kept for reuse.
+     */
+    void clear(void);
+
+    /**
+     * @return the slots whose bounding box contains lat/lon (degrees); the
+     *     array stays valid until the next call on the index.
+     */
+    const uint32_t *query(double lat, double lon, unsigned &count);
+
+    /**
+     * Fill stats with a snapshot of the counters.
+     */
+    void getStats(IndexStats_t &stats) const;
+
+protected:
+    struct Entry_t {
+        uint32_t slot;
+        uint32_t bucket;
+        uint32_t cellNext;
+        uint32_t cellPrev;
+        uint32_t fenceNext;
+    };
+
+    struct Bucket_t {
+        uint64_t key;      /* 0: empty */
+        uint32_t head;
+    };
+
+    uint64_t cellKey(int64_t row, int64_t col) const;
+    int64_t  rowOf(double lat) const;
+    int64_t  colOf(double lon) const;
+    uint32_t findBucket(uint64_t key, bool create);
+    uint32_t allocEntry(void);
+    bool     growBuckets(void);
+    bool     growSlots(uint32_t slot);
+    bool     growCandidates(unsigned count);
+
+    double                      _cellDeg;
+    int64_t                     _rows;
+    int64_t                     _cols;
+
+    Bucket_t                    *_buckets;
+    uint32_t                    _bucketMask;
+    uint32_t                    _bucketsUsed;
+
+    Entry_t                     *_entries;
+    uint32_t                    _entryCapacity;
+    uint32_t                    _entryCount;   /* live entries */
+    uint32_t                    _entryTop;     /* entries ever handed out */
+    uint32_t                    _freeEntry;
+
+    uint32_t                    *_fenceHead;    /* per slot: first entry, NONE */
+    uint32_t                    *_oversizePos;  /* per slot: side list index, NONE */
+    uint8_t                     *_indexed;
+    uint32_t                    _slotCapacity;
+
+    uint32_t                    *_oversize;
+    uint32_t                    _oversizeCount;
+    uint32_t                    _oversizeCapacity;
+
+    uint32_t                    *_candidates;
+    unsigned                    _candidateCapacity;
+
+    uint32_t                    _fenceCount;
+    uint64_t                    _queries;
+    uint64_t                    _candidatesReturned;
+
+private:
+    /* disallow copy constructor and assignment operators */
+    GPSGeofenceIndex(const GPSGeofenceIndex&);
+    GPSGeofenceIndex & operator= (const GPSGeofenceIndex&);
+};
+
+#endif /* __GPS_GEOFENCE_INDEX_H__ */
@@ -0,0 +1,178 @@
+/**
+ ******************************************************************************
+ * @file    GPSGeofenceScheduler.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Expiration, dwell and notification timing of geofence transitions.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_GEOFENCE_SCHEDULER_H__
+#define __GPS_GEOFENCE_SCHEDULER_H__
+
+#include <stdint.h>
+#include "GPSProviderCommon.h"
+#include "GPSProvider.h"
+#include "GPSGeofence.h"
+#include "GPSTimerWheel.h"
+
+//
+// Applies the timing attributes of GPSGeofence on top of raw geofence status
+// messages, with every deadline kept in a GPSTimerWheel:
+//
+//  - expirationDuration: the fence is dropped (and removed from the provider)
+//    once it elapses; an EXPIRED transition is reported.
+//  - debounce (setDebounce()): a status must hold that long before it is
+//    accepted, so a fix jittering across the boundary does not flap.
+//  - loiteringDelay: GEOFENCE_TRANSITION_DWELL after staying inside.
+//  - notificationResponsiveness: at most one notification per period and
+//    fence; transitions in between are coalesced into the latest one.
+//  - transitionTypes: ENTER/EXIT/DWELL mask (0 reports all of them).
+//
+//      GPSGeofenceScheduler scheduler(&gps);
+//      scheduler.onTransition(handleTransition);
+//      scheduler.configGeofences(fences, count, nowMs);
+//
+//      void onStatus(const GPSProvider::GeofenceStatusParams_t *params, int ret) {
+//          scheduler.handleStatus(params, ret);
+//      }
+//      ...
+//      while (true) {
+//          gps.process();
+//          scheduler.process(nowMs);
+//      }
+//
+
+class GPSGeofenceScheduler {
+public:
+    /** Reported when a fence expires (not subject to transitionTypes). */
+    static const int GEOFENCE_TRANSITION_EXPIRED = 0x100;
+
+    struct TransitionParams_t {
+      int id;          /**< GeofenceCircle_t::id */
+      int transition;  /**< GEOFENCE_TRANSITION_* */
+      int status;      /**< accepted GEOFENCE_STATUS_* */
+      uint64_t timeMs; /**< scheduler time of the notification */
+    };
+
+    typedef void (* TransitionCallback_t)(const TransitionParams_t *params);
+
+    /**
+     * @param gps    provider to remove expired fences from (may be NULL).
+     * @param tickMs timer resolution.
+     */
+    explicit GPSGeofenceScheduler(GPSProvider *gps = NULL, uint32_t tickMs = 100);
+    virtual ~GPSGeofenceScheduler();
+
+    /**
+     * Track geofences, armed at nowMs.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_NO_MEM on failure.
+     */
+    gps_provider_error_t configGeofences(GPSGeofence *geofences[], unsigned geofenceCount, uint64_t nowMs);
+
+    /**
+     * Time a status must hold before it is accepted (0: immediately).
+     */
+    void setDebounce(uint32_t debounceMs) {
+        _debounceMs = debounceMs;
+    }
+
+    /**
+     * To be called from the GPSProvider geofence status callback.
+     */
+    void handleStatus(const GPSProvider::GeofenceStatusParams_t *params, int ret_code);
+
+    /**
+     * Run the timers due at nowMs (monotonic).
+     */
+    void process(uint64_t nowMs);
+
+    void onTransition(TransitionCallback_t callback) {
+        _transitionCallback = callback;
+    }
+
+    /**
+     * @return the number of timers currently armed.
+     */
+    unsigned getArmedTimers(void) const {
+        return _wheel.getArmedCount();
+    }
+
+protected:
+    struct Fence_t {
+        GPSGeofenceScheduler    *owner;
+        GPSGeofence             *geofence;
+        int                     id;
+        int                     accepted;   /* GEOFENCE_STATUS_* after debounce */
+        int                     pending;    /* GEOFENCE_STATUS_* waiting for debounce */
+        int                     queued;     /* transition waiting for the notification slot */
+        int                     delivered;  /* last transition notified */
+        unsigned                position;   /* index in the provider status, NOT_LOADED */
+        bool                    inside;
+        bool                    expired;
+        GPSTimerWheel::Timer_t  expiry;
+        GPSTimerWheel::Timer_t  debounce;
+        GPSTimerWheel::Timer_t  dwell;
+        GPSTimerWheel::Timer_t  notify;
+    };
+
+    static const unsigned NOT_LOADED = 0xFFFFFFFFU;
+
+    static void onExpiry(void *context);
+    static void onDebounce(void *context);
+    static void onDwell(void *context);
+    static void onNotify(void *context);
+    static int compareFences(const void *a, const void *b);
+
+    Fence_t *find(int id);
+    void raw(Fence_t &fence, int status);
+    void accept(Fence_t &fence, int status);
+    void notify(Fence_t &fence, int transition);
+    void deliver(Fence_t &fence, int transition);
+    void release(void);
+
+    GPSProvider                 *_gps;
+    GPSTimerWheel               _wheel;
+    Fence_t                     *_fences;    /* sorted by id */
+    unsigned                    _count;
+    unsigned                    _loaded;     /* fences still configured in the provider */
+    uint32_t                    _debounceMs;
+    TransitionCallback_t        _transitionCallback;
+
+private:
+    /* disallow copy constructor and assignment operators */
+    GPSGeofenceScheduler(const GPSGeofenceScheduler&);
+    GPSGeofenceScheduler & operator= (const GPSGeofenceScheduler&);
+};
+
+#endif /* __GPS_GEOFENCE_SCHEDULER_H__ */
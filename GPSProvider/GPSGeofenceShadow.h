@@ -0,0 +1,154 @@
+/**
+ ******************************************************************************
+ * @file    GPSGeofenceShadow.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Mirror of the geofences configured in the receiver.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_GEOFENCE_SHADOW_H__
+#define __GPS_GEOFENCE_SHADOW_H__
+
+#include <stdint.h>
+#include "GPSProviderCommon.h"
+#include "GPSProvider.h"
+#include "GPSGeofence.h"
+
+//
+// Copy of what the receiver was last told about each geofence, kept sorted
+// by id. Ports implementing the incremental geofence API diff each request
+// against it to find the one command (if any) to send, and account for the
+// traffic saved compared with re-sending the whole set:
+//
+//      GPSGeofenceShadow::Command_t cmd;
+//      gps_provider_error_t ret = _shadow.diffUpdate(geofence, cmd);
+//      if ((ret == GPS_ERROR_NONE) && (cmd != GPSGeofenceShadow::CMD_NONE)) {
+//          ... send cmd for geofence ...
+//      }
+//      _shadow.account(cmd);
+//
+// Traffic is estimated with the size of one NMEA-style configuration
+// sentence per fence (see commandBytes()).
+//
+
+class GPSGeofenceShadow {
+public:
+    enum Command_t {
+      CMD_NONE,      /**< already configured as requested */
+      CMD_ADD,       /**< configure a new fence */
+      CMD_SET,       /**< reconfigure the circle of a fence */
+      CMD_ENABLE,    /**< only the enabled flag changed */
+      CMD_DISABLE,
+      CMD_REMOVE
+    };
+
+    GPSGeofenceShadow();
+    virtual ~GPSGeofenceShadow();
+
+    /**
+     * Replace the mirror after a full configuration.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_NO_MEM on failure.
+     */
+    gps_provider_error_t reset(GPSGeofence *geofences[], unsigned geofenceCount);
+
+    /**
+     * Diff a request against the mirror and record it.
+     *
+     * @return GPS_ERROR_NONE / GPS_ERROR_GEOFENCE_CFG for an id already
+     *     configured (add) or unknown (update, remove) / GPS_ERROR_NO_MEM.
+     */
+    gps_provider_error_t diffAdd(GPSGeofence *geofence, Command_t &cmd);
+    gps_provider_error_t diffUpdate(GPSGeofence *geofence, Command_t &cmd);
+    gps_provider_error_t diffRemove(int id, Command_t &cmd);
+
+    /**
+     * Undo the last successful diffUpdate(), when the command it produced
+     * could not be applied.
+     */
+    void revertUpdate(void);
+
+    /**
+     * Exchange the mirrored set (not the counters) with other, e.g. to
+     * commit a set validated by a scratch shadow.
+     */
+    void swap(GPSGeofenceShadow &other);
+
+    /**
+     * Count cmd as sent (unless CMD_NONE), and what a full re-push of the
+     * current set would have cost instead.
+     */
+    void account(Command_t cmd);
+
+    /**
+     * @return the bytes of the configuration sentence describing circle.
+     */
+    static unsigned commandBytes(const GPSGeofence::GeofenceCircle_t &circle);
+
+    unsigned getCount(void) const {
+        return _count;
+    }
+
+    /**
+     * @return the configured fences, sorted by id.
+     */
+    GPSGeofence * const *getGeofences(void) const {
+        return _geofences;
+    }
+
+    void getStats(GPSProvider::GeofenceDeltaStats_t &stats) const {
+        stats = _stats;
+    }
+
+protected:
+    unsigned find(int id, bool &found) const;
+    bool grow(unsigned count);
+
+    GPSGeofence                          **_geofences;
+    GPSGeofence::GeofenceCircle_t        *_circles;    /* as last sent */
+    unsigned                             _count;
+    unsigned                             _capacity;
+    uint32_t                             _fullBytes;   /* cost of a full re-push */
+    unsigned                             _lastBytes;   /* cost of the last diffed command */
+    bool                                 _undoValid;   /* diffUpdate() state below can be restored */
+    GPSGeofence                          *_undoGeofence;
+    GPSGeofence::GeofenceCircle_t        _undoCircle;
+    GPSProvider::GeofenceDeltaStats_t    _stats;
+
+private:
+    /* disallow copy constructor and assignment operators */
+    GPSGeofenceShadow(const GPSGeofenceShadow&);
+    GPSGeofenceShadow & operator= (const GPSGeofenceShadow&);
+};
+
+#endif /* __GPS_GEOFENCE_SHADOW_H__ */
@@ -0,0 +1,164 @@
+/**
+ ******************************************************************************
+ * @file    GPSGeofenceShapes.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Polygon and corridor geofences.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_GEOFENCE_SHAPES_H__
+#define __GPS_GEOFENCE_SHAPES_H__
+
+#include "GPSProviderCommon.h"
+#include "GPSProvider.h"
+#include "GPSGeofence.h"
+
+//
+// Non-circular fences. Vertices are projected once onto a local plane
+// (meters, equirectangular around the bounding-box center) and every edge is
+// stored with what the point tests need, so evaluating a fix is a bounding-box
+// check followed by a single pass over the edge table.
+//
+// The GeofenceCircle_t of these fences is their bounding circle: anything
+// handling plain circles (the receiver, GPSGeofenceEngine, GPSGeofenceIndex)
+// can use it as a prefilter and call evaluateStatus() for the exact answer.
+//
+
+class GPSShapeGeofence : public GPSGeofence {
+public:
+    GPSShapeGeofence();
+    virtual ~GPSShapeGeofence();
+
+    unsigned getVertexCount(void) const {
+        return _vertexCount;
+    }
+
+protected:
+    struct Edge_t {
+        double x0;
+        double y0;
+        double dx;
+        double dy;
+        double invLen2;  /* 1 / (dx^2 + dy^2), 0 for a degenerate edge */
+        double xPerY;    /* dx / dy, 0 for a horizontal edge */
+    };
+
+    /**
+     * Project the vertices and build the edge table (closing the ring when
+     * closed is set); margin (meters) widens the bounding box and circle.
+     */
+    gps_provider_error_t buildEdges(int id, const GPSProvider::LocationType_t *lat,
+                                    const GPSProvider::LocationType_t *lon, unsigned count,
+                                    bool closed, double margin, int tolerance, bool enabled);
+
+    void project(GPSProvider::LocationType_t lat, GPSProvider::LocationType_t lon,
+                 double &x, double &y) const;
+    bool inBoundingBox(double x, double y) const;
+    double distance2(double x, double y) const;
+    bool contains(double x, double y) const;
+
+    Edge_t                      *_edges;
+    unsigned                    _edgeCount;
+    unsigned                    _vertexCount;
+    double                      _lat0;
+    double                      _lon0;
+    double                      _cosLat0;
+    double                      _minX;
+    double                      _maxX;
+    double                      _minY;
+    double                      _maxY;
+};
+
+/**
+ * Polygon fence: INSIDE/OUTSIDE by the even-odd rule, BOUNDARY within
+ * tolerance meters of an edge.
+ */
+class GPSPolygonGeofence : public GPSShapeGeofence {
+public:
+    GPSPolygonGeofence() {
+    }
+
+    /**
+     * Set the polygon vertices (degrees, either winding, not repeating the
+     * first vertex).
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_GEOFENCE_CFG with fewer
+     *     than 3 vertices / GPS_ERROR_NO_MEM.
+     */
+    gps_provider_error_t setPolygon(int id, const GPSProvider::LocationType_t *lat,
+                                    const GPSProvider::LocationType_t *lon, unsigned count,
+                                    int tolerance, bool enabled = true);
+
+    virtual GeofenceShape_t getShape(void) const {
+        return SHAPE_POLYGON;
+    }
+
+    virtual int evaluateStatus(GPSProvider::LocationType_t lat, GPSProvider::LocationType_t lon) const;
+
+    virtual double boundaryDistance(GPSProvider::LocationType_t lat, GPSProvider::LocationType_t lon) const;
+};
+
+/**
+ * Corridor fence: the points within halfWidth meters of a polyline
+ * (e.g. a highway section). BOUNDARY within tolerance meters of the edge of
+ * the corridor.
+ */
+class GPSCorridorGeofence : public GPSShapeGeofence {
+public:
+    GPSCorridorGeofence() :
+        _halfWidth(0.0) {
+    }
+
+    /**
+     * Set the polyline (degrees) and the corridor half width (meters).
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_GEOFENCE_CFG with fewer
+     *     than 2 vertices / GPS_ERROR_NO_MEM.
+     */
+    gps_provider_error_t setCorridor(int id, const GPSProvider::LocationType_t *lat,
+                                     const GPSProvider::LocationType_t *lon, unsigned count,
+                                     double halfWidth, int tolerance, bool enabled = true);
+
+    virtual GeofenceShape_t getShape(void) const {
+        return SHAPE_CORRIDOR;
+    }
+
+    virtual int evaluateStatus(GPSProvider::LocationType_t lat, GPSProvider::LocationType_t lon) const;
+
+    virtual double boundaryDistance(GPSProvider::LocationType_t lat, GPSProvider::LocationType_t lon) const;
+
+protected:
+    double                      _halfWidth;
+};
+
+#endif /* __GPS_GEOFENCE_SHAPES_H__ */
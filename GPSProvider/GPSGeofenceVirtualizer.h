@@ -0,0 +1,175 @@
+/**
+ ******************************************************************************
+ * @file    GPSGeofenceVirtualizer.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Keeps the receiver loaded with the geofences nearest to the device.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_GEOFENCE_VIRTUALIZER_H__
+#define __GPS_GEOFENCE_VIRTUALIZER_H__
+
+#include <stdint.h>
+#include "GPSProviderCommon.h"
+#include "GPSProvider.h"
+#include "GPSGeofence.h"
+#include "GPSLocalFrame.h"
+
+//
+// Geofence virtualization: the application hands the whole fence set to the
+// virtualizer, which keeps the receiver loaded with the (slots - 1) fences
+// nearest to the device plus one "recomputation" circle centered on the
+// device. The host is only woken by receiver geofence messages; when the
+// device leaves the recomputation circle the selection is redone and pushed.
+//
+// The recomputation radius is half the distance to the nearest fence left
+// out, so no fence can be entered before the selection is refreshed.
+//
+// GPSProvider callbacks carry no context, so the application forwards them:
+//
+//      GPSGeofenceVirtualizer virtualizer(gps, 8);
+//
+//      void onStatus(const GPSProvider::GeofenceStatusParams_t *params, int ret) {
+//          virtualizer.handleStatus(params, ret);
+//      }
+//      ...
+//      gps.onGeofenceStatusMessage(onStatus);
+//      virtualizer.onGeofenceStatusMessage(handleFenceTransition);
+//      virtualizer.configGeofences(fences, count);
+//      while (true) {
+//          gps.process();
+//          virtualizer.process();
+//      }
+//
+// The application callback sees the whole set: currentStatus has one entry
+// per configured fence, idAlarm is the id of the fence that changed. Fences
+// not loaded in the receiver are reported GEOFENCE_STATUS_OUTSIDE_CIRCLE.
+//
+
+class GPSGeofenceVirtualizer {
+public:
+    /** Id of the recomputation circle; must not be used by application fences. */
+    static const int RECOMPUTE_FENCE_ID = 0x7FFFFFFF;
+
+    /** Smallest recomputation radius (m). */
+    static const int MIN_RECOMPUTE_RADIUS = 10;
+
+    /** Virtualizer counters */
+    struct VirtualizerStats_t {
+        uint32_t fences;              /**< fences configured */
+        uint32_t loaded;              /**< fences currently in the receiver */
+        uint32_t recomputeRadius;     /**< current recomputation radius (m) */
+        uint32_t recomputations;      /**< selections computed */
+        uint32_t configTransactions;  /**< configGeofences() sent to the receiver */
+        uint32_t receiverMessages;    /**< geofence messages handled (host wakeups) */
+        uint32_t forwardedEvents;     /**< transitions passed to the application */
+        uint32_t suppressedEvents;    /**< reports of an already known status */
+    };
+
+    /**
+     * @param gps   the provider driving the receiver.
+     * @param slots number of geofences the receiver supports.
+     */
+    GPSGeofenceVirtualizer(GPSProvider &gps, unsigned slots);
+    virtual ~GPSGeofenceVirtualizer();
+
+    /**
+     * Set the full fence set; the receiver is loaded at the first fix (or
+     * right away if the set fits). On GPS_ERROR_NO_MEM the previous set
+     * is kept.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_NO_MEM / the receiver
+     *     configuration error.
+     */
+    gps_provider_error_t configGeofences(GPSGeofence *geofences[], unsigned geofenceCount);
+
+    /**
+     * Redo the selection around location and push it to the receiver.
+     */
+    gps_provider_error_t update(const GPSProvider::LocationUpdateParams_t &location);
+
+    /**
+     * To be called from the GPSProvider geofence status callback.
+     */
+    void handleStatus(const GPSProvider::GeofenceStatusParams_t *params, int ret_code);
+
+    /**
+     * Run a pending recomputation (thread mode, after GPSProvider::process()).
+     */
+    void process(void);
+
+    /**
+     * Setup the application geofenceStatus callback.
+     */
+    void onGeofenceStatusMessage(GPSProvider::GeofenceStatusMessageCallback_t callback) {
+        _statusCallback = callback;
+    }
+
+    /**
+     * Fill stats with a snapshot of the counters.
+     */
+    void getStats(VirtualizerStats_t &stats) const;
+
+protected:
+    void select(const GPSProvider::LocationUpdateParams_t *location);
+    gps_provider_error_t push(void);
+    void publish(const GPSProvider::Timestamp_t &timestamp, int idAlarm, int ret_code);
+    unsigned loadedIndexOf(int id) const;
+
+    GPSProvider                                  &_gps;
+    unsigned                                     _slots;
+
+    GPSGeofence                                  **_fences;
+    int                                          *_status;
+    double                                       *_edge;       /* distance to the fence band (m) */
+    uint32_t                                     *_order;
+    unsigned                                     _count;
+    GPSLocalFrame                                _frame;
+
+    GPSGeofence                                  **_loaded;
+    uint32_t                                     *_loadedIndex;
+    unsigned                                     _loadedCount; /* application fences only */
+    GPSGeofence                                  _recompute;
+    bool                                         _recomputeLoaded;
+    bool                                         _recomputePending;
+
+    GPSProvider::GeofenceStatusMessageCallback_t _statusCallback;
+    VirtualizerStats_t                           _stats;
+
+private:
+    /* disallow copy constructor and assignment operators */
+    GPSGeofenceVirtualizer(const GPSGeofenceVirtualizer&);
+    GPSGeofenceVirtualizer & operator= (const GPSGeofenceVirtualizer&);
+};
+
+#endif /* __GPS_GEOFENCE_VIRTUALIZER_H__ */
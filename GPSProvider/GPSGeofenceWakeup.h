@@ -0,0 +1,182 @@
+/**
+ ******************************************************************************
+ * @file    GPSGeofenceWakeup.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Time-to-boundary planning of geofence checks.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_GEOFENCE_WAKEUP_H__
+#define __GPS_GEOFENCE_WAKEUP_H__
+
+#include <stdint.h>
+#include "GPSProviderCommon.h"
+#include "GPSProvider.h"
+#include "GPSLocalFrame.h"
+
+class GPSGeofenceEngine; /* forward declaration */
+
+//
+// Plans when the next fix is needed to keep geofence reporting exact, instead
+// of polling lpmGetImmediateLocation() on a fixed period in POWER_LOW mode.
+//
+// At every check the distance to the nearest fence boundary D is taken from
+// the engine, and the time needed to cover it is bounded assuming the speed
+// grows by at most maxAccel:
+//
+//      v = (distance since last check) / dt + maxAccel * dt / 2
+//      v * t + maxAccel * t^2 / 2 = D - margin
+//
+// (the first term bounds the current speed given the average over the last
+// interval). No fence can change status before t elapses:
+//
+//      void onLocation(const GPSProvider::LocationUpdateParams_t *fix) {
+//          engine.evaluate(*fix);
+//          uint64_t deadline = wakeup.update(*fix);
+//          /* sleep until deadline, then lpmGetImmediateLocation() */
+//      }
+//
+
+class GPSGeofenceWakeup {
+public:
+    /** Planning counters */
+    struct WakeupStats_t {
+        uint32_t checks;       /**< fixes planned from */
+        uint32_t shortest;     /**< plans clamped to the minimum interval */
+        uint32_t longest;      /**< plans clamped to the maximum interval */
+        uint64_t spanMs;       /**< time between the first and the last check */
+    };
+
+    explicit GPSGeofenceWakeup(const GPSGeofenceEngine &engine);
+
+    /**
+     * Bounds of the planned delay (defaults: 1 s, 10 min).
+     */
+    void setIntervals(uint32_t minIntervalMs, uint32_t maxIntervalMs) {
+        _minIntervalMs = minIntervalMs;
+        _maxIntervalMs = (maxIntervalMs > minIntervalMs) ? maxIntervalMs : minIntervalMs;
+    }
+
+    /**
+     * Motion assumptions: maximum acceleration (m/s^2, default 2) and
+     * position error subtracted from the boundary distance (m, default 10).
+     */
+    void setMotionBounds(double maxAccel, double positionMargin) {
+        _maxAccel = (maxAccel > 0.0) ? maxAccel : 0.0;
+        _margin = (positionMargin > 0.0) ? positionMargin : 0.0;
+    }
+
+    /**
+     * Plan the next check from a fix the engine was just evaluated with.
+     *
+     * @return the UTC time (ms) of the next required check.
+     */
+    uint64_t update(const GPSProvider::LocationUpdateParams_t &location);
+
+    /**
+     * Same as update(location), with location already converted by a
+     * shared frame.
+     */
+    uint64_t update(const GPSProvider::LocationUpdateParams_t &location, const GPSLocalFrame::Point_t &point);
+
+    /**
+     * @return the UTC time (ms) of the next required check, 0 before the first fix.
+     */
+    uint64_t getNextCheckTime(void) const {
+        return _nextCheck;
+    }
+
+    /**
+     * @return true if a fix taken at utcMs must be checked.
+     */
+    bool isCheckDue(uint64_t utcMs) const {
+        return (_lastCheck == 0) || (utcMs >= _nextCheck);
+    }
+
+    /**
+     * @return the delay (ms) planned at the last update().
+     */
+    uint32_t getNextCheckDelay(void) const {
+        return _delayMs;
+    }
+
+    /**
+     * @return the speed bound (m/s) used at the last update().
+     */
+    double getSpeedBound(void) const {
+        return _speed;
+    }
+
+    /**
+     * @return the boundary distance (m) found at the last update().
+     */
+    double getBoundaryDistance(void) const {
+        return _distance;
+    }
+
+    /**
+     * @return the checks a fixed period would have needed over the span
+     *     covered so far; compare with WakeupStats_t::checks.
+     */
+    uint32_t getFixedPollingChecks(uint32_t periodMs) const;
+
+    void getStats(WakeupStats_t &stats) const;
+
+    /**
+     * Forget the motion history and counters.
+     */
+    void reset(void);
+
+private:
+    const GPSGeofenceEngine     &_engine;
+    uint32_t                    _minIntervalMs;
+    uint32_t                    _maxIntervalMs;
+    double                      _maxAccel;
+    double                      _margin;
+
+    GPSLocalFrame::Point_t      _lastPoint;
+    GPSLocalFrame               _frame;
+    uint64_t                    _lastCheck;
+    uint64_t                    _firstCheck;
+    uint64_t                    _nextCheck;
+    uint32_t                    _delayMs;
+    double                      _speed;
+    double                      _distance;
+    WakeupStats_t               _stats;
+
+    /* disallow copy constructor and assignment operators */
+    GPSGeofenceWakeup(const GPSGeofenceWakeup&);
+    GPSGeofenceWakeup & operator= (const GPSGeofenceWakeup&);
+};
+
+#endif /* __GPS_GEOFENCE_WAKEUP_H__ */
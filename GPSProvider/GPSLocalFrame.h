@@ -0,0 +1,178 @@
+/**
+ ******************************************************************************
+ * @file    GPSLocalFrame.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Local east-north frame shared by the per-fix distance math.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_LOCAL_FRAME_H__
+#define __GPS_LOCAL_FRAME_H__
+
+#include <stdint.h>
+#include "GPSProvider.h"
+#include "GPSFixedPoint.h"
+
+//
+// Local tangent-plane frame for the components measuring distances between
+// fixes (odometer, datalog filters, geofence planning). The frame keeps an
+// origin with its cos/sin latitude precomputed; a fix is converted once:
+//
+//      GPSLocalFrame frame;
+//      ...
+//      const GPSLocalFrame::Point_t &p = frame.update(*newLocation);
+//      odometer.update(*newLocation, p);
+//      datalog.logFix(*newLocation, speed, p);
+//
+// The cosine of the fix latitude is derived from the origin terms by a
+// short series, so a conversion needs no trigonometry. The origin moves to
+// the fix when it drifts beyond the re-anchor distance (10 km by default):
+// one cos() per re-anchoring, sin() following from it.
+//
+// east/north (meters) are equirectangular around the origin, at the mean
+// of the origin and point latitudes: good for planar geometry within the
+// re-anchor distance. distance() between two points scales longitude at
+// their own mean latitude instead, as the odometer and filters need.
+//
+
+class GPSLocalFrame {
+public:
+    /** A converted position */
+    struct Point_t {
+        double lat;     /**< degrees */
+        double lon;     /**< degrees */
+        double cosLat;
+        double east;    /**< meters from the origin */
+        double north;   /**< meters from the origin */
+#if defined(GPS_LOCATION_FIXED_POINT)
+        int32_t latUnits;   /**< 1e-7 degree */
+        int32_t lonUnits;   /**< 1e-7 degree */
+        int32_t cosQ30;
+#endif
+    };
+
+    /** Conversion counters */
+    struct FrameStats_t {
+        uint32_t fixes;      /**< update() calls */
+        uint32_t projected;  /**< project() calls */
+        uint32_t trigCalls;  /**< cos() evaluations */
+        uint32_t reanchors;  /**< origin moves */
+    };
+
+    GPSLocalFrame();
+    virtual ~GPSLocalFrame() {}
+
+    /**
+     * @param meters distance from the origin triggering a re-anchoring.
+     */
+    void setReanchorDistance(double meters);
+
+    /**
+     * Convert a fix, moving the origin if needed. The first fix becomes
+     * the origin.
+     *
+     * @return the converted fix, valid until the next update().
+     */
+    const Point_t &update(const GPSProvider::LocationUpdateParams_t &location);
+
+    /**
+     * Convert any position without moving the origin (e.g. a fence
+     * center); positions far from the origin cost one cos().
+     */
+    void project(double lat, double lon, Point_t &point);
+
+    /**
+     * @return the last fix converted by update().
+     */
+    const Point_t &getPoint(void) const {
+        return _point;
+    }
+
+    bool hasOrigin(void) const {
+        return _haveOrigin;
+    }
+
+    /**
+     * Forget the origin; the next fix becomes the new one.
+     */
+    void reset(void) {
+        _haveOrigin = false;
+    }
+
+    /**
+     * Distance (meters) between two converted points, equirectangular
+     * approximation at their mean latitude.
+     */
+    static double distance(const Point_t &a, const Point_t &b);
+
+    /**
+     * Distance (meters) from a converted point to a position (degrees),
+     * equirectangular approximation at the point latitude, as
+     * GPSProviderUtils::localDistance(point.lat, point.lon, lat, lon).
+     */
+    static double distanceTo(const Point_t &point, double lat, double lon);
+
+#if defined(GPS_LOCATION_FIXED_POINT)
+    /**
+     * Integer counterpart of distance(), in millimeters.
+     */
+    static uint32_t distanceMm(const Point_t &a, const Point_t &b) {
+        int32_t cosLat = (int32_t)(((int64_t)a.cosQ30 + b.cosQ30) / 2);
+        return GPSFixedPoint::distanceMm(a.latUnits, a.lonUnits, b.latUnits, b.lonUnits, cosLat);
+    }
+#endif
+
+    void getStats(FrameStats_t &stats) const {
+        stats = _stats;
+    }
+
+private:
+    void anchor(double lat, double lon);
+    void convert(double lat, double lon, Point_t &point);
+
+    bool                        _haveOrigin;
+    double                      _reanchor;
+    double                      _originLat;     /* degrees */
+    double                      _originLon;
+    double                      _originLatRad;
+    double                      _cos0;
+    double                      _sin0;
+    Point_t                     _point;
+    FrameStats_t                _stats;
+
+    /* disallow copy constructor and assignment operators */
+    GPSLocalFrame(const GPSLocalFrame&);
+    GPSLocalFrame & operator= (const GPSLocalFrame&);
+};
+
+#endif /* __GPS_LOCAL_FRAME_H__ */
@@ -0,0 +1,178 @@
+/**
+ ******************************************************************************
+ * @file    GPSLogBlock.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Compact columnar block format for logged fixes.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_LOG_BLOCK_H__
+#define __GPS_LOG_BLOCK_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "GPSProvider.h"
+
+//
+// Columnar block format for log entries: a LogQueryRespParams_t takes about
+// 80 bytes, an entry of a 1 Hz track about 10 bytes in a block.
+//
+// A block is a fixed 40 byte header followed by one column per field:
+//
+//      header  uint16 magic, uint16 entry count,
+//              uint64 first and last UTC time (ms),
+//              uint16 byte length of each of the 8 columns,
+//              uint32 block length (header included)
+//      TIME    delta of delta (ms), zig-zag varint
+//      LAT     delta (1e-7 degree), zig-zag varint
+//      LON     delta (1e-7 degree), zig-zag varint
+//      ALT     delta (cm), zig-zag varint
+//      SPEED   delta (cm/s), zig-zag varint
+//      ODO     delta (cm), zig-zag varint
+//      FLAGS   fix | geo << 3 | quality << 6, varint of value + 1,
+//              0 when unchanged
+//      STATUS  runs of (varint length, statusBitmap, logMask)
+//
+// Deltas wrap modulo 2^32 (2^64 for the 64 bit fields), so crossing the
+// antimeridian is lossless. fix and geo keep 3 bits each.
+//
+// The header carries the time span and length of the block, so a sequence
+// of blocks is searched by time without decoding them (findBlock()).
+//
+
+class GPSLogBlockEncoder {
+public:
+    /** Upper bound on the entries of a block (keeps column lengths in 16 bits). */
+    static const unsigned MAX_ENTRIES = 4096;
+
+    static const unsigned HEADER_SIZE = 40;
+
+    /**
+     * @param maxEntries entries per block (at most MAX_ENTRIES).
+     */
+    explicit GPSLogBlockEncoder(unsigned maxEntries = 256);
+    virtual ~GPSLogBlockEncoder();
+
+    /**
+     * Append an entry to the block being built.
+     *
+     * @return false if the block is full.
+     */
+    bool add(const GPSProvider::LogQueryRespParams_t &entry);
+
+    unsigned getCount(void) const {
+        return _count;
+    }
+
+    bool isFull(void) const {
+        return _count == _maxEntries;
+    }
+
+    /**
+     * @return room finish() needs for count entries.
+     */
+    static size_t getMaxBlockSize(unsigned count);
+
+    /**
+     * Write the block and start a new one.
+     *
+     * @return the block length, 0 if there are no entries or capacity is
+     *     below getMaxBlockSize(getCount()).
+     */
+    size_t finish(uint8_t *out, size_t capacity);
+
+    /**
+     * Drop the entries added so far.
+     */
+    void reset(void) {
+        _count = 0;
+    }
+
+private:
+    unsigned                    _maxEntries;
+    unsigned                    _count;
+    void                        *_storage;
+    uint64_t                    *_time;
+    int64_t                     *_odo;
+    int32_t                     *_lat;
+    int32_t                     *_lon;
+    int32_t                     *_alt;
+    int32_t                     *_speed;
+    uint32_t                    *_flags;
+    uint8_t                     *_status;
+    uint8_t                     *_mask;
+
+    /* disallow copy constructor and assignment operators */
+    GPSLogBlockEncoder(const GPSLogBlockEncoder&);
+    GPSLogBlockEncoder & operator= (const GPSLogBlockEncoder&);
+};
+
+class GPSLogBlockDecoder {
+public:
+    static const unsigned COLUMNS = 8;
+
+    /** Block header */
+    struct BlockHeader_t {
+        unsigned count;
+        uint64_t firstUtcMs;
+        uint64_t lastUtcMs;
+        uint16_t columnBytes[COLUMNS];
+        size_t   size;        /**< block length, header included */
+    };
+
+    /**
+     * Parse and check the header of the block at data.
+     *
+     * @return false if len bytes do not hold a valid block.
+     */
+    static bool readHeader(const uint8_t *data, size_t len, BlockHeader_t &header);
+
+    /**
+     * Decode the block at data into out.
+     *
+     * @return the number of entries decoded, 0 if the block is invalid or
+     *     holds more than maxEntries.
+     */
+    static unsigned decode(const uint8_t *data, size_t len,
+                           GPSProvider::LogQueryRespParams_t *out, unsigned maxEntries);
+
+    /**
+     * Walk the headers of consecutive blocks.
+     *
+     * @return the offset of the first block holding entries at or after
+     *     utcMs, len if there is none.
+     */
+    static size_t findBlock(const uint8_t *data, size_t len, uint64_t utcMs);
+};
+
+#endif /* __GPS_LOG_BLOCK_H__ */
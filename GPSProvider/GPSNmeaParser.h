@@ -0,0 +1,250 @@
+/**
+ ******************************************************************************
+ * @file    GPSNmeaParser.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Incremental, zero-copy NMEA sentence parser.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+#ifndef __GPS_NMEA_PARSER_H__
+#define __GPS_NMEA_PARSER_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "GPSProvider.h"
+
+//
+// Streaming NMEA parser meant to sit behind GPSProvider::process(). Bytes are
+// consumed straight from the receive buffer, one span at a time; fields are
+// converted while they are scanned, so no sentence is ever copied and a
+// sentence may be split across any number of parse() calls (e.g. across the
+// wrap point of a circular buffer).
+//
+//      size_t n;
+//      while (len > 0) {
+//          n = parser.parse(data, len);
+//          data += n;
+//          len -= n;
+//          if (parser.takeLocationUpdate()) {
+//              locationCallback(&parser.getLocation());
+//          }
+//      }
+//
+// parse() returns early as soon as a sentence completes a location update, so
+// that the caller can dispatch it before the following sentences are applied.
+//
+
+class GPSNmeaParser {
+public:
+    /** Parser counters */
+    struct ParserStats_t {
+        uint32_t sentences;        /**< sentences with a valid checksum */
+        uint32_t checksumErrors;   /**< sentences failing or missing the checksum */
+        uint32_t droppedSentences; /**< sentences truncated, overlong or malformed */
+        uint32_t unknownSentences; /**< valid sentences without a table entry */
+        uint32_t locationUpdates;  /**< location updates produced */
+    };
+
+    /** Longest sentence accepted, '$' to checksum included. */
+    static const unsigned MAX_SENTENCE_LENGTH = 128;
+
+    GPSNmeaParser();
+
+    /**
+     * Drop any partial sentence and forget the last location and date.
+     */
+    void reset(void);
+
+    /**
+     * Consume bytes from the receive stream.
+     *
+     * @param  data the bytes to parse.
+     * @param  len  number of bytes available at data.
+     * @return the number of bytes consumed; less than len when a location
+     *         update completed (see takeLocationUpdate()).
+     */
+    size_t parse(const uint8_t *data, size_t len);
+
+    /**
+     * @return true if a location update completed since the previous call;
+     *     the pending flag is cleared.
+     */
+    bool takeLocationUpdate(void) {
+        bool updated = _locationUpdated;
+        _locationUpdated = false;
+        return updated;
+    }
+
+    /**
+     * @return the location assembled from the sentences parsed so far.
+     */
+    const GPSProvider::LocationUpdateParams_t &getLocation(void) const {
+        return _location;
+    }
+
+    /**
+     * @return speed over ground (m/s) from the last RMC/VTG sentence.
+     */
+    float getSpeed(void) const {
+        return _speed;
+    }
+
+    /**
+     * @return course over ground (degrees) from the last RMC/VTG sentence.
+     */
+    float getCourse(void) const {
+        return _course;
+    }
+
+    const ParserStats_t &getStats(void) const {
+        return _stats;
+    }
+
+private:
+    enum ParserState_t {
+        STATE_IDLE,
+        STATE_ADDRESS,
+        STATE_FIELDS,
+        STATE_SKIP,
+        STATE_CHECKSUM_HI,
+        STATE_CHECKSUM_LO
+    };
+
+    /* Meaning of a field within a sentence; used by the dispatch table. */
+    enum FieldKind_t {
+        FIELD_IGNORE = 0,
+        FIELD_TIME,
+        FIELD_LAT,
+        FIELD_LAT_HEMI,
+        FIELD_LON,
+        FIELD_LON_HEMI,
+        FIELD_QUALITY,
+        FIELD_ALTITUDE,
+        FIELD_STATUS,
+        FIELD_SPEED_KNOTS,
+        FIELD_COURSE,
+        FIELD_DATE,
+        FIELD_DAY,
+        FIELD_MONTH,
+        FIELD_YEAR,
+        FIELD_MSG_NUM,
+        FIELD_SV_IN_VIEW
+    };
+
+    struct SentenceDesc_t {
+        uint32_t      type;      /* sentence id packed as 'G' << 16 | 'G' << 8 | 'A' */
+        const uint8_t *fields;   /* FieldKind_t of fields 1..numFields */
+        uint8_t       numFields;
+        void          (GPSNmeaParser::*commit)(void);
+    };
+
+    /* Field values of the sentence being parsed; applied once the checksum
+     * has been verified. */
+    struct Scratch_t {
+        uint32_t       present; /* bit set of FieldKind_t seen non-empty */
+        uint32_t       todMs;
+        double         lat;
+        double         lon;
+        char           latHemi;
+        char           lonHemi;
+        char           status;
+        unsigned       quality;
+        float          altitude;
+        float          speedKnots;
+        float          course;
+        unsigned       date;    /* ddmmyy */
+        unsigned       day;
+        unsigned       month;
+        unsigned       year;
+        unsigned       msgNum;
+        unsigned       svInView;
+    };
+
+    void beginSentence(void);
+    void dropSentence(void);
+    void lookupSentence(void);
+    void endField(void);
+    bool has(FieldKind_t kind) const {
+        return (_scratch.present & (1UL << kind)) != 0;
+    }
+
+    void commitGGA(void);
+    void commitRMC(void);
+    void commitGSV(void);
+    void commitVTG(void);
+    void commitZDA(void);
+    void setDate(uint64_t dateMs);
+    uint64_t fixTime(void);
+
+    static const uint8_t        GGA_FIELDS[];
+    static const uint8_t        RMC_FIELDS[];
+    static const uint8_t        GSV_FIELDS[];
+    static const uint8_t        VTG_FIELDS[];
+    static const uint8_t        ZDA_FIELDS[];
+    static const SentenceDesc_t SENTENCES[];
+    static const unsigned       NUM_SENTENCES;
+
+    ParserState_t                       _state;
+    unsigned                            _length;
+    uint8_t                             _checksum;
+    uint8_t                             _rxChecksum;
+
+    uint32_t                            _address;     /* last 3 chars of the address field */
+    uint16_t                            _talker;
+    unsigned                            _addressLen;
+    const SentenceDesc_t                *_desc;
+    unsigned                            _fieldIndex;
+
+    /* current field accumulator */
+    uint64_t                            _acc;
+    uint8_t                             _digits;
+    uint8_t                             _frac;
+    bool                                _seenDot;
+    bool                                _negative;
+    bool                                _fieldBad;
+    char                                _first;
+    unsigned                            _fieldLen;
+
+    Scratch_t                           _scratch;
+
+    bool                                _haveDate;
+    uint64_t                            _dateMs;
+    uint32_t                            _lastTodMs;
+    bool                                _seenGGA;
+    bool                                _locationUpdated;
+    float                               _speed;
+    float                               _course;
+    GPSProvider::LocationUpdateParams_t _location;
+    ParserStats_t                       _stats;
+};
+
+#endif /* __GPS_NMEA_PARSER_H__ */
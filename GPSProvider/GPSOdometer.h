@@ -0,0 +1,270 @@
+/**
+ ******************************************************************************
+ * @file    GPSOdometer.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Host-side odometer with named trip counters.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_ODOMETER_H__
+#define __GPS_ODOMETER_H__
+
+#include <stdint.h>
+#include "GPSProviderCommon.h"
+#include "GPSProvider.h"
+#include "GPSLocalFrame.h"
+
+//
+// Odometer computed from the location updates, for receivers without one
+// (or when more than the odoA/odoB/odoPon counters are needed):
+//
+//      GPSOdometer odo;
+//      odo.onOdo(handleOdo);
+//      odo.enableOdo();
+//      odo.startOdo(5000);          /* handleOdo() after 5 km */
+//      odo.addTrip("leg 1");
+//      ...
+//      /* from the location callback */
+//      odo.update(*newLocation);
+//
+// Each fix adds one step to a single running total; a trip only records
+// the total when it was (re)started, so any number of trips costs nothing
+// per update. The step is GPSLocalFrame::distance() between the fixes, so
+// no trigonometry is needed but when the frame re-anchors; a frame shared
+// with other components is used through update(location, point). The
+// total uses compensated (Neumaier) summation, so it
+// stays within rounding of the exact sum of the steps instead of losing
+// the low bits of every step once it reaches thousands of km
+// (odometer.drift in test/benchmark checks it over 125,000 km). With
+// GPS_LOCATION_FIXED_POINT the step is GPSLocalFrame::distanceMm() and the
+// total an integer count of millimeters: no floating point per update.
+//
+// odoPon counts from enableOdo(), odoA from startOdo() (and stops with
+// stopOdo()), odoB from the last resetOdo(), which also clears odoA.
+//
+
+class GPSOdometer {
+public:
+    /** Longest trip name, terminator excluded. */
+    static const unsigned MAX_NAME = 15;
+
+    /** Odometer counters */
+    struct OdometerStats_t {
+        uint32_t updates;      /**< location updates offered while enabled */
+        uint32_t invalid;      /**< updates without a valid fix */
+        uint32_t steps;        /**< steps added to the total */
+        uint32_t jitter;       /**< fixes within the minimum step of the last one */
+    };
+
+    GPSOdometer();
+    virtual ~GPSOdometer();
+
+    /**
+     * Start counting from the next fix; every counter is cleared.
+     */
+    gps_provider_error_t enableOdo(void);
+
+    /**
+     * Restart odoA from the current position and arm the alarm.
+     *
+     * @param alarmDistance odoA distance (meters) publishing the odometer
+     *     message once through the onOdo callback; 0 disables the alarm.
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_ODO_START if disabled.
+     */
+    gps_provider_error_t startOdo(unsigned alarmDistance);
+
+    /**
+     * Freeze odoA and disarm the alarm.
+     */
+    gps_provider_error_t stopOdo(void);
+
+    /**
+     * Clear odoA and odoB.
+     */
+    gps_provider_error_t resetOdo(void);
+
+    /**
+     * Ignore fixes closer than minStep meters to the last counted one, so
+     * that position noise does not add up while stationary (default 0).
+     */
+    void setMinStep(double minStep) {
+        _minStep = (minStep > 0.0) ? minStep : 0.0;
+        _minStepMm = (uint32_t)(_minStep * 1000.0 + 0.5);
+    }
+
+    /**
+     * Add the step to a new fix.
+     *
+     * @return the distance added (meters).
+     */
+    double update(const GPSProvider::LocationUpdateParams_t &location);
+
+    /**
+     * Same as update(location), with location already converted by a
+     * shared frame.
+     */
+    double update(const GPSProvider::LocationUpdateParams_t &location, const GPSLocalFrame::Point_t &point);
+
+    /**
+     * @return the distance (meters) since enableOdo().
+     */
+    double getDistance(void) const;
+
+    /**
+     * Fill params with odoA, odoB and odoPon (whole meters) and the time of
+     * the last fix.
+     */
+    void getOdo(GPSProvider::OdoParams_t &params) const;
+
+    /**
+     * Publish the counters through the onOdo callback.
+     */
+    void reportOdo(void);
+
+    /**
+     * Add a running trip counter, starting at 0.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_ODO_START if the name is
+     *     empty, too long or in use / GPS_ERROR_NO_MEM.
+     */
+    gps_provider_error_t addTrip(const char *name);
+
+    /**
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_ODO_RESET if unknown.
+     */
+    gps_provider_error_t removeTrip(const char *name);
+
+    /**
+     * Resume a stopped trip.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_ODO_START if unknown.
+     */
+    gps_provider_error_t startTrip(const char *name);
+
+    /**
+     * Freeze a trip.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_ODO_STOP if unknown.
+     */
+    gps_provider_error_t stopTrip(const char *name);
+
+    /**
+     * Clear a trip, keeping it running or stopped.
+     *
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_ODO_RESET if unknown.
+     */
+    gps_provider_error_t resetTrip(const char *name);
+
+    /**
+     * @return the distance (meters) of a trip, -1 if unknown.
+     */
+    double getTripDistance(const char *name) const;
+
+    unsigned getTripCount(void) const {
+        return _tripCount;
+    }
+
+    /**
+     * @return the name of the index-th trip, in creation order.
+     */
+    const char *getTripName(unsigned index) const {
+        return (index < _tripCount) ? _trips[index].name : NULL;
+    }
+
+    bool isEnabled(void) const {
+        return _enabled;
+    }
+
+    /**
+     * Setup the odometer callback.
+     */
+    void onOdo(GPSProvider::OdoCallback_t callback) {
+        _odoCallback = callback;
+    }
+
+    void getStats(OdometerStats_t &stats) const {
+        stats = _stats;
+    }
+
+private:
+    struct Trip_t {
+        char   name[MAX_NAME + 1];
+        double base;        /* distance accumulated before the last start */
+#if defined(GPS_LOCATION_FIXED_POINT)
+        uint64_t markMm;    /* total when last started */
+#else
+        double markSum;     /* total when last started */
+        double markComp;
+#endif
+        bool   running;
+    };
+
+    void startCounter(Trip_t &trip) const;
+    void stopCounter(Trip_t &trip) const;
+    void resetCounter(Trip_t &trip) const;
+    double counterDistance(const Trip_t &trip) const;
+    int findTrip(const char *name) const;
+
+    bool                            _enabled;
+    bool                            _haveAnchor;
+    GPSLocalFrame::Point_t          _anchor;       /* last counted fix */
+    double                          _minStep;
+    uint32_t                        _minStepMm;
+    GPSLocalFrame                   _frame;
+
+#if defined(GPS_LOCATION_FIXED_POINT)
+    uint64_t                        _totalMm;
+#else
+    double                          _sum;          /* total, plus compensation */
+    double                          _comp;
+#endif
+
+    Trip_t                          _odoA;
+    Trip_t                          _odoB;
+    Trip_t                          _odoPon;
+    unsigned                        _alarmDistance;
+    uint64_t                        _lastUtcTime;
+
+    Trip_t                          *_trips;
+    unsigned                        _tripCount;
+    unsigned                        _tripCapacity;
+
+    GPSProvider::OdoCallback_t      _odoCallback;
+    OdometerStats_t                 _stats;
+
+    /* disallow copy constructor and assignment operators */
+    GPSOdometer(const GPSOdometer&);
+    GPSOdometer & operator= (const GPSOdometer&);
+};
+
+#endif /* __GPS_ODOMETER_H__ */
@@ -0,0 +1,224 @@
+/**
+ ******************************************************************************
+ * @file    GPSPowerScheduler.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Motion-driven selection of the power mode and fix interval.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_POWER_SCHEDULER_H__
+#define __GPS_POWER_SCHEDULER_H__
+
+#include <stdint.h>
+#include "GPSProviderCommon.h"
+#include "GPSProvider.h"
+#include "GPSLocalFrame.h"
+
+//
+// Picks the power mode and the fix interval from the motion of the recent
+// fixes, instead of a static setPowerMode() choice:
+//
+//      GPSPowerScheduler scheduler(&gps);
+//      scheduler.onModeChange(handleModeChange);
+//      ...
+//      void onLocation(const GPSProvider::LocationUpdateParams_t *fix) {
+//          uint64_t next = scheduler.update(*fix);
+//          /* POWER_LOW: sleep until next, then lpmGetImmediateLocation() */
+//      }
+//
+// The speed is the displacement over the last speed window (60 s by
+// default, or the last two fixes when they are further apart), so position
+// noise of a parked receiver does not read as walking. States:
+//
+//      STATIONARY  below 0.5 m/s   POWER_LOW,  a fix every 5 min
+//      WALKING     below 2.5 m/s   POWER_LOW,  a fix every 10 s
+//      DRIVING     above           POWER_FULL, a fix every second
+//
+// (policies and thresholds are configurable). Hysteresis works twice: a
+// threshold is crossed upwards only 25% above it and downwards only 25%
+// below it, and a new state must then hold for the dwell time before it is
+// applied: 5 s to speed up, 2 min to slow down. While a state waits for
+// its dwell time, update() asks for the fix confirming it. A mode
+// change calls setPowerMode() and start() on the provider given at
+// construction (start() repeatedly doesn't hurt).
+//
+// Time in state and in power mode are accounted on the fix clock, so a
+// replayed trace gives the share of time each mode would have run.
+//
+
+class GPSPowerScheduler {
+public:
+    enum MotionState_t {
+        MOTION_STATIONARY,
+        MOTION_WALKING,
+        MOTION_DRIVING,
+        MOTION_STATES
+    };
+
+    /** Power mode and fix interval applied in a motion state */
+    struct PowerPolicy_t {
+        GPSProvider::PowerMode_t mode;
+        uint32_t                 fixIntervalMs;
+    };
+
+    struct ModeChangeParams_t {
+        MotionState_t            state;
+        MotionState_t            previous;
+        GPSProvider::PowerMode_t mode;
+        uint32_t                 fixIntervalMs;
+        double                   speed;        /**< m/s, at the decision */
+        uint64_t                 utcTime;      /**< time of the deciding fix (ms) */
+    };
+
+    typedef void (* ModeChangeCallback_t)(const ModeChangeParams_t *params);
+
+    /** Scheduler counters */
+    struct SchedulerStats_t {
+        uint32_t fixes;                          /**< valid fixes classified */
+        uint32_t invalid;                        /**< invalid fixes */
+        uint32_t transitions;                    /**< motion state changes */
+        uint32_t modeSwitches;                   /**< of which changed the power mode */
+        uint32_t suppressed;                     /**< candidate states dropped before their dwell time */
+        uint64_t timeInState[MOTION_STATES];     /**< ms */
+        uint64_t timeInMode[2];                  /**< ms, by PowerMode_t */
+    };
+
+    /** Fixes kept for the speed estimate, spread over the speed window. */
+    static const unsigned HISTORY = 16;
+
+    /**
+     * @param gps provider the power mode is applied to (may be NULL).
+     */
+    explicit GPSPowerScheduler(GPSProvider *gps = NULL);
+    virtual ~GPSPowerScheduler() {}
+
+    void setPolicy(MotionState_t state, GPSProvider::PowerMode_t mode, uint32_t fixIntervalMs);
+
+    /**
+     * Speeds (m/s) separating STATIONARY from WALKING, WALKING from DRIVING;
+     * hysteresisRatio (e.g. 0.25) widens each into a band.
+     */
+    void setThresholds(double walkingSpeed, double drivingSpeed, double hysteresisRatio);
+
+    /**
+     * Time a faster (upMs) or slower (downMs) state must hold before it is
+     * applied.
+     */
+    void setDwell(uint32_t upMs, uint32_t downMs) {
+        _dwellUp = upMs;
+        _dwellDown = downMs;
+    }
+
+    /**
+     * Span (ms) the speed is averaged over.
+     */
+    void setSpeedWindow(uint32_t windowMs) {
+        _window = windowMs;
+    }
+
+    void onModeChange(ModeChangeCallback_t callback) {
+        _modeChangeCallback = callback;
+    }
+
+    /**
+     * Classify a new fix and apply the state change, if any.
+     *
+     * @return the UTC time (ms) the next fix is wanted at.
+     */
+    uint64_t update(const GPSProvider::LocationUpdateParams_t &location);
+
+    /**
+     * Same as update(location), with location already converted by a
+     * shared frame.
+     */
+    uint64_t update(const GPSProvider::LocationUpdateParams_t &location, const GPSLocalFrame::Point_t &point);
+
+    MotionState_t getState(void) const {
+        return _state;
+    }
+
+    const PowerPolicy_t &getPolicy(MotionState_t state) const {
+        return _policy[state];
+    }
+
+    /**
+     * @return the speed (m/s) estimated at the last fix.
+     */
+    double getSpeed(void) const {
+        return _speed;
+    }
+
+    /**
+     * Start over in state, history and counters cleared; the policy of
+     * state is applied to the provider.
+     */
+    void reset(MotionState_t state = MOTION_DRIVING);
+
+    void getStats(SchedulerStats_t &stats) const {
+        stats = _stats;
+    }
+
+private:
+    void clear(MotionState_t state);
+    MotionState_t classify(double speed) const;
+    void apply(MotionState_t state, uint64_t utcTime);
+
+    GPSProvider                 *_gps;
+    PowerPolicy_t               _policy[MOTION_STATES];
+    double                      _up[MOTION_STATES];      /* speed leaving a state upwards */
+    double                      _down[MOTION_STATES];    /* speed leaving a state downwards */
+    uint32_t                    _dwellUp;
+    uint32_t                    _dwellDown;
+    uint32_t                    _window;
+
+    GPSLocalFrame::Point_t      _points[HISTORY];
+    uint64_t                    _times[HISTORY];
+    unsigned                    _head;
+    unsigned                    _count;
+
+    MotionState_t               _state;
+    MotionState_t               _candidate;
+    uint64_t                    _candidateSince;
+    uint64_t                    _lastTime;
+    double                      _speed;
+
+    GPSLocalFrame               _frame;
+    ModeChangeCallback_t        _modeChangeCallback;
+    SchedulerStats_t            _stats;
+
+    /* disallow copy constructor and assignment operators */
+    GPSPowerScheduler(const GPSPowerScheduler&);
+    GPSPowerScheduler & operator= (const GPSPowerScheduler&);
+};
+
+#endif /* __GPS_POWER_SCHEDULER_H__ */
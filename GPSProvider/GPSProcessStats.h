@@ -0,0 +1,222 @@
+/**
+ ******************************************************************************
+ * @file    GPSProcessStats.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Compile-time removable instrumentation of process().
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_PROCESS_STATS_H__
+#define __GPS_PROCESS_STATS_H__
+
+#include <stdint.h>
+#include <string.h>
+#include "GPSProvider.h"
+
+//
+// Hot-path instrumentation for GPSProviderImplBase backends, reported by
+// GPSProvider::getProcessStats(). Built with GPS_PROCESS_STATS defined,
+// otherwise every method is empty and the recorder holds no state:
+//
+//      void MyProvider::process(void) {
+//          uint32_t start = _processStats.now();
+//          ... drain, parse ...
+//          _processStats.recordProcess(start, drainedBytes, parsedSentences);
+//      }
+//
+// Durations are in ticks of GPS_STATS_CLOCK(): CLOCK_MONOTONIC nanoseconds
+// on Linux, the mbed microsecond ticker elsewhere. A target can define a
+// finer one, with GPS_STATS_CLOCK_HZ, e.g. the DWT cycle counter:
+//
+//      -DGPS_STATS_CLOCK()=DWT->CYCCNT -DGPS_STATS_CLOCK_HZ=SystemCoreClock
+//
+// Ticks are 32 bit and differences wrap, so a single measurement must stay
+// below 2^32 ticks. Recording is a handful of instructions and never
+// allocates; the histograms are log2 (see StatsHistogram_t). The
+// replay.instrumented case of test/benchmark, built with and without
+// GPS_PROCESS_STATS, measures what it adds to a replay.
+//
+
+#if defined(GPS_PROCESS_STATS) && !defined(GPS_STATS_CLOCK)
+#if defined(__linux__)
+#include <time.h>
+static inline uint32_t gpsStatsClock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+#define GPS_STATS_CLOCK()    gpsStatsClock()
+#define GPS_STATS_CLOCK_HZ   1000000000UL
+#else
+/* the mbed microsecond ticker, unless the target brings a finer clock */
+#include "mbed.h"
+#define GPS_STATS_CLOCK()    us_ticker_read()
+#define GPS_STATS_CLOCK_HZ   1000000UL
+#endif
+#endif
+
+class GPSProcessStats {
+public:
+    static const unsigned BUCKETS = sizeof(((GPSProvider::StatsHistogram_t *)0)->buckets) / sizeof(uint32_t);
+
+    GPSProcessStats() {
+        reset();
+    }
+
+#if defined(GPS_PROCESS_STATS)
+    uint32_t now(void) const {
+        return GPS_STATS_CLOCK();
+    }
+
+    /**
+     * Account a process() call that started at start.
+     */
+    void recordProcess(uint32_t start, uint32_t drainedBytes, uint32_t sentences) {
+        _stats.processCalls++;
+        record(_stats.processTicks, GPS_STATS_CLOCK() - start);
+        record(_stats.drainedBytes, drainedBytes);
+        record(_stats.sentences, sentences);
+    }
+
+    /**
+     * Account a location callback that started at start.
+     */
+    void recordCallback(uint32_t start) {
+        _stats.locationUpdates++;
+        record(_stats.callbackTicks, GPS_STATS_CLOCK() - start);
+    }
+
+    /**
+     * Account the time from the reception of the last byte of a location
+     * update (in the ISR) to the dispatch of its callback.
+     */
+    void recordLatency(uint32_t ticks) {
+        record(_stats.latencyTicks, ticks);
+    }
+
+    /**
+     * @return ns converted to ticks, for backends timing with another clock.
+     */
+    static uint32_t ticksFromNs(uint64_t ns) {
+        return (uint32_t)((double)ns * ((double)(GPS_STATS_CLOCK_HZ) * 1e-9));
+    }
+
+    /**
+     * Take over the error counters kept by the parser and the ring.
+     */
+    void setErrors(uint32_t checksumErrors, uint32_t droppedSentences,
+                   uint32_t overrunBytes, uint32_t overrunEvents) {
+        _stats.checksumErrors = checksumErrors;
+        _stats.droppedSentences = droppedSentences;
+        _stats.overrunBytes = overrunBytes;
+        _stats.overrunEvents = overrunEvents;
+    }
+
+    void get(GPSProvider::ProcessStats_t &stats) const {
+        stats = _stats;
+    }
+
+    void reset(void) {
+        memset(&_stats, 0, sizeof(_stats));
+        _stats.enabled = 1;
+        _stats.clockHz = (uint32_t)(GPS_STATS_CLOCK_HZ);
+    }
+
+    static void record(GPSProvider::StatsHistogram_t &histogram, uint32_t value) {
+        histogram.count++;
+        histogram.sum += value;
+        if (value > histogram.max) {
+            histogram.max = value;
+        }
+        histogram.buckets[bucket(value)]++;
+    }
+#else
+    uint32_t now(void) const {
+        return 0;
+    }
+    void recordProcess(uint32_t, uint32_t, uint32_t) {}
+    void recordCallback(uint32_t) {}
+    void recordLatency(uint32_t) {}
+    static uint32_t ticksFromNs(uint64_t) {
+        return 0;
+    }
+    void setErrors(uint32_t, uint32_t, uint32_t, uint32_t) {}
+    void get(GPSProvider::ProcessStats_t &stats) const {
+        memset(&stats, 0, sizeof(stats));
+    }
+    void reset(void) {}
+#endif
+
+    /**
+     * @return the bit length of value, capped to the last bucket.
+     */
+    static unsigned bucket(uint32_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        unsigned length = (value == 0) ? 0 : 32 - (unsigned)__builtin_clz(value);
+#else
+        unsigned length = 0;
+        while (value != 0) {
+            length++;
+            value >>= 1;
+        }
+#endif
+        return (length < BUCKETS) ? length : BUCKETS - 1;
+    }
+
+    /**
+     * @return an upper bound of the fraction-th quantile (e.g. 0.99) of
+     *     histogram: the top of the bucket holding it.
+     */
+    static uint32_t quantile(const GPSProvider::StatsHistogram_t &histogram, double fraction) {
+        uint64_t rank = (uint64_t)(fraction * histogram.count);
+        uint64_t seen = 0;
+        for (unsigned i = 0; i < BUCKETS - 1; i++) {
+            seen += histogram.buckets[i];
+            if (seen > rank) {
+                return (i == 0) ? 0 : (uint32_t)((1ULL << i) - 1);
+            }
+        }
+        return histogram.max;
+    }
+
+private:
+#if defined(GPS_PROCESS_STATS)
+    GPSProvider::ProcessStats_t _stats;
+#endif
+
+    /* disallow copy constructor and assignment operators */
+    GPSProcessStats(const GPSProcessStats&);
+    GPSProcessStats & operator= (const GPSProcessStats&);
+};
+
+#endif /* __GPS_PROCESS_STATS_H__ */
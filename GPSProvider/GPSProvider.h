@@ -17,6 +17,9 @@
 #ifndef __GPS_PROVIDER_H__
 #define __GPS_PROVIDER_H__
 
+#include <stdint.h>
+#include "GPSProviderCommon.h"
+
 // [ST-GNSS] - Geofencing API
 class GPSGeofence; /* forward declaration */
 // [ST-GNSS] - Datalogging API
@@ -103,6 +106,32 @@ public:
         uint64_t       utcTime; /* UTC time in millisecond */
     };
 
+    /** Log2 histogram: buckets[i] counts the values of bit length i
+     * (bucket 0 holds zeros, the last one everything above). */
+    struct StatsHistogram_t {
+      uint32_t count;
+      uint32_t max;
+      uint64_t sum;
+      uint32_t buckets[24];
+    };
+
+    /** Instrumentation of process(); times are in ticks of clockHz. */
+    struct ProcessStats_t {
+      uint32_t         enabled;          /**< 0 when built without GPS_PROCESS_STATS */
+      uint32_t         clockHz;          /**< tick rate of the *Ticks histograms */
+      uint32_t         processCalls;
+      uint32_t         locationUpdates;
+      uint32_t         checksumErrors;   /**< sentences failing or missing the checksum */
+      uint32_t         droppedSentences; /**< sentences truncated, overlong or malformed */
+      uint32_t         overrunBytes;     /**< receive bytes lost before process() */
+      uint32_t         overrunEvents;
+      StatsHistogram_t processTicks;     /**< duration of process() */
+      StatsHistogram_t drainedBytes;     /**< bytes drained per process() */
+      StatsHistogram_t sentences;        /**< sentences parsed per process() */
+      StatsHistogram_t callbackTicks;    /**< duration of the onLocationUpdate callback */
+      StatsHistogram_t latencyTicks;     /**< reception of the last byte to onLocationUpdate */
+    };
+
     /** [ST-GNSS] - Geofencing API */
     struct Timestamp_t {
       int hh;  /**< Hours */
@@ -119,6 +148,14 @@ public:
       int numGeofences;
       int idAlarm;
     };
+
+    /** [ST-GNSS] - Geofencing API */
+    struct GeofenceDeltaStats_t {
+      uint32_t commandsSent;   /**< configuration commands sent by add/update/removeGeofence() */
+      uint32_t commandsSaved;  /**< commands a full configGeofences() re-push would have added */
+      uint32_t bytesSent;
+      uint32_t bytesSaved;
+    };
     
     /** [ST-GNSS] - Datalogging API */
     struct LogStatusParams_t {
@@ -254,6 +291,17 @@ public:
      */
     uint32_t ioctl(uint32_t command, void *arg);
 
+    /**
+     * Fill stats with the process() instrumentation (GPSProcessStats.h);
+     * stats.enabled is 0 if it was compiled out or is not supported.
+     */
+    void getProcessStats(ProcessStats_t &stats) const;
+
+    /**
+     * Clear the process() instrumentation.
+     */
+    void resetProcessStats(void);
+
     /** [ST-GNSS ] - Enable verbose NMEA stream */
     void setVerboseMode(int level);
 
@@ -290,6 +338,45 @@ public:
      */
     gps_provider_error_t geofenceReq(void);
 
+    /**
+     * [ST-GNSS] - Geofencing API
+     * Add one geofence to the configured set, without re-sending the others.
+     *
+     * @return GPS_ERROR_NONE on success / 
+     *         GPS_ERROR_GEOFENCE_CFG if the id is already configured /
+     *         GPS_ERROR_GEOFENCE_MAX_EXCEEDED.
+     *         A callback (if set) will be invoked upon a message is received
+     *         from the GPS device.
+     */
+    gps_provider_error_t addGeofence(GPSGeofence *geofence);
+
+    /**
+     * [ST-GNSS] - Geofencing API
+     * Apply the changes made to a configured geofence (matched by
+     * GeofenceCircle_t::id). Nothing is sent if the circle did not change;
+     * toggling enabled only sends the enable/disable command.
+     *
+     * @return GPS_ERROR_NONE on success / 
+     *         GPS_ERROR_GEOFENCE_CFG if the id is not configured.
+     */
+    gps_provider_error_t updateGeofence(GPSGeofence *geofence);
+
+    /**
+     * [ST-GNSS] - Geofencing API
+     * Remove the geofence with the given id from the configured set. The
+     * last geofence takes its place in GeofenceStatusParams_t::currentStatus.
+     *
+     * @return GPS_ERROR_NONE on success / 
+     *         GPS_ERROR_GEOFENCE_CFG if the id is not configured.
+     */
+    gps_provider_error_t removeGeofence(int id);
+
+    /**
+     * [ST-GNSS] - Geofencing API
+     * Traffic of the incremental operations compared with full re-pushes.
+     */
+    void getGeofenceDeltaStats(GeofenceDeltaStats_t &stats) const;
+
     /**
      * [ST-GNSS] - Datalogging API
      * Enable the Datalogging subsystem.
@@ -360,6 +447,21 @@ public:
      */
     gps_provider_error_t logReqQuery(LogQueryParams_t &logReqQuery);
 
+    /**
+     * [ST-GNSS] - Datalogging API
+     * Read log entries straight into a buffer, for backends holding the log
+     * on the host. Same selection as logReqQuery() (logReqQuery.entries is
+     * ignored), minus the first skip matching entries.
+     *
+     * @param  count in: room in entries; out: entries stored (fewer than
+     *         room when the end of the log was reached).
+     * @return GPS_ERROR_NONE on success / GPS_ERROR_LOG_REQ_QUERY /
+     *         GPS_ERROR_LOG_NOT_IMPLEMENTED if entries only come through
+     *         the log query callback.
+     */
+    gps_provider_error_t logReqBulk(LogQueryParams_t &logReqQuery, unsigned skip,
+                                    LogQueryRespParams_t *entries, unsigned &count);
+
     /**
      * [ST-GNSS] - Odometer API
      * Enable the Odometer subsystem.
@@ -546,6 +648,14 @@ public:
         /* empty */
     }
 
+    /**
+     * Construct a GPSProvider on top of an explicit implementation object,
+     * e.g. a host-side replay backend. The caller retains ownership of instance.
+     */
+    explicit GPSProvider(GPSProviderImplBase *instance) : impl(instance) {
+        /* empty */
+    }
+
     virtual ~GPSProvider() {
         stop();
     }
@@ -17,6 +17,7 @@
 #ifndef __GPS_PROVIDER_INSTANCE_BASE_H__
 #define __GPS_PROVIDER_INSTANCE_BASE_H__
 
+#include <string.h>
 #include "GPSProviderCommon.h"
 #include "GPSProvider.h"
 #include "GPSGeofence.h"
@@ -32,13 +33,39 @@ public:
     virtual void lpmGetImmediateLocation(void) = 0;
     virtual uint32_t ioctl(uint32_t command, void *arg) = 0;
 
+    virtual void getProcessStats(GPSProvider::ProcessStats_t &stats) const {
+        memset(&stats, 0, sizeof(stats)); /* Requesting action from porters: override this API if this capability is supported. */
+    }
+    virtual void resetProcessStats(void) {
+    }
+
     /** [ST-GNSS ] - Enable verbose NMEA stream */
-    virtual void setVerboseMode(int level);
+    virtual void setVerboseMode(int level) {
+        (void)level; /* Requesting action from porters: override this API if this capability is supported. */
+    }
 
     /** [ST-GNSS] - Geofencing API */
     virtual gps_provider_error_t enableGeofence(void) = 0;
     virtual gps_provider_error_t configGeofences(GPSGeofence *geofences[], unsigned GeofenceCount) = 0;
     virtual gps_provider_error_t geofenceReq(void) = 0;
+    virtual gps_provider_error_t addGeofence(GPSGeofence *geofence) {
+        (void)geofence;
+        return GPS_ERROR_GEOFENCE_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
+    }
+    virtual gps_provider_error_t updateGeofence(GPSGeofence *geofence) {
+        (void)geofence;
+        return GPS_ERROR_GEOFENCE_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
+    }
+    virtual gps_provider_error_t removeGeofence(int id) {
+        (void)id;
+        return GPS_ERROR_GEOFENCE_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
+    }
+    virtual void getGeofenceDeltaStats(GPSProvider::GeofenceDeltaStats_t &stats) const {
+        stats.commandsSent = 0;
+        stats.commandsSaved = 0;
+        stats.bytesSent = 0;
+        stats.bytesSaved = 0;
+    }
 
     /** [ST-GNSS] - Datalogging API */
     virtual gps_provider_error_t enableDatalog(void) = 0;
@@ -48,6 +75,14 @@ public:
     virtual gps_provider_error_t eraseDatalog(void) = 0;
     virtual gps_provider_error_t logReqStatus(void) = 0;
     virtual gps_provider_error_t logReqQuery(GPSProvider::LogQueryParams_t &logReqQuery) = 0;
+    virtual gps_provider_error_t logReqBulk(GPSProvider::LogQueryParams_t &logReqQuery, unsigned skip,
+                                            GPSProvider::LogQueryRespParams_t *entries, unsigned &count) {
+        (void)logReqQuery;
+        (void)skip;
+        (void)entries;
+        count = 0;
+        return GPS_ERROR_LOG_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
+    }
 
     /**  [ST-GNSS] - Odometer API*/
     virtual gps_provider_error_t enableOdo(void) = 0;
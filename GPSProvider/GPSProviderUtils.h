@@ -0,0 +1,145 @@
+/**
+ ******************************************************************************
+ * @file    GPSProviderUtils.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Time and geodesy helpers shared by the GPSProvider components.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+#ifndef __GPS_PROVIDER_UTILS_H__
+#define __GPS_PROVIDER_UTILS_H__
+
+#include <stdint.h>
+#include <math.h>
+#include "GPSProvider.h"
+
+/** Mean Earth radius (m) used by the local distance approximations. */
+#define GPS_EARTH_RADIUS_M   6371008.8
+#define GPS_PI               3.14159265358979323846
+#define GPS_DEG_TO_RAD       (GPS_PI / 180.0)
+#define GPS_RAD_TO_DEG       (180.0 / GPS_PI)
+
+class GPSProviderUtils {
+public:
+
+    /** Seconds between the UTC (1970) and GPS (1980-01-06) epochs. */
+    static const uint64_t GPS_EPOCH_OFFSET_S = 315964800ULL;
+
+    /** GPS-UTC leap seconds in force since 2017. */
+    static const unsigned GPS_LEAP_SECONDS = 18;
+
+    static const uint64_t MS_PER_DAY  = 86400000ULL;
+    static const uint64_t MS_PER_WEEK = 604800000ULL;
+
+    /**
+     * Number of days from 1970-01-01 to the given civil date
+     * (proleptic Gregorian calendar).
+     */
+    static int64_t daysFromCivil(int year, unsigned month, unsigned day) {
+        year -= (month <= 2) ? 1 : 0;
+        const int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const unsigned yoe = (unsigned)(year - era * 400);
+        const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + (int64_t)doe - 719468;
+    }
+
+    /**
+     * Inverse of daysFromCivil().
+     */
+    static void civilFromDays(int64_t days, int &year, int &month, int &day) {
+        days += 719468;
+        const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        const unsigned doe = (unsigned)(days - era * 146097);
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const unsigned mp = (5 * doy + 2) / 153;
+        day = (int)(doy - (153 * mp + 2) / 5 + 1);
+        month = (int)(mp < 10 ? mp + 3 : mp - 9);
+        year = (int)(yoe + era * 400 + (month <= 2 ? 1 : 0));
+    }
+
+    /**
+     * Convert a Timestamp_t into UTC milliseconds since 1970-01-01.
+     */
+    static uint64_t timestampToUtcMs(const GPSProvider::Timestamp_t &ts) {
+        int64_t days = daysFromCivil(ts.year, (unsigned)ts.month, (unsigned)ts.day);
+        int64_t secs = days * 86400 + ts.hh * 3600 + ts.mm * 60 + ts.ss;
+        return (uint64_t)secs * 1000ULL;
+    }
+
+    /**
+     * Convert UTC milliseconds since 1970-01-01 into a Timestamp_t
+     * (sub-second part is truncated).
+     */
+    static void utcMsToTimestamp(uint64_t utcMs, GPSProvider::Timestamp_t &ts) {
+        uint64_t secs = utcMs / 1000ULL;
+        unsigned sod = (unsigned)(secs % 86400ULL);
+        civilFromDays((int64_t)(secs / 86400ULL), ts.year, ts.month, ts.day);
+        ts.hh = (int)(sod / 3600);
+        ts.mm = (int)((sod / 60) % 60);
+        ts.ss = (int)(sod % 60);
+    }
+
+    /**
+     * Distance in meters between two points (degrees), equirectangular
+     * approximation around the first one; fine up to tens of km.
+     */
+    static double localDistance(double lat1, double lon1, double lat2, double lon2) {
+        double dLon = lon2 - lon1;
+        if (dLon > 180.0) {
+            dLon -= 360.0;
+        } else if (dLon < -180.0) {
+            dLon += 360.0;
+        }
+        double x = dLon * cos(lat1 * GPS_DEG_TO_RAD);
+        double y = lat2 - lat1;
+        return sqrt(x * x + y * y) * GPS_EARTH_RADIUS_M * GPS_DEG_TO_RAD;
+    }
+
+    /**
+     * Derive the GPS week/time-of-week from UTC milliseconds.
+     */
+    static void utcMsToGPSTime(uint64_t utcMs, GPSProvider::GPSTime_t &gpsTime) {
+        uint64_t epochMs = GPS_EPOCH_OFFSET_S * 1000ULL;
+        if (utcMs < epochMs) {
+            gpsTime.gps_week = 0;
+            gpsTime.tow = 0;
+            return;
+        }
+        uint64_t gpsMs = utcMs - epochMs + GPS_LEAP_SECONDS * 1000ULL;
+        gpsTime.gps_week = (uint16_t)(gpsMs / MS_PER_WEEK);
+        gpsTime.tow = (uint32_t)(gpsMs % MS_PER_WEEK);
+    }
+};
+
+#endif /* __GPS_PROVIDER_UTILS_H__ */
@@ -0,0 +1,334 @@
+/**
+ ******************************************************************************
+ * @file    GPSReplayProvider.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Host-side GPSProviderImplBase replaying recorded GNSS captures.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+#ifndef __GPS_REPLAY_PROVIDER_H__
+#define __GPS_REPLAY_PROVIDER_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "GPSProviderImplBase.h"
+#include "GPSNmeaParser.h"
+#include "GPSRingBuffer.h"
+#include "GPSGeofenceEngine.h"
+#include "GPSGeofenceIndex.h"
+#include "GPSGeofenceShadow.h"
+#include "GPSDatalogEngine.h"
+#include "GPSOdometer.h"
+#include "GPSProcessStats.h"
+
+//
+// Host-only (Linux) backend feeding a recorded capture through process().
+// It is meant for load-testing the GPSProvider pipeline off-target:
+//
+//      GPSReplayProvider replay("drive.nmea",
+//                               GPSReplayProvider::REPLAY_ACCELERATED, 10.0);
+//      GPSProvider gps(&replay);
+//
+//      gps.onLocationUpdate(handleGPSData);
+//      gps.reset();
+//      gps.start();
+//      while (!replay.isReplayDone()) {
+//          gps.process();
+//          replay.waitForData(); /* optional, see setProducerThread() */
+//      }
+//      gps.stop();
+//
+// Capture bytes travel through a GPSRingBuffer exactly as UART data would:
+// they are released into the ring according to the replay clock, and
+// process() drains the ring through the NMEA parser. By default the release
+// happens at the top of process(); with setProducerThread(true) a separate
+// thread stands in for the UART ISR, so ring overruns caused by a slow
+// consumer show up in the stats.
+//
+// Two capture formats are understood:
+//  - raw: the UART byte stream as recorded (NMEA, possibly interleaved with
+//    binary frames). Pacing is derived from the UTC time field of the
+//    sentences.
+//  - timestamped: the 8 byte magic "GPSRPLY1" followed by records made of a
+//    little-endian uint32 delay (microseconds since the previous record), a
+//    little-endian uint16 length and that many payload bytes. Pacing follows
+//    the recorded delays.
+//
+
+class GPSReplayProvider : public GPSProviderImplBase {
+public:
+    /** Replay clock selection */
+    enum ReplayClock_t {
+        REPLAY_REALTIME,    /**< bytes are released at the pace they were recorded. */
+        REPLAY_ACCELERATED, /**< recorded pace multiplied by the speedup factor. */
+        REPLAY_FASTEST,     /**< bytes are released as fast as process() drains them. */
+    };
+
+    /** Counters collected while replaying */
+    struct ReplayStats_t {
+        uint64_t bytes;                 /**< capture bytes fed to the parser */
+        uint64_t sentences;             /**< sentences with a valid checksum */
+        uint64_t badSentences;          /**< sentences dropped (checksum/length/format) */
+        uint64_t overrunBytes;          /**< bytes lost because the ring was full */
+        uint64_t overrunEvents;         /**< releases that overflowed the ring */
+        uint64_t locationUpdates;       /**< onLocationUpdate invocations */
+        uint64_t fixes;                 /**< location updates carrying a valid fix */
+        uint64_t callbackLatencyMinNs;  /**< min time from byte release to callback return */
+        uint64_t callbackLatencyMaxNs;  /**< max time from byte release to callback return */
+        uint64_t callbackLatencySumNs;  /**< sum, divide by locationUpdates for the mean */
+        uint64_t elapsedNs;             /**< wall time spent replaying */
+    };
+
+    /** Magic heading a timestamped capture. */
+    static const char TIMESTAMPED_MAGIC[8];
+
+    /**
+     * Construct a replay backend.
+     *
+     * @param capturePath path of the capture file.
+     * @param clock       the replay clock.
+     * @param speedup     pace multiplier, used by REPLAY_ACCELERATED only.
+     */
+    GPSReplayProvider(const char *capturePath,
+                      ReplayClock_t clock = REPLAY_FASTEST,
+                      double speedup = 1.0);
+
+    virtual ~GPSReplayProvider();
+
+    virtual bool setPowerMode(GPSProvider::PowerMode_t power);
+    virtual void reset(void);
+    virtual void start(void);
+    virtual void stop(void);
+    virtual void process(void);
+    virtual void lpmGetImmediateLocation(void);
+    virtual uint32_t ioctl(uint32_t command, void *arg);
+    virtual void setVerboseMode(int level);
+    virtual void getProcessStats(GPSProvider::ProcessStats_t &stats) const;
+    virtual void resetProcessStats(void);
+
+    /** [ST-GNSS] - Geofencing API */
+    virtual bool isGeofencingSupported(void) {
+        return true;
+    }
+    virtual gps_provider_error_t enableGeofence(void);
+    virtual gps_provider_error_t configGeofences(GPSGeofence *geofences[], unsigned geofenceCount);
+    virtual gps_provider_error_t geofenceReq(void);
+    virtual gps_provider_error_t addGeofence(GPSGeofence *geofence);
+    virtual gps_provider_error_t updateGeofence(GPSGeofence *geofence);
+    virtual gps_provider_error_t removeGeofence(int id);
+    virtual void getGeofenceDeltaStats(GPSProvider::GeofenceDeltaStats_t &stats) const;
+
+    /** [ST-GNSS] - Datalogging API */
+    virtual bool isDataloggingSupported(void) {
+        return true;
+    }
+    virtual gps_provider_error_t enableDatalog(void);
+    virtual gps_provider_error_t configDatalog(GPSDatalog *datalog);
+    virtual gps_provider_error_t startDatalog(void);
+    virtual gps_provider_error_t stopDatalog(void);
+    virtual gps_provider_error_t eraseDatalog(void);
+    virtual gps_provider_error_t logReqStatus(void);
+    virtual gps_provider_error_t logReqQuery(GPSProvider::LogQueryParams_t &logReqQuery);
+    virtual gps_provider_error_t logReqBulk(GPSProvider::LogQueryParams_t &logReqQuery, unsigned skip,
+                                            GPSProvider::LogQueryRespParams_t *entries, unsigned &count);
+
+    /** [ST-GNSS] - Odometer API */
+    virtual bool isOdometerSupported(void) {
+        return true;
+    }
+    virtual gps_provider_error_t enableOdo(void);
+    virtual gps_provider_error_t startOdo(unsigned alarmDistance);
+    virtual gps_provider_error_t stopOdo(void);
+    virtual gps_provider_error_t resetOdo(void);
+
+    /**
+     * Change the replay clock; takes effect upon calling start().
+     */
+    void setClock(ReplayClock_t clock, double speedup = 1.0);
+
+    /**
+     * Release the capture from a separate thread standing in for the UART
+     * ISR; takes effect upon calling start().
+     */
+    void setProducerThread(bool enable);
+
+    /**
+     * Emulate the geofence capacity of a receiver: configGeofences() fails
+     * with GPS_ERROR_GEOFENCE_MAX_EXCEEDED beyond maxGeofences (0: no limit).
+     */
+    void setGeofenceLimit(unsigned maxGeofences) {
+        _geofenceLimit = maxGeofences;
+    }
+
+    /**
+     * Select the file enableDatalog() opens (or creates with room for
+     * capacity records) as datalog store. Required before enableDatalog(),
+     * which fails with GPS_ERROR_DATALOG_CFG otherwise.
+     */
+    void setDatalogStore(const char *path, unsigned capacity) {
+        _datalogPath = path;
+        _datalogCapacity = capacity;
+    }
+
+    /**
+     * @return the datalog engine, e.g. for its counters.
+     */
+    GPSDatalogEngine &getDatalog(void) {
+        return _datalog;
+    }
+
+    /**
+     * @return the odometer, e.g. for its named trips.
+     */
+    GPSOdometer &getOdometer(void) {
+        return _odometer;
+    }
+
+    /**
+     * @return the frame the fixes are converted in, e.g. for its counters.
+     */
+    const GPSLocalFrame &getLocalFrame(void) const {
+        return _frame;
+    }
+
+    /**
+     * Sleep until the producer thread releases data or the capture ends.
+     * Returns immediately when no producer thread is running.
+     */
+    void waitForData(void);
+
+    /**
+     * @return true once the whole capture has been fed to the parser (or it
+     *     could not be opened).
+     */
+    bool isReplayDone(void) const;
+
+    /**
+     * @return the counters collected since the last reset().
+     */
+    const ReplayStats_t &getReplayStats(void) const;
+
+private:
+    enum {
+        READ_BUFFER_SIZE = 16384,
+        CHUNK_SIZE       = 512,
+        RING_SIZE        = 4096,
+        STAMP_RING_SIZE  = 2048,
+        /* upper bound on the chunks released by a single process() call */
+        CHUNKS_PER_PROCESS = 64
+    };
+
+    /* Release time of the ring bytes preceding endPosition; lets the
+     * consumer attribute a latency to each location update. */
+    struct ReleaseStamp_t {
+        uint32_t endPosition;
+        uint32_t reserved;
+        uint64_t releaseNs;
+    };
+
+    bool openCapture(void);
+    bool fillReadBuffer(void);
+    bool readNextChunk(void);
+    bool readRawChunk(void);
+    bool readTimestampedChunk(void);
+    uint64_t chunkReleaseNs(void);
+    bool releaseChunk(uint64_t releaseNs);
+    void releaseDueChunks(void);
+    void drain(void);
+    void emitLocation(uint32_t position);
+    void geofenceConfigured(gps_provider_error_t ret);
+    uint64_t captureNsFromSentence(const uint8_t *data, size_t len);
+    void stopProducerThread(void);
+    void producerLoop(void);
+
+    static void *producerThread(void *arg);
+    static uint64_t nowNs(void);
+
+    const char                          *_capturePath;
+    FILE                                *_file;
+    ReplayClock_t                       _clock;
+    double                              _speedup;
+    GPSProvider::PowerMode_t            _powerMode;
+
+    bool                                _running;
+    bool                                _done;
+    bool                                _timestamped;
+    uint64_t                            _startNs;       /* wall time matching _originNs */
+    uint64_t                            _pausedNs;      /* wall time of the last stop() */
+    uint64_t                            _runStartNs;    /* wall time of the last start() */
+    uint64_t                            _originNs;      /* capture time of the first chunk */
+    bool                                _haveOrigin;
+
+    uint8_t                             _readBuf[READ_BUFFER_SIZE];
+    size_t                              _readPos;
+    size_t                              _readLen;
+    uint32_t                            _recordRemaining;
+
+    uint8_t                             _chunk[CHUNK_SIZE];
+    size_t                              _chunkLen;
+    bool                                _chunkPending;
+    uint64_t                            _chunkCaptureNs;
+    uint64_t                            _captureNs;     /* running capture clock */
+    uint64_t                            _lastTodNs;
+
+    uint8_t                             _ringStorage[RING_SIZE];
+    GPSRingBuffer                       _ring;
+    uint8_t                             _stampStorage[STAMP_RING_SIZE];
+    GPSRingBuffer                       _stamps;
+    GPSRingBufferEvent                  _event;
+    uint32_t                            _producedPosition;
+    uint32_t                            _producerDone;  /* shared with the producer thread */
+    uint32_t                            _producerRun;   /* shared with the producer thread */
+    bool                                _useThread;
+    bool                                _threadStarted;
+    pthread_t                           _thread;
+
+    GPSNmeaParser                       _parser;
+    GPSGeofenceIndex                    _geofenceIndex;
+    GPSGeofenceEngine                   _geofences;
+    GPSGeofenceShadow                   _geofenceShadow;
+    unsigned                            _geofenceLimit;
+
+    GPSDatalogEngine                    _datalog;
+    const char                          *_datalogPath;
+    unsigned                            _datalogCapacity;
+
+    GPSOdometer                         _odometer;
+    GPSLocalFrame                       _frame;
+    GPSProcessStats                     _processStats;
+
+    ReplayStats_t                       _stats;
+};
+
+#endif /* __GPS_REPLAY_PROVIDER_H__ */
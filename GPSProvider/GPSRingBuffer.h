@@ -0,0 +1,276 @@
+/**
+ ******************************************************************************
+ * @file    GPSRingBuffer.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Lock-free single-producer/single-consumer byte ring.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+#ifndef __GPS_RING_BUFFER_H__
+#define __GPS_RING_BUFFER_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+/* Size of the coherency unit the producer and consumer indexes are kept
+ * apart by. */
+#ifndef GPS_RING_CACHE_LINE
+#define GPS_RING_CACHE_LINE 64
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define GPS_RING_LOAD_ACQUIRE(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define GPS_RING_STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define GPS_RING_FULL_BARRIER()      __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#elif defined(__CC_ARM)
+/* Single-core Cortex-M: aligned word accesses are atomic, DMB orders them. */
+#define GPS_RING_LOAD_ACQUIRE(p)     gpsRingLoadAcquire(p)
+#define GPS_RING_STORE_RELEASE(p, v) do { __dmb(0xF); *(volatile uint32_t *)(p) = (v); } while (0)
+#define GPS_RING_FULL_BARRIER()      __dmb(0xF)
+static __inline uint32_t gpsRingLoadAcquire(const uint32_t *p) {
+    uint32_t v = *(const volatile uint32_t *)p;
+    __dmb(0xF);
+    return v;
+}
+#else
+/* other toolchains (e.g. IAR): the mbed atomics, sequentially consistent */
+#include "mbed.h"
+#define GPS_RING_LOAD_ACQUIRE(p)     core_util_atomic_load_u32(p)
+#define GPS_RING_STORE_RELEASE(p, v) core_util_atomic_store_u32((p), (v))
+#define GPS_RING_FULL_BARRIER()      __DMB()
+#endif
+
+//
+// Byte ring between the UART ISR/DMA (producer) and process() (consumer).
+//
+//  ISR side:
+//      uint8_t *span;
+//      size_t room = ring.writeSpan(&span);  // contiguous free bytes
+//      ... DMA/UART fills span ...
+//      ring.commitWrite(filled);
+//  or simply ring.write(bytes, len) which drops what does not fit.
+//
+//  process() side:
+//      const uint8_t *span;
+//      size_t n;
+//      while ((n = ring.readSpan(&span)) > 0) {
+//          parser.parse(span, n);
+//          ring.consume(n);
+//      }
+//
+// The producer and consumer indexes live on distinct cache lines, each side
+// keeping a private copy of the other's index so the shared line is only
+// touched when the cached view runs out.
+//
+// Waiting: waitForData() lets process() sleep until the producer commits
+// data, without the lost-wakeup window described for sleep(): the Event
+// passed to setEvent() must latch a signal() issued before wait() (the
+// semantics of the ARM event register used by WFE/SEV).
+//
+
+class GPSRingBuffer {
+public:
+    /** Wakeup primitive shared by producer and consumer */
+    class Event {
+    public:
+        virtual ~Event() {}
+        /** Block until signal() was called; a pending signal returns at once. */
+        virtual void wait(void) = 0;
+        /** Release a current or future wait(). Callable from ISR context. */
+        virtual void signal(void) = 0;
+    };
+
+    /** Ring counters */
+    struct RingStats_t {
+        uint32_t bytesWritten;   /**< bytes committed by the producer */
+        uint32_t bytesRead;      /**< bytes consumed */
+        uint32_t overrunBytes;   /**< bytes dropped because the ring was full */
+        uint32_t overrunEvents;  /**< write()/reportOverrun() calls that dropped data */
+        uint32_t highWater;      /**< maximum fill level observed by the producer */
+    };
+
+    /**
+     * Construct a ring over caller-provided storage.
+     *
+     * @param storage  the byte storage.
+     * @param capacity size of storage; must be a power of two.
+     */
+    GPSRingBuffer(uint8_t *storage, size_t capacity);
+
+    /**
+     * @return true if the storage/capacity pair given to the constructor is usable.
+     */
+    bool isValid(void) const {
+        return (_storage != NULL) && (_mask != 0);
+    }
+
+    size_t capacity(void) const {
+        return (size_t)_mask + 1;
+    }
+
+    /* -- producer side (ISR/DMA) -- */
+
+    /**
+     * Copy bytes into the ring. Bytes that do not fit are dropped and
+     * accounted as an overrun.
+     *
+     * @return the number of bytes written.
+     */
+    size_t write(const uint8_t *data, size_t len);
+
+    /**
+     * @return the contiguous free region at the write position (possibly
+     *     shorter than the total free space when it wraps).
+     */
+    size_t writeSpan(uint8_t **span);
+
+    /**
+     * Publish len bytes previously filled through writeSpan().
+     */
+    void commitWrite(size_t len);
+
+    /**
+     * Account for bytes lost upstream of the ring (e.g. UART overrun flag).
+     */
+    void reportOverrun(size_t len);
+
+    /**
+     * @return free space as seen by the producer.
+     */
+    size_t space(void) const;
+
+    /* -- consumer side (process()) -- */
+
+    /**
+     * @return the contiguous readable region at the read position.
+     */
+    size_t readSpan(const uint8_t **span);
+
+    /**
+     * Release len bytes obtained through readSpan().
+     */
+    void consume(size_t len);
+
+    /**
+     * @return bytes available to the consumer.
+     */
+    size_t available(void) const;
+
+    /**
+     * @return total bytes consumed so far (free-running, wraps at 2^32).
+     */
+    uint32_t readPosition(void) const {
+        return _tail;
+    }
+
+    /**
+     * Set the wakeup primitive used by waitForData(); NULL disables waiting.
+     */
+    void setEvent(Event *event) {
+        _event = event;
+    }
+
+    /**
+     * Sleep on the event until the ring holds data.
+     *
+     * @return false if no event is set and the ring is empty.
+     */
+    bool waitForData(void);
+
+    /**
+     * Wake up the consumer without writing, e.g. on end of stream.
+     */
+    void wakeup(void);
+
+    /**
+     * Fill stats with a snapshot of the counters.
+     */
+    void getStats(RingStats_t &stats) const;
+
+    /**
+     * Empty the ring and clear the counters. Neither side may be active.
+     */
+    void reset(void);
+
+private:
+    void notifyConsumer(void);
+
+    uint8_t                *_storage;
+    uint32_t               _mask;
+    Event                  *_event;
+
+    /* producer-owned line */
+    char                   _padProducer[GPS_RING_CACHE_LINE];
+    uint32_t               _head;
+    uint32_t               _cachedTail;
+    uint32_t               _bytesWritten;
+    uint32_t               _overrunBytes;
+    uint32_t               _overrunEvents;
+    uint32_t               _highWater;
+
+    /* consumer-owned line */
+    char                   _padConsumer[GPS_RING_CACHE_LINE];
+    uint32_t               _tail;
+    uint32_t               _cachedHead;
+    uint32_t               _bytesRead;
+    uint32_t               _waiting;
+
+    char                   _padEnd[GPS_RING_CACHE_LINE];
+
+    /* disallow copy constructor and assignment operators */
+    GPSRingBuffer(const GPSRingBuffer&);
+    GPSRingBuffer & operator= (const GPSRingBuffer&);
+};
+
+/**
+ * Default Event: WFE/SEV on target, a latched condition variable on Linux
+ * (where the producer is a thread standing in for the ISR).
+ */
+class GPSRingBufferEvent : public GPSRingBuffer::Event {
+public:
+    GPSRingBufferEvent();
+    virtual ~GPSRingBufferEvent();
+    virtual void wait(void);
+    virtual void signal(void);
+
+private:
+#if defined(__linux__)
+    pthread_mutex_t        _mutex;
+    pthread_cond_t         _cond;
+    bool                   _pending;
+#endif
+};
+
+#endif /* __GPS_RING_BUFFER_H__ */
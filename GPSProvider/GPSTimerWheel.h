@@ -0,0 +1,143 @@
+/**
+ ******************************************************************************
+ * @file    GPSTimerWheel.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Hierarchical timer wheel.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_TIMER_WHEEL_H__
+#define __GPS_TIMER_WHEEL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+//
+// Hierarchical timer wheel: LEVELS wheels of SLOTS buckets, each level
+// SLOTS times coarser than the one below. Starting or cancelling a timer is
+// O(1) and so is each tick, whatever the number of armed timers; timers
+// cascade to a finer wheel as their expiry approaches.
+//
+// Timers are caller-owned (typically embedded in the object they time):
+//
+//      GPSTimerWheel::Timer_t timer;
+//      GPSTimerWheel::init(timer, onTimeout, context);
+//      wheel.start(timer, 5000);
+//      ...
+//      wheel.advance(nowMs);   // from the application loop
+//
+// Callbacks run from advance() and may start or cancel any timer.
+//
+
+class GPSTimerWheel {
+public:
+    static const unsigned LEVEL_BITS = 6;
+    static const unsigned SLOTS = 1U << LEVEL_BITS;
+    static const unsigned LEVELS = 4;
+
+    typedef void (* TimerCallback_t)(void *context);
+
+    struct Timer_t {
+        Timer_t         *next;
+        Timer_t         *prev;
+        Timer_t         **head;    /* bucket holding the timer, NULL if idle */
+        uint32_t        expiry;    /* absolute tick */
+        TimerCallback_t callback;
+        void            *context;
+    };
+
+    /**
+     * @param tickMs resolution of the wheel in milliseconds.
+     */
+    explicit GPSTimerWheel(uint32_t tickMs = 100);
+
+    static void init(Timer_t &timer, TimerCallback_t callback, void *context) {
+        timer.next = timer.prev = NULL;
+        timer.head = NULL;
+        timer.expiry = 0;
+        timer.callback = callback;
+        timer.context = context;
+    }
+
+    static bool isArmed(const Timer_t &timer) {
+        return (timer.head != NULL);
+    }
+
+    /**
+     * (Re)arm timer to fire delayMs after the current wheel time (rounded
+     * up to the next tick).
+     */
+    void start(Timer_t &timer, uint32_t delayMs);
+
+    /**
+     * Disarm timer; no-op if idle.
+     */
+    void cancel(Timer_t &timer);
+
+    /**
+     * Move the wheel to nowMs (monotonic), running the callbacks of the
+     * timers that expired.
+     *
+     * @return the number of callbacks run.
+     */
+    unsigned advance(uint64_t nowMs);
+
+    /**
+     * @return the wheel time in milliseconds.
+     */
+    uint64_t now(void) const {
+        return _originMs + (uint64_t)_tick * _tickMs;
+    }
+
+    unsigned getArmedCount(void) const {
+        return _armed;
+    }
+
+protected:
+    void insert(Timer_t &timer);
+    void cascade(unsigned level);
+
+    Timer_t                 *_wheel[LEVELS][SLOTS];
+    uint32_t                _tickMs;
+    uint32_t                _tick;
+    uint64_t                _originMs;
+    bool                    _started;
+    unsigned                _armed;
+
+private:
+    /* disallow copy constructor and assignment operators */
+    GPSTimerWheel(const GPSTimerWheel&);
+    GPSTimerWheel & operator= (const GPSTimerWheel&);
+};
+
+#endif /* __GPS_TIMER_WHEEL_H__ */
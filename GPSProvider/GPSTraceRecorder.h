@@ -0,0 +1,287 @@
+/**
+ ******************************************************************************
+ * @file    GPSTraceRecorder.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Lock-free event trace of the GPS pipeline stages.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_TRACE_RECORDER_H__
+#define __GPS_TRACE_RECORDER_H__
+
+//
+// Flight recorder of the pipeline stages, to see what one process() call
+// spent its time on. The stages are timed where they run when the library
+// is built with GPS_TRACE defined, and recorded into the active recorder,
+// if any. Without GPS_TRACE the hooks compile to nothing and the recorder
+// itself does not exist:
+//
+//      static GPSTraceRecorder::TraceEvent_t events[16384];
+//      GPSTraceRecorder trace(events, 16384);
+//      GPSTraceRecorder::setActive(&trace);
+//      ... replay ...
+//      GPSTraceRecorder::setActive(NULL);
+//      trace.writeChromeJson("session.json");   /* open in Perfetto */
+//
+// Recording is lock-free and safe from the ISR: a writer claims a slot with
+// an atomic increment and publishes it with a release store of its
+// sequence number. The oldest events are overwritten when the storage is
+// full. Timestamps come from GPS_TRACE_CLOCK_NS(): CLOCK_MONOTONIC on
+// Linux, the mbed microsecond ticker elsewhere unless the target defines
+// it (e.g. from the DWT cycle counter).
+//
+// writeChromeJson() (Linux) writes the Chrome trace-event format: stages
+// are complete ("X") or instant ("i") events, the receive side on a thread
+// of its own.
+//
+// The hooks cost little while no recorder is active and noticeably more
+// while recording; test/benchmark times both on a replay
+// (replay.instrumented and replay.instrumented.traced).
+//
+
+#if defined(GPS_TRACE)
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define GPS_TRACE_FETCH_ADD(p)       __atomic_fetch_add((p), 1U, __ATOMIC_RELAXED)
+#define GPS_TRACE_LOAD_ACQUIRE(p)    __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define GPS_TRACE_STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define GPS_TRACE_ACQUIRE_FENCE()    __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define GPS_TRACE_RELEASE_FENCE()    __atomic_thread_fence(__ATOMIC_RELEASE)
+#elif defined(__CC_ARM)
+#define GPS_TRACE_FETCH_ADD(p)       gpsTraceFetchAdd(p)
+#define GPS_TRACE_LOAD_ACQUIRE(p)    gpsTraceLoadAcquire(p)
+#define GPS_TRACE_STORE_RELEASE(p, v) do { __dmb(0xF); *(volatile uint32_t *)(p) = (v); } while (0)
+#define GPS_TRACE_ACQUIRE_FENCE()    __dmb(0xF)
+#define GPS_TRACE_RELEASE_FENCE()    __dmb(0xF)
+static __inline uint32_t gpsTraceFetchAdd(uint32_t *p) {
+    uint32_t v;
+    do {
+        v = __ldrex(p);
+    } while (__strex(v + 1, p) != 0);
+    return v;
+}
+static __inline uint32_t gpsTraceLoadAcquire(const uint32_t *p) {
+    uint32_t v = *(const volatile uint32_t *)p;
+    __dmb(0xF);
+    return v;
+}
+#else
+/* other toolchains (e.g. IAR): the claim goes through an mbed critical
+ * section, the rest are single word accesses ordered by DMB */
+#include "mbed.h"
+#define GPS_TRACE_FETCH_ADD(p)       gpsTraceFetchAdd(p)
+#define GPS_TRACE_LOAD_ACQUIRE(p)    gpsTraceLoadAcquire(p)
+#define GPS_TRACE_STORE_RELEASE(p, v) do { __DMB(); *(volatile uint32_t *)(p) = (v); } while (0)
+#define GPS_TRACE_ACQUIRE_FENCE()    __DMB()
+#define GPS_TRACE_RELEASE_FENCE()    __DMB()
+static inline uint32_t gpsTraceFetchAdd(uint32_t *p) {
+    core_util_critical_section_enter();
+    uint32_t v = *(volatile uint32_t *)p;
+    *(volatile uint32_t *)p = v + 1;
+    core_util_critical_section_exit();
+    return v;
+}
+static inline uint32_t gpsTraceLoadAcquire(const uint32_t *p) {
+    uint32_t v = *(const volatile uint32_t *)p;
+    __DMB();
+    return v;
+}
+#endif
+
+#if !defined(GPS_TRACE_CLOCK_NS)
+#if defined(__linux__)
+#define GPS_TRACE_CLOCK_NS()         GPSTraceRecorder::monotonicNs()
+#else
+/* the mbed microsecond ticker, unless the target brings a finer clock */
+#include "mbed.h"
+#define GPS_TRACE_CLOCK_NS()         ((uint64_t)us_ticker_read() * 1000U)
+#endif
+#endif
+
+class GPSTraceRecorder {
+public:
+    /** Pipeline stages */
+    enum Stage_t {
+        TRACE_RX,           /**< bytes received (instant, arg: byte count) */
+        TRACE_PROCESS,      /**< GPSProvider::process() */
+        TRACE_PARSE,        /**< parser run over a span (arg: bytes consumed) */
+        TRACE_SENTENCE,     /**< sentence complete (instant, arg: type, e.g. 'GGA') */
+        TRACE_LOCATION_CB,  /**< onLocationUpdate callback */
+        TRACE_GEOFENCE,     /**< geofence evaluation of a fix */
+        TRACE_GEOFENCE_CB,  /**< geofence status callback (arg: idAlarm) */
+        TRACE_DATALOG,      /**< datalog of a fix */
+        TRACE_DATALOG_CB,   /**< log status/query callback */
+        TRACE_ODOMETER,     /**< odometer update of a fix */
+        TRACE_ODO_CB,       /**< odometer callback */
+        TRACE_STAGES
+    };
+
+    /** A recorded event */
+    struct TraceEvent_t {
+        uint64_t timestampNs;
+        uint32_t durationNs;   /**< 0 for instant events */
+        uint32_t arg;
+        uint16_t stage;        /**< Stage_t */
+        uint16_t instant;
+        uint32_t sequence;     /**< claim index + 1 once written */
+    };
+
+    /**
+     * Construct a recorder over caller-provided storage.
+     *
+     * @param capacity number of events; must be a power of two.
+     */
+    GPSTraceRecorder(TraceEvent_t *storage, unsigned capacity);
+
+    bool isValid(void) const {
+        return (_events != NULL) && (_mask != 0);
+    }
+
+    /**
+     * Route the GPS_TRACE hooks to recorder (NULL: nowhere).
+     */
+    static void setActive(GPSTraceRecorder *recorder) {
+        GPS_TRACE_STORE_RELEASE(&_activeSlot, (uintptr_t)recorder);
+    }
+
+    static GPSTraceRecorder *getActive(void) {
+        return (GPSTraceRecorder *)GPS_TRACE_LOAD_ACQUIRE(&_activeSlot);
+    }
+
+    /**
+     * Record an event ending now.
+     */
+    void record(Stage_t stage, uint64_t startNs, uint64_t endNs, uint32_t arg, bool instant);
+
+    /**
+     * @return the number of events recorded since clear(), overwritten
+     *     ones included.
+     */
+    uint32_t getTotal(void) const {
+        return GPS_TRACE_LOAD_ACQUIRE(&_next);
+    }
+
+    /**
+     * @return the number of events held (at most the capacity).
+     */
+    unsigned getCount(void) const;
+
+    /**
+     * Copy the index-th oldest event held.
+     *
+     * @return false if index is out of range or the slot is being written.
+     */
+    bool getEvent(unsigned index, TraceEvent_t &event) const;
+
+    /**
+     * Drop every event; no writer may be active.
+     */
+    void clear(void);
+
+    static const char *getStageName(Stage_t stage);
+
+    /**
+     * Write the events held as Chrome trace-event JSON (Linux only).
+     *
+     * @return the number of events written, -1 on error.
+     */
+    int writeChromeJson(const char *path) const;
+
+    static uint64_t monotonicNs(void);
+
+private:
+    TraceEvent_t            *_events;
+    uint32_t                _mask;
+    uint32_t                _next;
+
+    static uintptr_t        _activeSlot;
+
+    /* disallow copy constructor and assignment operators */
+    GPSTraceRecorder(const GPSTraceRecorder&);
+    GPSTraceRecorder & operator= (const GPSTraceRecorder&);
+};
+
+/**
+ * Times the enclosing scope as a complete event of the active recorder.
+ */
+class GPSTraceScope {
+public:
+    GPSTraceScope(GPSTraceRecorder::Stage_t stage, uint32_t arg) :
+        _recorder(GPSTraceRecorder::getActive()),
+        _stage(stage),
+        _arg(arg),
+        _startNs((_recorder != NULL) ? GPS_TRACE_CLOCK_NS() : 0) {}
+
+    ~GPSTraceScope() {
+        if (_recorder != NULL) {
+            _recorder->record(_stage, _startNs, GPS_TRACE_CLOCK_NS(), _arg, false);
+        }
+    }
+
+    void setArg(uint32_t arg) {
+        _arg = arg;
+    }
+
+private:
+    GPSTraceRecorder            *_recorder;
+    GPSTraceRecorder::Stage_t   _stage;
+    uint32_t                    _arg;
+    uint64_t                    _startNs;
+
+    /* disallow copy constructor and assignment operators */
+    GPSTraceScope(const GPSTraceScope&);
+    GPSTraceScope & operator= (const GPSTraceScope&);
+};
+
+static inline void gpsTraceInstant(GPSTraceRecorder::Stage_t stage, uint32_t arg) {
+    GPSTraceRecorder *recorder = GPSTraceRecorder::getActive();
+    if (recorder != NULL) {
+        uint64_t now = GPS_TRACE_CLOCK_NS();
+        recorder->record(stage, now, now, arg, true);
+    }
+}
+
+#define GPS_TRACE_SCOPE(stage, arg)   GPSTraceScope gpsTraceScope(GPSTraceRecorder::stage, (arg))
+#define GPS_TRACE_SCOPE_ARG(arg)      gpsTraceScope.setArg(arg)
+#define GPS_TRACE_INSTANT(stage, arg) gpsTraceInstant(GPSTraceRecorder::stage, (arg))
+
+#else /* !GPS_TRACE */
+#define GPS_TRACE_SCOPE(stage, arg)   do { } while (0)
+#define GPS_TRACE_SCOPE_ARG(arg)      do { } while (0)
+#define GPS_TRACE_INSTANT(stage, arg) do { } while (0)
+#endif /* GPS_TRACE */
+
+#endif /* __GPS_TRACE_RECORDER_H__ */
@@ -0,0 +1,176 @@
+/**
+ ******************************************************************************
+ * @file    GPSTrackSimplifier.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Online trajectory simplification of location updates.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_TRACK_SIMPLIFIER_H__
+#define __GPS_TRACK_SIMPLIFIER_H__
+
+#include <stdint.h>
+#include "GPSProviderCommon.h"
+#include "GPSProvider.h"
+#include "GPSLocalFrame.h"
+
+//
+// Online simplification of the location stream, between the location
+// callback and the sinks (datalog, uplink) that only need the shape of the
+// track:
+//
+//      GPSTrackSimplifier simplifier(5.0);     /* meters */
+//      simplifier.onPoint(logPoint);           /* datalog.logFix(), ... */
+//      ...
+//      /* from the location callback */
+//      simplifier.update(*newLocation);
+//      ...
+//      simplifier.flush();                     /* end of the track */
+//
+// Opening window: the last emitted fix is the anchor, and the window holds
+// the fixes received since. A new fix extends the window as long as the
+// segment from the anchor to it passes within the tolerance of every fix
+// in the window; otherwise the previous fix is emitted and becomes the
+// anchor. Dropping the fixes in between therefore never moves the track by
+// more than the tolerance, and a fix is emitted one update late, when the
+// next one shows it is needed.
+//
+// The window is bounded (a full window emits its last fix), and so is the
+// time between emitted fixes with setMaxInterval(). An invalid fix emits
+// the pending one and is not forwarded; the next valid fix is emitted as
+// soon as it arrives.
+//
+
+class GPSTrackSimplifier {
+public:
+    /** Simplifier counters */
+    struct SimplifierStats_t {
+        uint32_t fixes;       /**< valid fixes received */
+        uint32_t invalid;     /**< invalid fixes received */
+        uint32_t emitted;     /**< fixes forwarded */
+        uint32_t forced;      /**< of which for a full window or the max interval */
+    };
+
+    /**
+     * @param tolerance largest distance (meters) between a dropped fix and
+     *     the simplified track.
+     * @param window    fixes held at most between two emitted ones.
+     */
+    explicit GPSTrackSimplifier(double tolerance = 5.0, unsigned window = 64);
+    virtual ~GPSTrackSimplifier();
+
+    /**
+     * @return false if the window could not be allocated; every fix is then
+     *     forwarded.
+     */
+    bool isValid(void) const {
+        return _window != 0;
+    }
+
+    void setTolerance(double tolerance) {
+        _tolerance2 = (tolerance > 0.0) ? tolerance * tolerance : 0.0;
+    }
+
+    /**
+     * Emit a fix at least every maxInterval ms of the track (0: no limit).
+     */
+    void setMaxInterval(uint32_t maxInterval) {
+        _maxInterval = maxInterval;
+    }
+
+    /**
+     * Setup the callback receiving the retained fixes.
+     */
+    void onPoint(GPSProvider::LocationUpdateCallback_t callback) {
+        _pointCallback = callback;
+    }
+
+    /**
+     * Offer a new fix.
+     *
+     * @return true if a fix was emitted.
+     */
+    bool update(const GPSProvider::LocationUpdateParams_t &location);
+
+    /**
+     * Same as update(location), with location already converted by a
+     * shared frame.
+     */
+    bool update(const GPSProvider::LocationUpdateParams_t &location, const GPSLocalFrame::Point_t &point);
+
+    /**
+     * Emit the pending fix, if any, e.g. before stopping the datalog.
+     */
+    void flush(void);
+
+    /**
+     * Drop the window and the anchor without emitting; counters are kept.
+     */
+    void reset(void);
+
+    void getStats(SimplifierStats_t &stats) const {
+        stats = _stats;
+    }
+
+private:
+    void emitPending(bool forced);
+    void toAnchor(const GPSLocalFrame::Point_t &point, double &x, double &y) const;
+    bool fits(double x, double y) const;
+
+    double                                  _tolerance2;
+    uint32_t                                _maxInterval;
+    unsigned                                _window;
+    unsigned                                _count;     /* fixes held in _x/_y */
+    double                                  *_x;        /* meters east of the anchor */
+    double                                  *_y;        /* meters north of the anchor */
+
+    bool                                    _haveAnchor;
+    GPSLocalFrame::Point_t                  _anchor;
+    uint64_t                                _anchorTime;
+
+    bool                                    _havePending;
+    GPSProvider::LocationUpdateParams_t     _pending;   /* newest fix, not emitted yet */
+    GPSLocalFrame::Point_t                  _pendingPoint;
+    double                                  _pendingX;
+    double                                  _pendingY;
+
+    GPSLocalFrame                           _frame;
+    GPSProvider::LocationUpdateCallback_t   _pointCallback;
+    SimplifierStats_t                       _stats;
+
+    /* disallow copy constructor and assignment operators */
+    GPSTrackSimplifier(const GPSTrackSimplifier&);
+    GPSTrackSimplifier & operator= (const GPSTrackSimplifier&);
+};
+
+#endif /* __GPS_TRACK_SIMPLIFIER_H__ */
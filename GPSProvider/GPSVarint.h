@@ -0,0 +1,131 @@
+/**
+ ******************************************************************************
+ * @file    GPSVarint.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Zig-zag and LEB128 variable-length integer coding.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_VARINT_H__
+#define __GPS_VARINT_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+//
+// Little-endian base 128 integers (7 bits per byte, high bit set on every
+// byte but the last) and zig-zag mapping of signed values, so that small
+// deltas of either sign take a single byte.
+//
+// Writers assume room for MAX_BYTES; readers are bounded by the bytes
+// available and return 0 on a truncated or overlong value.
+//
+
+class GPSVarint {
+public:
+    static const unsigned MAX_BYTES32 = 5;
+    static const unsigned MAX_BYTES = 10;
+
+    static uint32_t zigzag32(int32_t value) {
+        return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    }
+
+    static int32_t unzigzag32(uint32_t value) {
+        return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+    }
+
+    static uint64_t zigzag64(int64_t value) {
+        return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    }
+
+    static int64_t unzigzag64(uint64_t value) {
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }
+
+    /**
+     * @return the number of bytes written at out.
+     */
+    static unsigned put32(uint8_t *out, uint32_t value) {
+        unsigned n = 0;
+        while (value >= 0x80) {
+            out[n++] = (uint8_t)(value | 0x80);
+            value >>= 7;
+        }
+        out[n++] = (uint8_t)value;
+        return n;
+    }
+
+    static unsigned put64(uint8_t *out, uint64_t value) {
+        unsigned n = 0;
+        while (value >= 0x80) {
+            out[n++] = (uint8_t)(value | 0x80);
+            value >>= 7;
+        }
+        out[n++] = (uint8_t)value;
+        return n;
+    }
+
+    /**
+     * @return the number of bytes read, 0 on error.
+     */
+    static unsigned get32(const uint8_t *in, size_t avail, uint32_t &value) {
+        if ((avail > 0) && (in[0] < 0x80)) {
+            /* single byte: the common case for deltas */
+            value = in[0];
+            return 1;
+        }
+        uint32_t result = 0;
+        for (unsigned n = 0; (n < avail) && (n < MAX_BYTES32); n++) {
+            result |= (uint32_t)(in[n] & 0x7F) << (7 * n);
+            if (in[n] < 0x80) {
+                value = result;
+                return n + 1;
+            }
+        }
+        return 0;
+    }
+
+    static unsigned get64(const uint8_t *in, size_t avail, uint64_t &value) {
+        uint64_t result = 0;
+        for (unsigned n = 0; (n < avail) && (n < MAX_BYTES); n++) {
+            result |= (uint64_t)(in[n] & 0x7F) << (7 * n);
+            if (in[n] < 0x80) {
+                value = result;
+                return n + 1;
+            }
+        }
+        return 0;
+    }
+};
+
+#endif /* __GPS_VARINT_H__ */
@@ -0,0 +1,240 @@
+/**
+ ******************************************************************************
+ * @file    GPSWireCodec.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Compact delta encoding of location streams for uplink.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_WIRE_CODEC_H__
+#define __GPS_WIRE_CODEC_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "GPSProvider.h"
+
+//
+// Wire format for forwarding location updates over a metered link. The
+// encoder runs on the device, the decoder on the receiving side:
+//
+//      uint8_t frame[GPSWireEncoder::MAX_FRAME_SIZE];
+//      size_t n = encoder.encode(*newLocation, frame, sizeof(frame));
+//      ... send n bytes ...
+//
+//      while (len > 0) {
+//          n = decoder.decode(data, len);
+//          if (n == 0) {
+//              break;      /* partial frame: wait for more bytes */
+//          }
+//          data += n;
+//          len -= n;
+//          if (decoder.takeLocation()) {
+//              handleLocation(decoder.getLocation());
+//          }
+//      }
+//
+// Coordinates are quantized to a multiple of coordStep (1e-7 degree units)
+// and the altitude to a multiple of altitudeStep (cm); the encoder deltas
+// against the quantized previous fix, so the error never accumulates.
+//
+// Keyframe (every keyframeInterval fixes, on the first one and on demand):
+//
+//      0xB5 marker, tag, varint coordStep, varint altitudeStep,
+//      varint64 UTC time (ms), zig-zag lat, lon, altitude (quanta),
+//      varint numGPSSVs, numGLOSVs, uint16 CRC-16/CCITT-FALSE
+//
+// Delta frame:
+//
+//      tag, zig-zag varint64 time delta of delta (ms),
+//      [zig-zag lat, lon delta (quanta)]   if TAG_VALID
+//      [zig-zag altitude delta (quanta)]   if TAG_ALTITUDE
+//      [varint numGPSSVs, numGLOSVs]       if TAG_SATELLITES
+//
+// The tag carries a 4 bit frame sequence, so the decoder notices lost
+// frames (but for gaps of a multiple of 16): it then drops deltas until the
+// next keyframe, which it also scans the stream for after a malformed frame.
+// Decoding state is a few words, whatever the stream. Delta frames carry
+// no checksum: the link must deliver bytes intact or not at all.
+//
+// A 1 Hz vehicle track takes about 4 bytes per fix with the defaults.
+// version is not sent and gpsTime is derived from the UTC time.
+//
+
+class GPSWireEncoder {
+public:
+    /** Longest frame encode() produces. */
+    static const unsigned MAX_FRAME_SIZE = 49;
+
+    /** Coarsest coordinate quantum (one degree). */
+    static const uint32_t MAX_COORD_STEP = 10000000;
+
+    /** Encoder counters */
+    struct WireEncoderStats_t {
+        uint32_t fixes;          /**< frames produced */
+        uint32_t keyframes;      /**< of which keyframes */
+        uint64_t bytes;          /**< total frame bytes */
+    };
+
+    /**
+     * @param coordStep        coordinate quantum, 1e-7 degree units
+     *                         (10: about 11 cm of latitude).
+     * @param altitudeStep     altitude quantum, cm.
+     * @param keyframeInterval fixes between keyframes (at least 1).
+     */
+    GPSWireEncoder(uint32_t coordStep = 10, uint32_t altitudeStep = 10, unsigned keyframeInterval = 60);
+
+    /**
+     * Encode a location update.
+     *
+     * @return the frame length, 0 if capacity is below MAX_FRAME_SIZE.
+     */
+    size_t encode(const GPSProvider::LocationUpdateParams_t &location, uint8_t *out, size_t capacity);
+
+    /**
+     * Make the next frame a keyframe, e.g. after the link was re-established.
+     */
+    void requestKeyframe(void) {
+        _sinceKeyframe = _keyframeInterval;
+    }
+
+    /**
+     * Forget the previous fix (the next frame is a keyframe) and clear the
+     * counters.
+     */
+    void reset(void);
+
+    const WireEncoderStats_t &getStats(void) const {
+        return _stats;
+    }
+
+private:
+    uint32_t               _coordStep;
+    uint32_t               _altitudeStep;
+    unsigned               _keyframeInterval;
+    unsigned               _sinceKeyframe;
+    uint8_t                _seq;
+
+    uint64_t               _time;
+    int64_t                _timeDelta;
+    int32_t                _lat;
+    int32_t                _lon;
+    int32_t                _alt;
+    unsigned               _numGPSSVs;
+    unsigned               _numGLOSVs;
+
+    WireEncoderStats_t     _stats;
+
+    /* disallow copy constructor and assignment operators */
+    GPSWireEncoder(const GPSWireEncoder&);
+    GPSWireEncoder & operator= (const GPSWireEncoder&);
+};
+
+class GPSWireDecoder {
+public:
+    /** Decoder counters */
+    struct WireDecoderStats_t {
+        uint32_t keyframes;      /**< keyframes decoded */
+        uint32_t deltas;         /**< delta frames decoded */
+        uint32_t skippedFrames;  /**< delta frames dropped while out of sync */
+        uint32_t badFrames;      /**< malformed frames and keyframe CRC errors */
+        uint32_t skippedBytes;   /**< bytes discarded looking for a keyframe */
+        uint32_t lostSync;       /**< sequence gaps and malformed frames */
+    };
+
+    GPSWireDecoder();
+
+    /**
+     * Drop the decoding state; the next location comes from a keyframe.
+     */
+    void reset(void);
+
+    /**
+     * Consume at most one frame.
+     *
+     * @return the number of bytes consumed; 0 if data holds only part of a
+     *     frame (at most GPSWireEncoder::MAX_FRAME_SIZE bytes are needed).
+     */
+    size_t decode(const uint8_t *data, size_t len);
+
+    /**
+     * @return true if a location was decoded since the previous call; the
+     *     pending flag is cleared.
+     */
+    bool takeLocation(void) {
+        bool decoded = _locationDecoded;
+        _locationDecoded = false;
+        return decoded;
+    }
+
+    const GPSProvider::LocationUpdateParams_t &getLocation(void) const {
+        return _location;
+    }
+
+    /**
+     * @return true if delta frames are being applied.
+     */
+    bool isSynced(void) const {
+        return _synced;
+    }
+
+    const WireDecoderStats_t &getStats(void) const {
+        return _stats;
+    }
+
+private:
+    size_t decodeKeyframe(const uint8_t *data, size_t len);
+    size_t decodeDelta(const uint8_t *data, size_t len);
+    void publish(void);
+    size_t loseSync(void);
+
+    bool                                _synced;
+    bool                                _locationDecoded;
+    uint8_t                             _seq;
+    uint32_t                            _coordStep;
+    uint32_t                            _altitudeStep;
+
+    uint64_t                            _time;
+    int64_t                             _timeDelta;
+    int32_t                             _lat;
+    int32_t                             _lon;
+    int32_t                             _alt;
+
+    GPSProvider::LocationUpdateParams_t _location;
+    WireDecoderStats_t                  _stats;
+
+    /* disallow copy constructor and assignment operators */
+    GPSWireDecoder(const GPSWireDecoder&);
+    GPSWireDecoder & operator= (const GPSWireDecoder&);
+};
+
+#endif /* __GPS_WIRE_CODEC_H__ */
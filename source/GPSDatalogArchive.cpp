@@ -0,0 +1,510 @@
+/**
+ ******************************************************************************
+ * @file    GPSDatalogArchive.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Exported datalog archives, memory-mapped for reading.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "GPSDatalogArchive.h"
+#include "GPSDatalogEngine.h"
+#include "GPSProviderUtils.h"
+
+static const char ARCHIVE_MAGIC[8] = { 'G', 'P', 'S', 'A', 'R', 'C', '0', '1' };
+static const unsigned RECORD_SIZE = 32;
+
+static uint16_t
+crc16(const uint8_t *data, unsigned len)
+{
+    /* CRC-16/CCITT-FALSE, as for the datalog store */
+    uint16_t crc = 0xFFFF;
+    for (unsigned i = 0; i < len; i++) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (unsigned bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void
+put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void
+put32(uint8_t *p, uint32_t v)
+{
+    put16(p, (uint16_t)v);
+    put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static void
+put64(uint8_t *p, uint64_t v)
+{
+    put32(p, (uint32_t)v);
+    put32(p + 4, (uint32_t)(v >> 32));
+}
+
+/* only the Linux open() parses an archive header */
+#if defined(__linux__)
+static uint16_t
+get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t
+get32(const uint8_t *p)
+{
+    return (uint32_t)get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+static uint64_t
+get64(const uint8_t *p)
+{
+    return (uint64_t)get32(p) | ((uint64_t)get32(p + 4) << 32);
+}
+#endif /* __linux__ */
+
+static int64_t
+toFixed(double value, double scale)
+{
+    return (int64_t)floor(value * scale + 0.5);
+}
+
+/*
+ * Reader
+ */
+
+GPSDatalogArchive::GPSDatalogArchive() :
+    _map(NULL),
+    _mapSize(0),
+    _records(NULL),
+    _index(NULL),
+    _count(0),
+    _stride(0),
+    _indexCount(0),
+    _firstUtcMs(0),
+    _lastUtcMs(0)
+{
+    /* empty */
+}
+
+GPSDatalogArchive::~GPSDatalogArchive()
+{
+    close();
+}
+
+#if defined(__linux__)
+
+gps_provider_error_t
+GPSDatalogArchive::open(const char *path)
+{
+    close();
+
+    /* records are used in place: the file layout must be the host one */
+    const uint16_t probe = 1;
+    if ((*(const uint8_t *)&probe != 1) || (sizeof(Record_t) != RECORD_SIZE)) {
+        return GPS_ERROR_LOG_NOT_IMPLEMENTED;
+    }
+
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return GPS_ERROR_DATALOG_CFG;
+    }
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || ((uint64_t)st.st_size < HEADER_SIZE)) {
+        ::close(fd);
+        return GPS_ERROR_DATALOG_CFG;
+    }
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        return GPS_ERROR_DATALOG_CFG;
+    }
+
+    const uint8_t *header = (const uint8_t *)map;
+    uint64_t count = get64(&header[16]);
+    uint64_t indexOffset = get64(&header[24]);
+    uint32_t stride = get32(&header[32]);
+    uint32_t indexCount = get32(&header[36]);
+    bool valid = (memcmp(header, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) == 0) &&
+                 (get16(&header[60]) == crc16(header, 60)) &&
+                 (get32(&header[8]) == HEADER_SIZE) &&
+                 (get32(&header[12]) == RECORD_SIZE) &&
+                 (stride > 0) &&
+                 (count <= (size - HEADER_SIZE) / RECORD_SIZE) &&
+                 (indexOffset == HEADER_SIZE + count * RECORD_SIZE) &&
+                 (indexCount == (count + stride - 1) / stride) &&
+                 ((size - indexOffset) / sizeof(uint64_t) >= indexCount);
+    if (!valid) {
+        munmap(map, size);
+        return GPS_ERROR_DATALOG_CFG;
+    }
+
+    _map = map;
+    _mapSize = size;
+    _records = (const Record_t *)(header + HEADER_SIZE);
+    _index = (const uint64_t *)(header + indexOffset);
+    _count = count;
+    _stride = stride;
+    _indexCount = indexCount;
+    _firstUtcMs = get64(&header[40]);
+    _lastUtcMs = get64(&header[48]);
+    return GPS_ERROR_NONE;
+}
+
+void
+GPSDatalogArchive::close(void)
+{
+    if (_map != NULL) {
+        munmap(_map, _mapSize);
+    }
+    _map = NULL;
+    _mapSize = 0;
+    _records = NULL;
+    _index = NULL;
+    _count = 0;
+    _stride = 0;
+    _indexCount = 0;
+    _firstUtcMs = 0;
+    _lastUtcMs = 0;
+}
+
+#else
+
+gps_provider_error_t
+GPSDatalogArchive::open(const char *path)
+{
+    (void)path;
+    return GPS_ERROR_LOG_NOT_IMPLEMENTED;
+}
+
+void
+GPSDatalogArchive::close(void)
+{
+    /* empty */
+}
+
+#endif /* __linux__ */
+
+uint64_t
+GPSDatalogArchive::findRecord(uint64_t utcMs) const
+{
+    /* last index entry before utcMs ... */
+    uint32_t lo = 0;
+    uint32_t hi = _indexCount;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (_index[mid] < utcMs) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) {
+        return 0;
+    }
+
+    /* ... then the records of its stride */
+    uint64_t first = (uint64_t)(lo - 1) * _stride;
+    uint64_t last = first + _stride;
+    if (last > _count) {
+        last = _count;
+    }
+    while (first < last) {
+        uint64_t mid = first + (last - first) / 2;
+        if (_records[mid].utcTime < utcMs) {
+            first = mid + 1;
+        } else {
+            last = mid;
+        }
+    }
+    return first;
+}
+
+uint64_t
+GPSDatalogArchive::slice(uint64_t fromMs, uint64_t toMs, const Record_t *&begin, const Record_t *&end) const
+{
+    uint64_t first = findRecord(fromMs);
+    uint64_t last = (toMs > fromMs) ? findRecord(toMs) : first;
+    begin = _records + first;
+    end = _records + last;
+
+#if defined(__linux__)
+    if (last > first) {
+        /* page-aligned range for the read-ahead hint */
+        const uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+        uintptr_t from = (uintptr_t)begin & ~(page - 1);
+        madvise((void *)from, (uintptr_t)end - from, MADV_WILLNEED);
+    }
+#endif
+    return last - first;
+}
+
+void
+GPSDatalogArchive::toQueryResp(const Record_t &record, GPSProvider::LogQueryRespParams_t &resp)
+{
+    memset(&resp, 0, sizeof(resp));
+    resp.statusBitmap = record.statusBitmap;
+    resp.logMask = record.logMask;
+    GPSProviderUtils::utcMsToTimestamp(record.utcTime, resp.timestamp);
+    resp.fix = record.fix;
+    resp.quality = record.quality;
+    resp.geo = record.geo;
+    resp.lat = record.lat / 1e7;
+    resp.lon = record.lon / 1e7;
+    resp.altitude = (float)(record.altitude / 100.0);
+    resp.speed = record.speed / 100.0;
+    resp.odo = record.odo / 10.0;
+}
+
+/*
+ * Writer
+ */
+
+GPSDatalogArchiveWriter::GPSDatalogArchiveWriter() :
+    _file(NULL),
+    _count(0),
+    _firstUtcMs(0),
+    _lastUtcMs(0),
+    _index(NULL),
+    _indexCount(0),
+    _indexCapacity(0),
+    _buffer(NULL),
+    _buffered(0),
+    _failed(false)
+{
+    /* empty */
+}
+
+GPSDatalogArchiveWriter::~GPSDatalogArchiveWriter()
+{
+    if (_file != NULL) {
+        fclose(_file);
+    }
+    free(_index);
+    free(_buffer);
+}
+
+gps_provider_error_t
+GPSDatalogArchiveWriter::create(const char *path)
+{
+    if (_file != NULL) {
+        fclose(_file);
+    }
+    _count = 0;
+    _firstUtcMs = 0;
+    _lastUtcMs = 0;
+    _indexCount = 0;
+    _buffered = 0;
+    _failed = false;
+
+    if ((_buffer == NULL) && ((_buffer = (uint8_t *)malloc(BUFFER_RECORDS * RECORD_SIZE)) == NULL)) {
+        return GPS_ERROR_NO_MEM;
+    }
+    _file = fopen(path, "w+b");
+    if (_file == NULL) {
+        return GPS_ERROR_DATALOG_CFG;
+    }
+
+    /* placeholder, rewritten by finish() */
+    uint8_t header[GPSDatalogArchive::HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    if (fwrite(header, 1, sizeof(header), _file) != sizeof(header)) {
+        fclose(_file);
+        _file = NULL;
+        return GPS_ERROR_DATALOG_CFG;
+    }
+    return GPS_ERROR_NONE;
+}
+
+bool
+GPSDatalogArchiveWriter::flushBuffer(void)
+{
+    size_t n = (size_t)_buffered * RECORD_SIZE;
+    _buffered = 0;
+    if ((n > 0) && (fwrite(_buffer, 1, n, _file) != n)) {
+        _failed = true;
+    }
+    return !_failed;
+}
+
+gps_provider_error_t
+GPSDatalogArchiveWriter::add(const GPSDatalogArchive::Record_t &record)
+{
+    if ((_file == NULL) || ((_count > 0) && (record.utcTime < _lastUtcMs))) {
+        return GPS_ERROR_DATALOG_CFG;
+    }
+
+    if ((_count % GPSDatalogArchive::INDEX_STRIDE) == 0) {
+        if (_indexCount == _indexCapacity) {
+            uint32_t capacity = (_indexCapacity == 0) ? 64 : _indexCapacity * 2;
+            uint64_t *index = (uint64_t *)realloc(_index, capacity * sizeof(uint64_t));
+            if (index == NULL) {
+                return GPS_ERROR_NO_MEM;
+            }
+            _index = index;
+            _indexCapacity = capacity;
+        }
+        _index[_indexCount++] = record.utcTime;
+    }
+
+    uint8_t *out = &_buffer[_buffered * RECORD_SIZE];
+    put64(&out[0], record.utcTime);
+    put32(&out[8], (uint32_t)record.lat);
+    put32(&out[12], (uint32_t)record.lon);
+    put32(&out[16], (uint32_t)record.altitude);
+    put32(&out[20], record.odo);
+    put16(&out[24], record.speed);
+    out[26] = record.fix;
+    out[27] = record.quality;
+    out[28] = record.geo;
+    out[29] = record.logMask;
+    out[30] = record.statusBitmap;
+    out[31] = 0;
+
+    if (_count == 0) {
+        _firstUtcMs = record.utcTime;
+    }
+    _lastUtcMs = record.utcTime;
+    _count++;
+
+    if ((++_buffered == BUFFER_RECORDS) && !flushBuffer()) {
+        return GPS_ERROR_DATALOG_STOP;
+    }
+    return GPS_ERROR_NONE;
+}
+
+void
+GPSDatalogArchiveWriter::fromQueryResp(const GPSProvider::LogQueryRespParams_t &entry,
+                                       GPSDatalogArchive::Record_t &record)
+{
+    int64_t speed = toFixed(entry.speed, 100.0);
+    int64_t odo = toFixed(entry.odo, 10.0);
+
+    memset(&record, 0, sizeof(record));
+    record.utcTime = GPSProviderUtils::timestampToUtcMs(entry.timestamp);
+    record.lat = (int32_t)toFixed(entry.lat, 1e7);
+    record.lon = (int32_t)toFixed(entry.lon, 1e7);
+    record.altitude = (int32_t)toFixed(entry.altitude, 100.0);
+    record.odo = (odo < 0) ? 0 : ((odo > 0xFFFFFFFFLL) ? 0xFFFFFFFFU : (uint32_t)odo);
+    record.speed = (speed < 0) ? 0 : ((speed > 0xFFFF) ? 0xFFFF : (uint16_t)speed);
+    record.fix = entry.fix;
+    record.quality = (entry.quality > 0xFF) ? 0xFF : (uint8_t)entry.quality;
+    record.geo = entry.geo;
+    record.logMask = entry.logMask;
+    record.statusBitmap = entry.statusBitmap;
+}
+
+gps_provider_error_t
+GPSDatalogArchiveWriter::add(const GPSProvider::LogQueryRespParams_t &entry)
+{
+    GPSDatalogArchive::Record_t record;
+    fromQueryResp(entry, record);
+    return add(record);
+}
+
+gps_provider_error_t
+GPSDatalogArchiveWriter::exportLog(GPSDatalogEngine &log)
+{
+    for (unsigned i = 0; i < log.getUsedEntries(); i++) {
+        GPSDatalogEngine::Record_t source;
+        if (!log.readRecord(i, source)) {
+            continue;
+        }
+        GPSDatalogArchive::Record_t record;
+        memset(&record, 0, sizeof(record));
+        record.utcTime = source.utcTime;
+        record.lat = (int32_t)toFixed(source.lat, 1e7);
+        record.lon = (int32_t)toFixed(source.lon, 1e7);
+        record.altitude = (int32_t)toFixed(source.altitude, 100.0);
+        record.speed = (uint16_t)toFixed(source.speed, 100.0);
+        record.fix = source.fix;
+        record.quality = source.quality;
+        record.logMask = source.logMask;
+        record.statusBitmap = source.statusBitmap;
+
+        gps_provider_error_t err = add(record);
+        if (err != GPS_ERROR_NONE) {
+            return err;
+        }
+    }
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSDatalogArchiveWriter::finish(void)
+{
+    if (_file == NULL) {
+        return GPS_ERROR_DATALOG_STOP;
+    }
+
+    bool ok = flushBuffer();
+    for (uint32_t i = 0; ok && (i < _indexCount); i++) {
+        uint8_t raw[8];
+        put64(raw, _index[i]);
+        ok = (fwrite(raw, 1, sizeof(raw), _file) == sizeof(raw));
+    }
+
+    uint8_t header[GPSDatalogArchive::HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    memcpy(header, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    put32(&header[8], GPSDatalogArchive::HEADER_SIZE);
+    put32(&header[12], RECORD_SIZE);
+    put64(&header[16], _count);
+    put64(&header[24], GPSDatalogArchive::HEADER_SIZE + _count * RECORD_SIZE);
+    put32(&header[32], GPSDatalogArchive::INDEX_STRIDE);
+    put32(&header[36], _indexCount);
+    put64(&header[40], _firstUtcMs);
+    put64(&header[48], _lastUtcMs);
+    put16(&header[60], crc16(header, 60));
+    ok = ok && (fseek(_file, 0, SEEK_SET) == 0) && (fwrite(header, 1, sizeof(header), _file) == sizeof(header));
+
+    ok = (fclose(_file) == 0) && ok;
+    _file = NULL;
+    return ok ? GPS_ERROR_NONE : GPS_ERROR_DATALOG_STOP;
+}
@@ -0,0 +1,223 @@
+/**
+ ******************************************************************************
+ * @file    GPSDatalogDownloader.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Batched, flow-controlled datalog download.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <string.h>
+#include "GPSDatalogDownloader.h"
+#include "GPSProviderUtils.h"
+
+GPSDatalogDownloader::GPSDatalogDownloader(GPSProvider &gps) :
+    _gps(gps),
+    _buffer(NULL),
+    _capacity(0),
+    _head(0),
+    _filled(0),
+    _callback(NULL),
+    _active(false),
+    _done(false),
+    _pending(false),
+    _last(false),
+    _bulk(true),
+    _skip(0),
+    _abandoned(0)
+{
+    memset(&_resume, 0, sizeof(_resume));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+gps_provider_error_t
+GPSDatalogDownloader::start(const ResumePoint_t &from, GPSProvider::LogQueryRespParams_t *buffer,
+                            unsigned capacity, LogBatchCallback_t callback)
+{
+    if ((buffer == NULL) || (capacity == 0) || (callback == NULL)) {
+        return GPS_ERROR_LOG_REQ_QUERY;
+    }
+    cancel();
+    _buffer = buffer;
+    _capacity = capacity;
+    _callback = callback;
+    _resume = from;
+    _head = 0;
+    _filled = 0;
+    _active = true;
+    _done = false;
+    _last = false;
+    _bulk = true;
+    memset(&_stats, 0, sizeof(_stats));
+
+    request();
+    return _active ? GPS_ERROR_NONE : GPS_ERROR_LOG_REQ_QUERY;
+}
+
+void
+GPSDatalogDownloader::cancel(void)
+{
+    /* a part in flight is still answered: its responses and closing status
+     * are dropped, not taken for those of the next start() */
+    if (_pending) {
+        _abandoned++;
+        _pending = false;
+    }
+    _active = false;
+    _head = 0;
+    _filled = 0;
+}
+
+void
+GPSDatalogDownloader::request(void)
+{
+    GPSProvider::LogQueryParams_t query;
+    query.startTimestamp = _resume.timestamp;
+    query.entries = _capacity;
+    _head = 0;
+    _filled = 0;
+
+    if (_bulk) {
+        unsigned count = _capacity;
+        gps_provider_error_t ret = _gps.logReqBulk(query, _resume.skip, _buffer, count);
+        if (ret == GPS_ERROR_NONE) {
+            _stats.requests++;
+            _stats.bulkRequests++;
+            _filled = count;
+            _last = (count < _capacity);
+            return;
+        }
+        if (ret != GPS_ERROR_LOG_NOT_IMPLEMENTED) {
+            _active = false;
+            return;
+        }
+        _bulk = false;
+    }
+
+    /* the entries already delivered in the first second come again */
+    query.entries = _capacity + _resume.skip;
+    _skip = _resume.skip;
+    _pending = true;
+    if (_gps.logReqQuery(query) != GPS_ERROR_NONE) {
+        _pending = false;
+        _active = false;
+        return;
+    }
+    _stats.requests++;
+    _gps.logReqStatus();
+}
+
+void
+GPSDatalogDownloader::handleQueryResp(const GPSProvider::LogQueryRespParams_t *params)
+{
+    if ((_abandoned > 0) || !_active || !_pending || (params == NULL)) {
+        return;
+    }
+    if (_skip > 0) {
+        _skip--;
+        return;
+    }
+    if (_filled < _capacity) {
+        _buffer[_filled++] = *params;
+    }
+}
+
+void
+GPSDatalogDownloader::handleStatus(const GPSProvider::LogStatusParams_t *params)
+{
+    (void)params;
+    if (_abandoned > 0) {
+        _abandoned--;
+        return;
+    }
+    if (!_active || !_pending) {
+        return;
+    }
+    /* closes the part: a short one ends the log */
+    _pending = false;
+    _last = (_filled < _capacity);
+}
+
+void
+GPSDatalogDownloader::deliver(void)
+{
+    if (_head == _filled) {
+        return;
+    }
+
+    unsigned count = _filled - _head;
+    unsigned taken = _callback(&_buffer[_head], count);
+    if (taken > count) {
+        taken = count;
+    }
+    _stats.batches++;
+    if (taken < count) {
+        _stats.stalls++;
+    }
+
+    uint64_t resumeMs = GPSProviderUtils::timestampToUtcMs(_resume.timestamp);
+    for (unsigned i = _head; i < _head + taken; i++) {
+        uint64_t utcMs = GPSProviderUtils::timestampToUtcMs(_buffer[i].timestamp);
+        if (utcMs == resumeMs) {
+            _resume.skip++;
+        } else {
+            resumeMs = utcMs;
+            _resume.timestamp = _buffer[i].timestamp;
+            _resume.skip = 1;
+        }
+    }
+    _head += taken;
+    _stats.entries += taken;
+}
+
+void
+GPSDatalogDownloader::process(void)
+{
+    if (!_active || _pending) {
+        return;
+    }
+
+    deliver();
+    if (_head < _filled) {
+        /* back-pressure: retried at the next call */
+        return;
+    }
+    if (_last) {
+        _done = true;
+        _active = false;
+        return;
+    }
+    request();
+    if (_active && !_pending) {
+        deliver();
+    }
+}
@@ -0,0 +1,687 @@
+/**
+ ******************************************************************************
+ * @file    GPSDatalogEngine.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Host-side datalogging on a circular file store.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <string.h>
+#include <math.h>
+#include "GPSDatalogEngine.h"
+#include "GPSProviderUtils.h"
+#include "GPSTraceRecorder.h"
+
+/*
+ * Store layout (little-endian):
+ *
+ *  header, at offset 0 (the rest of the first page is unused)
+ *      0  magic "GPSLOG01"
+ *      8  uint32 record size
+ *     12  uint32 capacity (records)
+ *     16  uint32 slot of the oldest record
+ *     20  uint32 number of records
+ *     24  uint32 next sequence number
+ *     28  uint16 CRC of bytes 0..27
+ *
+ *  record, at PAGE_SIZE + slot * RECORD_SIZE
+ *      0  uint64 UTC time (ms)
+ *      8  uint32 sequence number
+ *     12  int32  latitude (1e-7 degree)
+ *     16  int32  longitude (1e-7 degree)
+ *     20  int32  altitude (cm)
+ *     24  uint16 speed (cm/s)
+ *     26  uint8  fix, quality, log mask, status bitmap
+ *     30  uint16 CRC of bytes 0..29
+ */
+
+static const char STORE_MAGIC[8] = { 'G', 'P', 'S', 'L', 'O', 'G', '0', '1' };
+static const unsigned HEADER_SIZE = 32;
+/* every record offset, past the header page, must fit in a long */
+static const uint32_t MAX_CAPACITY = (0x7FFFFFFFUL - GPSDatalogEngine::PAGE_SIZE) / GPSDatalogEngine::RECORD_SIZE;
+
+static uint16_t
+crc16(const uint8_t *data, unsigned len)
+{
+    /* CRC-16/CCITT-FALSE: a blank (zeroed) record never matches */
+    uint16_t crc = 0xFFFF;
+    for (unsigned i = 0; i < len; i++) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (unsigned bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void
+put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void
+put32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint16_t
+get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t
+get32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int32_t
+toFixed(double value, double scale)
+{
+    return (int32_t)floor(value * scale + 0.5);
+}
+
+GPSDatalogEngine::GPSDatalogEngine() :
+    _file(NULL),
+    _capacity(0),
+    _first(0),
+    _count(0),
+    _nextSeq(0),
+    _configured(false),
+    _started(false),
+    _circular(false),
+    _fullAlarm(false),
+    _fullReported(false),
+    _minRate(0),
+    _minSpeed(0),
+    _minPosition(0),
+    _logMask(0),
+    _haveLast(false),
+    _lastTime(0),
+    _pageIndex(0),
+    _dirtyBegin(0),
+    _dirtyEnd(0),
+    _statusCallback(NULL),
+    _queryCallback(NULL)
+{
+    memset(&_lastPoint, 0, sizeof(_lastPoint));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+GPSDatalogEngine::~GPSDatalogEngine()
+{
+    close();
+}
+
+gps_provider_error_t
+GPSDatalogEngine::open(const char *path, unsigned capacity)
+{
+    close();
+    if (path == NULL) {
+        return GPS_ERROR_DATALOG_CFG;
+    }
+
+    memset(&_stats, 0, sizeof(_stats));
+    _pageIndex = _dirtyBegin = _dirtyEnd = 0;
+    _fullReported = false;
+
+    _file = fopen(path, "r+b");
+    if (_file != NULL) {
+        /* the page buffer is the only buffering level */
+        setvbuf(_file, NULL, _IONBF, 0);
+        if (!readHeader()) {
+            /* not a store: leave it alone */
+            fclose(_file);
+            _file = NULL;
+            return GPS_ERROR_DATALOG_CFG;
+        }
+        recover();
+        return GPS_ERROR_NONE;
+    }
+
+    if ((capacity == 0) || (capacity > MAX_CAPACITY)) {
+        return GPS_ERROR_DATALOG_CFG;
+    }
+    _file = fopen(path, "w+b");
+    if (_file == NULL) {
+        return GPS_ERROR_DATALOG_CFG;
+    }
+    setvbuf(_file, NULL, _IONBF, 0);
+    if (!create(capacity)) {
+        fclose(_file);
+        _file = NULL;
+        return GPS_ERROR_DATALOG_CFG;
+    }
+    memset(&_stats, 0, sizeof(_stats));
+    return GPS_ERROR_NONE;
+}
+
+void
+GPSDatalogEngine::close(void)
+{
+    if (_file == NULL) {
+        return;
+    }
+    flush();
+    fclose(_file);
+    _file = NULL;
+    _started = false;
+}
+
+bool
+GPSDatalogEngine::create(unsigned capacity)
+{
+    _capacity = capacity;
+    _first = 0;
+    _count = 0;
+    _nextSeq = 1;
+    if (!writeHeader()) {
+        return false;
+    }
+
+    /* preallocate: the store never grows afterwards */
+    memset(_page, 0, sizeof(_page));
+    if (fseek(_file, PAGE_SIZE, SEEK_SET) != 0) {
+        return false;
+    }
+    uint64_t remaining = (uint64_t)capacity * RECORD_SIZE;
+    while (remaining > 0) {
+        size_t n = (remaining < PAGE_SIZE) ? (size_t)remaining : PAGE_SIZE;
+        if (fwrite(_page, 1, n, _file) != n) {
+            return false;
+        }
+        remaining -= n;
+    }
+    return fflush(_file) == 0;
+}
+
+bool
+GPSDatalogEngine::readHeader(void)
+{
+    uint8_t header[HEADER_SIZE];
+    if ((fseek(_file, 0, SEEK_SET) != 0) || (fread(header, 1, HEADER_SIZE, _file) != HEADER_SIZE)) {
+        return false;
+    }
+    if ((memcmp(header, STORE_MAGIC, sizeof(STORE_MAGIC)) != 0) ||
+        (get16(&header[28]) != crc16(header, 28)) ||
+        (get32(&header[8]) != RECORD_SIZE)) {
+        return false;
+    }
+    _capacity = get32(&header[12]);
+    _first = get32(&header[16]);
+    _count = get32(&header[20]);
+    _nextSeq = get32(&header[24]);
+    return (_capacity > 0) && (_capacity <= MAX_CAPACITY) && (_first < _capacity) && (_count <= _capacity);
+}
+
+bool
+GPSDatalogEngine::writeHeader(void)
+{
+    uint8_t header[HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    memcpy(header, STORE_MAGIC, sizeof(STORE_MAGIC));
+    put32(&header[8], RECORD_SIZE);
+    put32(&header[12], _capacity);
+    put32(&header[16], _first);
+    put32(&header[20], _count);
+    put32(&header[24], _nextSeq);
+    put16(&header[28], crc16(header, 28));
+
+    if ((fseek(_file, 0, SEEK_SET) != 0) || (fwrite(header, 1, HEADER_SIZE, _file) != HEADER_SIZE)) {
+        return false;
+    }
+    _stats.headerWrites++;
+    _stats.bytesWritten += HEADER_SIZE;
+    return true;
+}
+
+void
+GPSDatalogEngine::recover(void)
+{
+    /* records flushed after the last header update follow the ring end
+     * with consecutive sequence numbers */
+    unsigned recovered = 0;
+    while (recovered < _capacity) {
+        Record_t record;
+        unsigned slot = (_first + _count) % _capacity;
+        if (!readSlot(slot, record) || (record.seq != _nextSeq)) {
+            break;
+        }
+        if (_count < _capacity) {
+            _count++;
+        } else {
+            _first = (_first + 1) % _capacity;
+        }
+        _nextSeq++;
+        recovered++;
+    }
+    _stats.recovered = recovered;
+    if (recovered > 0) {
+        writeHeader();
+    }
+}
+
+void
+GPSDatalogEngine::encode(const Record_t &record, uint8_t *out)
+{
+    double speed = floor(record.speed * 100.0 + 0.5);
+    put32(&out[0], (uint32_t)record.utcTime);
+    put32(&out[4], (uint32_t)(record.utcTime >> 32));
+    put32(&out[8], record.seq);
+    put32(&out[12], (uint32_t)toFixed(record.lat, 1e7));
+    put32(&out[16], (uint32_t)toFixed(record.lon, 1e7));
+    put32(&out[20], (uint32_t)toFixed(record.altitude, 100.0));
+    put16(&out[24], (uint16_t)((speed < 0.0) ? 0 : ((speed > 65535.0) ? 65535 : speed)));
+    out[26] = record.fix;
+    out[27] = record.quality;
+    out[28] = record.logMask;
+    out[29] = record.statusBitmap;
+    put16(&out[30], crc16(out, 30));
+}
+
+bool
+GPSDatalogEngine::decode(const uint8_t *in, Record_t &record)
+{
+    if (get16(&in[30]) != crc16(in, 30)) {
+        return false;
+    }
+    record.utcTime = (uint64_t)get32(&in[0]) | ((uint64_t)get32(&in[4]) << 32);
+    record.seq = get32(&in[8]);
+    record.lat = (int32_t)get32(&in[12]) / 1e7;
+    record.lon = (int32_t)get32(&in[16]) / 1e7;
+    record.altitude = (float)((int32_t)get32(&in[20]) / 100.0);
+    record.speed = (float)(get16(&in[24]) / 100.0);
+    record.fix = in[26];
+    record.quality = in[27];
+    record.logMask = in[28];
+    record.statusBitmap = in[29];
+    return true;
+}
+
+bool
+GPSDatalogEngine::readSlot(unsigned slot, Record_t &record)
+{
+    unsigned page = slot / RECORDS_PER_PAGE;
+    unsigned offset = slot % RECORDS_PER_PAGE;
+    if ((page == _pageIndex) && (offset >= _dirtyBegin) && (offset < _dirtyEnd)) {
+        /* not written yet */
+        return decode(&_page[offset * RECORD_SIZE], record);
+    }
+
+    uint8_t raw[RECORD_SIZE];
+    long position = (long)PAGE_SIZE + (long)slot * RECORD_SIZE;
+    if ((fseek(_file, position, SEEK_SET) != 0) || (fread(raw, 1, RECORD_SIZE, _file) != RECORD_SIZE)) {
+        return false;
+    }
+    return decode(raw, record);
+}
+
+bool
+GPSDatalogEngine::readRecord(unsigned index, Record_t &record)
+{
+    if ((_file == NULL) || (index >= _count)) {
+        return false;
+    }
+    return readSlot((_first + index) % _capacity, record);
+}
+
+gps_provider_error_t
+GPSDatalogEngine::configDatalog(const GPSDatalog *datalog)
+{
+    if (datalog == NULL) {
+        return GPS_ERROR_DATALOG_CFG;
+    }
+    _fullAlarm = datalog->getEnableBufferFullAlarm();
+    _circular = datalog->getEnableCircularBuffer();
+    _minRate = datalog->getMinRate();
+    _minSpeed = datalog->getMinSpeed();
+    _minPosition = datalog->getMinPosition();
+    _logMask = (uint8_t)datalog->getLogMask();
+    _configured = true;
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSDatalogEngine::startDatalog(void)
+{
+    if ((_file == NULL) || !_configured) {
+        return GPS_ERROR_DATALOG_START;
+    }
+    _started = true;
+    _haveLast = false;
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSDatalogEngine::stopDatalog(void)
+{
+    if (_file == NULL) {
+        return GPS_ERROR_DATALOG_STOP;
+    }
+    _started = false;
+    return flush();
+}
+
+gps_provider_error_t
+GPSDatalogEngine::eraseDatalog(void)
+{
+    if (_file == NULL) {
+        return GPS_ERROR_DATALOG_ERASE;
+    }
+    /* the sequence goes on, so that stale records are never recovered */
+    _first = 0;
+    _count = 0;
+    _pageIndex = _dirtyBegin = _dirtyEnd = 0;
+    _fullReported = false;
+    _haveLast = false;
+    return writeHeader() ? GPS_ERROR_NONE : GPS_ERROR_DATALOG_ERASE;
+}
+
+bool
+GPSDatalogEngine::accepts(const GPSProvider::LocationUpdateParams_t &location, double speed,
+                          const GPSLocalFrame::Point_t &point) const
+{
+    if (!location.valid) {
+        return false;
+    }
+    if ((_minSpeed > 0) && (speed * 3.6 < (double)_minSpeed)) {
+        return false;
+    }
+    if (!_haveLast) {
+        return true;
+    }
+    if ((_minRate > 0) && (location.utcTime < _lastTime + (uint64_t)_minRate * 1000ULL)) {
+        return false;
+    }
+    if (_minPosition == 0) {
+        return true;
+    }
+#if defined(GPS_LOCATION_FIXED_POINT)
+    return (uint64_t)GPSLocalFrame::distanceMm(_lastPoint, point) >= (uint64_t)_minPosition * 1000U;
+#else
+    return GPSLocalFrame::distance(_lastPoint, point) >= (double)_minPosition;
+#endif
+}
+
+bool
+GPSDatalogEngine::logFix(const GPSProvider::LocationUpdateParams_t &location, double speed)
+{
+    if (!_started || !location.valid) {
+        return logFix(location, speed, _frame.getPoint());
+    }
+    return logFix(location, speed, _frame.update(location));
+}
+
+bool
+GPSDatalogEngine::logFix(const GPSProvider::LocationUpdateParams_t &location, double speed,
+                         const GPSLocalFrame::Point_t &point)
+{
+    if (!_started || (_file == NULL)) {
+        return false;
+    }
+    _stats.fixes++;
+    if (!accepts(location, speed, point)) {
+        _stats.filtered++;
+        return false;
+    }
+    if ((_count == _capacity) && !_circular) {
+        _stats.dropped++;
+        return false;
+    }
+
+    Record_t record;
+    record.utcTime = location.utcTime;
+    record.seq = _nextSeq++;
+    record.lat = location.lat;
+    record.lon = location.lon;
+    record.altitude = location.altitude;
+    record.speed = (float)speed;
+    record.fix = 1;
+    unsigned svs = location.numGPSSVs + location.numGLOSVs;
+    record.quality = (uint8_t)((svs > 255) ? 255 : svs);
+    record.logMask = _logMask;
+    record.statusBitmap = 0;
+    append(record);
+
+    _haveLast = true;
+    _lastTime = location.utcTime;
+    _lastPoint = point;
+    _stats.logged++;
+
+    if ((_count == _capacity) && !_fullReported) {
+        _fullReported = true;
+        if (_fullAlarm) {
+            flush();
+            publishStatus();
+        }
+    }
+    return true;
+}
+
+void
+GPSDatalogEngine::append(const Record_t &record)
+{
+    unsigned slot;
+    if (_count < _capacity) {
+        slot = (_first + _count) % _capacity;
+        _count++;
+    } else {
+        slot = _first;
+        _first = (_first + 1) % _capacity;
+        _stats.overwritten++;
+    }
+
+    unsigned page = slot / RECORDS_PER_PAGE;
+    unsigned offset = slot % RECORDS_PER_PAGE;
+    if ((_dirtyEnd > _dirtyBegin) && ((page != _pageIndex) || (offset != _dirtyEnd))) {
+        flushPage();
+    }
+    if ((page != _pageIndex) || (offset != _dirtyEnd)) {
+        _pageIndex = page;
+        _dirtyBegin = _dirtyEnd = offset;
+    }
+    encode(record, &_page[offset * RECORD_SIZE]);
+    _dirtyEnd++;
+
+    if ((_dirtyEnd == RECORDS_PER_PAGE) || (slot == _capacity - 1)) {
+        flushPage();
+    }
+}
+
+bool
+GPSDatalogEngine::flushPage(void)
+{
+    if (_dirtyEnd == _dirtyBegin) {
+        return true;
+    }
+    size_t len = (size_t)(_dirtyEnd - _dirtyBegin) * RECORD_SIZE;
+    long position = (long)PAGE_SIZE + (long)(_pageIndex * RECORDS_PER_PAGE + _dirtyBegin) * RECORD_SIZE;
+    if ((fseek(_file, position, SEEK_SET) != 0) ||
+        (fwrite(&_page[_dirtyBegin * RECORD_SIZE], 1, len, _file) != len)) {
+        return false;
+    }
+    _stats.dataWrites++;
+    _stats.bytesWritten += len;
+    _dirtyBegin = _dirtyEnd;
+    return writeHeader();
+}
+
+gps_provider_error_t
+GPSDatalogEngine::flush(void)
+{
+    if (_file == NULL) {
+        return GPS_ERROR_NONE;
+    }
+    if (!flushPage() || (fflush(_file) != 0)) {
+        return GPS_ERROR_DATALOG_STOP;
+    }
+    return GPS_ERROR_NONE;
+}
+
+void
+GPSDatalogEngine::publishStatus(void)
+{
+    if (_statusCallback == NULL) {
+        return;
+    }
+
+    GPSProvider::LogStatusParams_t params;
+    memset(&params, 0, sizeof(params));
+    Record_t record;
+    if (readRecord(0, record)) {
+        GPSProviderUtils::utcMsToTimestamp(record.utcTime, params.firstEntryTimestamp);
+    }
+    if ((_count > 0) && readRecord(_count - 1, record)) {
+        GPSProviderUtils::utcMsToTimestamp(record.utcTime, params.lastEntryTimestamp);
+    }
+    params.usedEntries = _count;
+    params.bufferStatus = (_count == _capacity) ? BUFFER_STATUS_FULL : BUFFER_STATUS_OK;
+    params.remainingFreeEntries = _capacity - _count;
+    GPS_TRACE_SCOPE(TRACE_DATALOG_CB, 0);
+    _statusCallback(&params);
+}
+
+gps_provider_error_t
+GPSDatalogEngine::logReqStatus(void)
+{
+    if (_file == NULL) {
+        return GPS_ERROR_LOG_REQ_STATUS;
+    }
+    publishStatus();
+    return GPS_ERROR_NONE;
+}
+
+void
+GPSDatalogEngine::toQueryResp(const Record_t &record, GPSProvider::LogQueryRespParams_t &resp)
+{
+    memset(&resp, 0, sizeof(resp));
+    resp.statusBitmap = record.statusBitmap;
+    resp.logMask = record.logMask;
+    GPSProviderUtils::utcMsToTimestamp(record.utcTime, resp.timestamp);
+    resp.fix = record.fix;
+    resp.quality = record.quality;
+    resp.lat = record.lat;
+    resp.lon = record.lon;
+    resp.altitude = record.altitude;
+    resp.speed = record.speed;
+}
+
+unsigned
+GPSDatalogEngine::findRecord(uint64_t utcMs)
+{
+    unsigned lo = 0;
+    unsigned hi = _count;
+    while (lo < hi) {
+        unsigned mid = lo + (hi - lo) / 2;
+        Record_t record;
+        if (readRecord(mid, record) && (record.utcTime < utcMs)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+gps_provider_error_t
+GPSDatalogEngine::logReqQuery(const GPSProvider::LogQueryParams_t &query)
+{
+    if (_file == NULL) {
+        return GPS_ERROR_LOG_REQ_QUERY;
+    }
+
+    unsigned sent = 0;
+    unsigned i = findRecord(GPSProviderUtils::timestampToUtcMs(query.startTimestamp));
+    for (; (i < _count) && ((query.entries == 0) || (sent < query.entries)); i++) {
+        Record_t record;
+        if (!readRecord(i, record)) {
+            continue;
+        }
+        if (_queryCallback != NULL) {
+            GPSProvider::LogQueryRespParams_t resp;
+            toQueryResp(record, resp);
+            GPS_TRACE_SCOPE(TRACE_DATALOG_CB, i);
+            _queryCallback(&resp);
+        }
+        sent++;
+    }
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSDatalogEngine::logReqBulk(const GPSProvider::LogQueryParams_t &query, unsigned skip,
+                             GPSProvider::LogQueryRespParams_t *entries, unsigned &count)
+{
+    unsigned room = count;
+    count = 0;
+    if ((_file == NULL) || (entries == NULL) || !flushPage()) {
+        return GPS_ERROR_LOG_REQ_QUERY;
+    }
+
+    unsigned i = findRecord(GPSProviderUtils::timestampToUtcMs(query.startTimestamp)) + skip;
+    uint8_t block[PAGE_SIZE];
+    while ((i < _count) && (count < room)) {
+        /* contiguous slots, up to the ring end */
+        unsigned slot = (_first + i) % _capacity;
+        unsigned n = _count - i;
+        if (n > _capacity - slot) {
+            n = _capacity - slot;
+        }
+        if (n > RECORDS_PER_PAGE) {
+            n = RECORDS_PER_PAGE;
+        }
+        if (n > room - count) {
+            n = room - count;
+        }
+        long position = (long)PAGE_SIZE + (long)slot * RECORD_SIZE;
+        if ((fseek(_file, position, SEEK_SET) != 0) ||
+            (fread(block, RECORD_SIZE, n, _file) != n)) {
+            return GPS_ERROR_LOG_REQ_QUERY;
+        }
+        for (unsigned k = 0; k < n; k++) {
+            Record_t record;
+            if (decode(&block[k * RECORD_SIZE], record)) {
+                toQueryResp(record, entries[count++]);
+            }
+        }
+        i += n;
+    }
+    return GPS_ERROR_NONE;
+}
@@ -0,0 +1,335 @@
+/**
+ ******************************************************************************
+ * @file    GPSDatalogMirror.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Host-side mirror of the receiver datalog.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "GPSDatalogMirror.h"
+#include "GPSProviderUtils.h"
+
+GPSDatalogMirror::GPSDatalogMirror(GPSProvider &gps, unsigned capacity) :
+    _gps(gps),
+    _capacity(capacity),
+    _entries(NULL),
+    _index(NULL),
+    _indexCapacity(capacity / INDEX_STRIDE + 2),
+    _base(0),
+    _count(0),
+    _requestHead(0),
+    _requestCount(0),
+    _haveStatus(false),
+    _checkPending(false),
+    _synced(false),
+    _queryCallback(NULL)
+{
+    memset(&_status, 0, sizeof(_status));
+    memset(&_stats, 0, sizeof(_stats));
+    if (capacity > 0) {
+        _entries = (GPSProvider::LogQueryRespParams_t *)malloc(capacity * sizeof(GPSProvider::LogQueryRespParams_t));
+        _index = (uint64_t *)malloc(_indexCapacity * sizeof(uint64_t));
+    }
+    if ((_entries == NULL) || (_index == NULL)) {
+        free(_entries);
+        free(_index);
+        _entries = NULL;
+        _index = NULL;
+        _capacity = 0;
+    }
+}
+
+GPSDatalogMirror::~GPSDatalogMirror()
+{
+    free(_entries);
+    free(_index);
+}
+
+void
+GPSDatalogMirror::clear(void)
+{
+    _stats.droppedEntries += _count;
+    _base = 0;
+    _count = 0;
+}
+
+uint64_t
+GPSDatalogMirror::timeAt(uint32_t position) const
+{
+    return GPSProviderUtils::timestampToUtcMs(_entries[position % _capacity].timestamp);
+}
+
+uint32_t
+GPSDatalogMirror::lowerBound(uint64_t utcMs) const
+{
+    const uint32_t end = _base + _count;
+    if (_count == 0) {
+        return end;
+    }
+
+    /* last index point before utcMs */
+    uint32_t lo = (_base + INDEX_STRIDE - 1) / INDEX_STRIDE;
+    uint32_t hi = (end - 1) / INDEX_STRIDE + 1;
+    uint32_t scan = _base;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (_index[mid % _indexCapacity] < utcMs) {
+            scan = mid * INDEX_STRIDE + 1;
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    /* at most INDEX_STRIDE entries to the answer */
+    while ((scan < end) && (timeAt(scan) < utcMs)) {
+        scan++;
+    }
+    return scan;
+}
+
+void
+GPSDatalogMirror::append(const GPSProvider::LogQueryRespParams_t &entry, uint64_t utcMs)
+{
+    if (_count == _capacity) {
+        _base++;
+        _count--;
+        _stats.droppedEntries++;
+    }
+    uint32_t position = _base + _count;
+    _entries[position % _capacity] = entry;
+    if ((position % INDEX_STRIDE) == 0) {
+        _index[(position / INDEX_STRIDE) % _indexCapacity] = utcMs;
+    }
+    _count++;
+}
+
+void
+GPSDatalogMirror::dropBefore(uint64_t utcMs)
+{
+    uint32_t position = lowerBound(utcMs);
+    _stats.droppedEntries += position - _base;
+    _count -= position - _base;
+    _base = position;
+}
+
+bool
+GPSDatalogMirror::pushRequest(RequestKind_t kind, unsigned skip)
+{
+    if (_requestCount == MAX_REQUESTS) {
+        return false;
+    }
+    Request_t &request = _requests[(_requestHead + _requestCount) % MAX_REQUESTS];
+    request.kind = kind;
+    request.skip = skip;
+    request.fetched = 0;
+    _requestCount++;
+    return true;
+}
+
+gps_provider_error_t
+GPSDatalogMirror::sync(void)
+{
+    _checkPending = true;
+    return _gps.logReqStatus();
+}
+
+void
+GPSDatalogMirror::handleStatus(const GPSProvider::LogStatusParams_t *params)
+{
+    if (params == NULL) {
+        return;
+    }
+    _status = *params;
+    _haveStatus = true;
+    if (_requestCount > 0) {
+        /* closes the oldest request; a sync that brought nothing new is not
+         * retried before the next status */
+        const Request_t &request = _requests[_requestHead];
+        bool retry = (request.kind != REQUEST_SYNC) || (request.fetched > 0);
+        _requestHead = (_requestHead + 1) % MAX_REQUESTS;
+        _requestCount--;
+        if (!retry) {
+            return;
+        }
+    }
+    _checkPending = true;
+}
+
+void
+GPSDatalogMirror::handleQueryResp(const GPSProvider::LogQueryRespParams_t *params)
+{
+    if (params == NULL) {
+        return;
+    }
+    if ((_requestCount == 0) || (_requests[_requestHead].kind == REQUEST_FORWARD)) {
+        if (_queryCallback != NULL) {
+            _queryCallback(params);
+        }
+        return;
+    }
+
+    Request_t &request = _requests[_requestHead];
+    if (request.skip > 0) {
+        request.skip--;
+        return;
+    }
+    uint64_t utcMs = GPSProviderUtils::timestampToUtcMs(params->timestamp);
+    if ((_count > 0) && (utcMs < timeAt(_base + _count - 1))) {
+        /* keep the ring sorted */
+        return;
+    }
+    append(*params, utcMs);
+    request.fetched++;
+    _stats.fetchedEntries++;
+}
+
+void
+GPSDatalogMirror::process(void)
+{
+    if (_checkPending && (_requestCount == 0) && _haveStatus) {
+        _checkPending = false;
+        check();
+    }
+}
+
+void
+GPSDatalogMirror::check(void)
+{
+    if (_capacity == 0) {
+        return;
+    }
+
+    unsigned used = _status.usedEntries;
+    if (used == 0) {
+        clear();
+        _synced = true;
+        return;
+    }
+
+    uint64_t first = GPSProviderUtils::timestampToUtcMs(_status.firstEntryTimestamp);
+    uint64_t last = GPSProviderUtils::timestampToUtcMs(_status.lastEntryTimestamp);
+    if ((_count > 0) && (timeAt(_base + _count - 1) > last)) {
+        /* the receiver log was erased */
+        clear();
+    }
+    dropBefore(first);
+    if (_count > used) {
+        clear();
+    }
+
+    unsigned target = (used < _capacity) ? used : _capacity;
+    if ((_count == target) && ((_count == 0) || (timeAt(_base + _count - 1) == last))) {
+        _synced = true;
+        return;
+    }
+    _synced = false;
+
+    /* fetch from the last mirrored second; the entries of that second
+     * already held are skipped */
+    GPSProvider::LogQueryParams_t query;
+    unsigned skip = 0;
+    if (_count > 0) {
+        uint64_t from = timeAt(_base + _count - 1);
+        uint32_t position = lowerBound(from);
+        skip = _base + _count - position;
+        GPSProviderUtils::utcMsToTimestamp(from, query.startTimestamp);
+        query.entries = used - (position - _base);
+    } else {
+        query.startTimestamp = _status.firstEntryTimestamp;
+        query.entries = used;
+    }
+
+    if (!pushRequest(REQUEST_SYNC, skip)) {
+        return;
+    }
+    _stats.syncRequests++;
+    if (_gps.logReqQuery(query) != GPS_ERROR_NONE) {
+        _requestCount--;
+        return;
+    }
+    _gps.logReqStatus();
+}
+
+gps_provider_error_t
+GPSDatalogMirror::logReqQuery(const GPSProvider::LogQueryParams_t &query)
+{
+    uint64_t start = GPSProviderUtils::timestampToUtcMs(query.startTimestamp);
+    uint32_t end = _base + _count;
+    uint32_t position = lowerBound(start);
+
+    /* local if every matching entry is here: in sync and not older than the
+     * mirror (unless the mirror reaches back to the receiver's first one),
+     * or enough entries already mirrored */
+    bool local;
+    if (isSynced()) {
+        local = (_count == _status.usedEntries) || (_count == 0) || (start >= timeAt(_base));
+    } else {
+        local = (_count > 0) && (start >= timeAt(_base)) &&
+                (query.entries != 0) && (end - position >= query.entries);
+    }
+
+    if (local) {
+        _stats.localQueries++;
+        unsigned sent = 0;
+        for (; (position < end) && ((query.entries == 0) || (sent < query.entries)); position++, sent++) {
+            if (_queryCallback != NULL) {
+                _queryCallback(&_entries[position % _capacity]);
+            }
+        }
+        _stats.localEntries += sent;
+        return GPS_ERROR_NONE;
+    }
+
+    if (!pushRequest(REQUEST_FORWARD, 0)) {
+        return GPS_ERROR_LOG_REQ_QUERY;
+    }
+    _stats.forwardedQueries++;
+    GPSProvider::LogQueryParams_t forwarded = query;
+    gps_provider_error_t ret = _gps.logReqQuery(forwarded);
+    if (ret != GPS_ERROR_NONE) {
+        _requestCount--;
+        return ret;
+    }
+    _gps.logReqStatus();
+    return GPS_ERROR_NONE;
+}
+
+void
+GPSDatalogMirror::getStats(MirrorStats_t &stats) const
+{
+    stats = _stats;
+    stats.entries = _count;
+}
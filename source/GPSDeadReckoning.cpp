@@ -0,0 +1,248 @@
+/**
+ ******************************************************************************
+ * @file    GPSDeadReckoning.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Kalman position estimate between low-power fixes.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <string.h>
+#include <math.h>
+#include "GPSDeadReckoning.h"
+#include "GPSProviderUtils.h"
+
+static const double METERS_PER_DEG = GPS_EARTH_RADIUS_M * GPS_DEG_TO_RAD;
+
+/* Velocity uncertainty (m/s) of a restart, before a second fix. */
+static const double INITIAL_VELOCITY_SIGMA = 20.0;
+
+/* Squared innovation (in units of its variance) beyond which a fix is an
+ * outlier; REJECT_LIMIT outliers in a row restart the filter. */
+static const double GATE2 = 25.0;
+static const unsigned REJECT_LIMIT = 3;
+
+/* Offset (meters) of the state moving the plane reference. */
+static const double RECENTER = 1000.0;
+
+static double
+wrapLon(double lon)
+{
+    if (lon >= 180.0) {
+        lon -= 360.0;
+    } else if (lon < -180.0) {
+        lon += 360.0;
+    }
+    return lon;
+}
+
+GPSDeadReckoning::GPSDeadReckoning() :
+    _threshold(25.0),
+    _maxGap(600000),
+    _initialized(false),
+    _requestPending(false),
+    _rejectRun(0),
+    _time(0),
+    _fixRequestCallback(NULL)
+{
+    setMeasurementNoise(5.0);
+    setProcessNoise(1.0);
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void
+GPSDeadReckoning::setMeasurementNoise(double sigma)
+{
+    _r = (sigma > 0.1) ? sigma * sigma : 0.01;
+}
+
+void
+GPSDeadReckoning::setProcessNoise(double sigma)
+{
+    _q = (sigma > 0.0) ? sigma * sigma : 0.0;
+}
+
+bool
+GPSDeadReckoning::update(const GPSProvider::LocationUpdateParams_t &location)
+{
+    if (!location.valid) {
+        _stats.invalid++;
+        return false;
+    }
+    GPSLocalFrame::Point_t point;
+    point.lat = location.lat;
+    point.lon = location.lon;
+    point.cosLat = cos(location.lat * GPS_DEG_TO_RAD);
+    point.east = 0.0;
+    point.north = 0.0;
+    return update(location, point);
+}
+
+bool
+GPSDeadReckoning::update(const GPSProvider::LocationUpdateParams_t &location, const GPSLocalFrame::Point_t &point)
+{
+    if (!location.valid) {
+        _stats.invalid++;
+        return false;
+    }
+    _requestPending = false;
+
+    if (!_initialized ||
+        (location.utcTime < _time) ||
+        (location.utcTime - _time > _maxGap)) {
+        restart(point, location.utcTime);
+        return true;
+    }
+
+    /* predict to the fix */
+    double dt = (double)(location.utcTime - _time) * 1e-3;
+    double p[3] = { _p[0], _p[1], _p[2] };
+    propagate(dt, p);
+    double x[2];
+    for (unsigned i = 0; i < 2; i++) {
+        x[i] = _x[i] + _v[i] * dt;
+    }
+
+    /* innovation */
+    double y[2];
+    y[0] = wrapLon(point.lon - _refLon) * _refCos * METERS_PER_DEG - x[0];
+    y[1] = (point.lat - _refLat) * METERS_PER_DEG - x[1];
+    double s = p[0] + _r;
+    if ((y[0] * y[0] + y[1] * y[1]) > GATE2 * s) {
+        _stats.rejected++;
+        if (++_rejectRun >= REJECT_LIMIT) {
+            /* not an outlier but a jump (e.g. after a tunnel) */
+            restart(point, location.utcTime);
+            return true;
+        }
+        return false;
+    }
+    _rejectRun = 0;
+
+    /* correct */
+    double k0 = p[0] / s;
+    double k1 = p[1] / s;
+    for (unsigned i = 0; i < 2; i++) {
+        _x[i] = x[i] + k0 * y[i];
+        _v[i] += k1 * y[i];
+    }
+    _p[0] = p[0] * (1.0 - k0);
+    _p[1] = p[1] * (1.0 - k0);
+    _p[2] = p[2] - k1 * p[1];
+    _time = location.utcTime;
+
+    if ((fabs(_x[0]) > RECENTER) || (fabs(_x[1]) > RECENTER)) {
+        _refLat += _x[1] / METERS_PER_DEG;
+        _refLon = wrapLon(_refLon + _x[0] / (_refCos * METERS_PER_DEG));
+        _refCos = point.cosLat;
+        _x[0] = 0.0;
+        _x[1] = 0.0;
+    }
+
+    _stats.updates++;
+    return true;
+}
+
+bool
+GPSDeadReckoning::predict(uint64_t utcTime, Estimate_t &estimate) const
+{
+    if (!_initialized) {
+        return false;
+    }
+    /* no smoothing backwards: earlier times get the last fix estimate */
+    double dt = (utcTime > _time) ? (double)(utcTime - _time) * 1e-3 : 0.0;
+    double p[3] = { _p[0], _p[1], _p[2] };
+    propagate(dt, p);
+
+    double east = _x[0] + _v[0] * dt;
+    double north = _x[1] + _v[1] * dt;
+    estimate.lat = _refLat + north / METERS_PER_DEG;
+    estimate.lon = wrapLon(_refLon + east / (_refCos * METERS_PER_DEG));
+    estimate.velocityEast = _v[0];
+    estimate.velocityNorth = _v[1];
+    estimate.errorRadius = 2.0 * sqrt(2.0 * p[0]);
+    estimate.utcTime = utcTime;
+    estimate.fixUtcTime = _time;
+    return true;
+}
+
+bool
+GPSDeadReckoning::locate(uint64_t utcTime, Estimate_t &estimate)
+{
+    if (!predict(utcTime, estimate)) {
+        requestFix();
+        return false;
+    }
+    _stats.queries++;
+    if (estimate.errorRadius > _threshold) {
+        requestFix();
+    }
+    return true;
+}
+
+void
+GPSDeadReckoning::requestFix(void)
+{
+    if (_requestPending || (_fixRequestCallback == NULL)) {
+        return;
+    }
+    _requestPending = true;
+    _stats.fixRequests++;
+    _fixRequestCallback();
+}
+
+void
+GPSDeadReckoning::restart(const GPSLocalFrame::Point_t &point, uint64_t utcTime)
+{
+    _refLat = point.lat;
+    _refLon = point.lon;
+    _refCos = point.cosLat;
+    _x[0] = _x[1] = 0.0;
+    _v[0] = _v[1] = 0.0;
+    _p[0] = _r;
+    _p[1] = 0.0;
+    _p[2] = INITIAL_VELOCITY_SIGMA * INITIAL_VELOCITY_SIGMA;
+    _time = utcTime;
+    _rejectRun = 0;
+    _initialized = true;
+    _stats.restarts++;
+}
+
+/* P = F P F' + Q for F = [1 dt; 0 1] and white acceleration noise. */
+void
+GPSDeadReckoning::propagate(double dt, double p[3]) const
+{
+    double dt2 = dt * dt;
+    p[0] += 2.0 * dt * p[1] + dt2 * p[2] + _q * dt2 * dt / 3.0;
+    p[1] += dt * p[2] + _q * dt2 / 2.0;
+    p[2] += _q * dt;
+}
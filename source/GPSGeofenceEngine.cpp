@@ -0,0 +1,748 @@
+/**
+ ******************************************************************************
+ * @file    GPSGeofenceEngine.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Host-side evaluation of large circular geofence sets.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "GPSGeofenceEngine.h"
+#include "GPSGeofenceIndex.h"
+#include "GPSProviderUtils.h"
+#include "GPSTraceRecorder.h"
+
+#if defined(GPS_LOCATION_FIXED_POINT)
+/* integer kernel only */
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define GPS_GEOFENCE_AVX
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GPS_GEOFENCE_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define GPS_GEOFENCE_NEON
+#endif
+
+static const double R2 = GPS_EARTH_RADIUS_M * GPS_EARTH_RADIUS_M;
+static const double TWO_PI = 2.0 * GPS_PI;
+
+/* single fence version of the kernels below */
+static inline uint8_t
+fenceStatus(GPSCoord_t lat, GPSCoord_t lon, GPSCoord_t fLat, GPSCoord_t fLon, GPSCosine_t cosLat,
+            GPSDistance2_t inner2, GPSDistance2_t outer2, uint8_t base)
+{
+    GPSDistance2_t d2 = GPSFixedPoint::coordDistance2(lat, lon, fLat, fLon, cosLat);
+    return (uint8_t)(base + (d2 < inner2) + (d2 <= outer2));
+}
+
+/*
+ * Status kernels: for fences [0, count) (count a multiple of 4) write
+ *   base + (d^2 <= outer^2) + (d^2 < inner^2)
+ * i.e. UNKNOWN for disabled fences, else OUTSIDE/BOUNDARY/INSIDE.
+ */
+
+#if defined(GPS_GEOFENCE_AVX)
+
+static void
+statusKernel(double lat, double lon, const double *fLat, const double *fLon,
+             const double *cosLat, const double *inner2, const double *outer2,
+             const uint8_t *base, uint8_t *out, unsigned count)
+{
+    const __m256d vLat = _mm256_set1_pd(lat);
+    const __m256d vLon = _mm256_set1_pd(lon);
+    const __m256d vPi = _mm256_set1_pd(GPS_PI);
+    const __m256d vMinusPi = _mm256_set1_pd(-GPS_PI);
+    const __m256d vTwoPi = _mm256_set1_pd(TWO_PI);
+    const __m256d vR2 = _mm256_set1_pd(R2);
+
+    for (unsigned i = 0; i < count; i += 4) {
+        __m256d dLat = _mm256_sub_pd(vLat, _mm256_loadu_pd(&fLat[i]));
+        __m256d dLon = _mm256_sub_pd(vLon, _mm256_loadu_pd(&fLon[i]));
+        /* wrap across the antimeridian */
+        dLon = _mm256_sub_pd(dLon, _mm256_and_pd(_mm256_cmp_pd(dLon, vPi, _CMP_GT_OQ), vTwoPi));
+        dLon = _mm256_add_pd(dLon, _mm256_and_pd(_mm256_cmp_pd(dLon, vMinusPi, _CMP_LT_OQ), vTwoPi));
+        __m256d x = _mm256_mul_pd(dLon, _mm256_loadu_pd(&cosLat[i]));
+        __m256d d2 = _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(dLat, dLat), _mm256_mul_pd(x, x)), vR2);
+        int in = _mm256_movemask_pd(_mm256_cmp_pd(d2, _mm256_loadu_pd(&inner2[i]), _CMP_LT_OQ));
+        int on = _mm256_movemask_pd(_mm256_cmp_pd(d2, _mm256_loadu_pd(&outer2[i]), _CMP_LE_OQ));
+        out[i]     = (uint8_t)(base[i]     + (in & 1)        + (on & 1));
+        out[i + 1] = (uint8_t)(base[i + 1] + ((in >> 1) & 1) + ((on >> 1) & 1));
+        out[i + 2] = (uint8_t)(base[i + 2] + ((in >> 2) & 1) + ((on >> 2) & 1));
+        out[i + 3] = (uint8_t)(base[i + 3] + ((in >> 3) & 1) + ((on >> 3) & 1));
+    }
+}
+
+#elif defined(GPS_GEOFENCE_SSE2)
+
+static void
+statusKernel(double lat, double lon, const double *fLat, const double *fLon,
+             const double *cosLat, const double *inner2, const double *outer2,
+             const uint8_t *base, uint8_t *out, unsigned count)
+{
+    const __m128d vLat = _mm_set1_pd(lat);
+    const __m128d vLon = _mm_set1_pd(lon);
+    const __m128d vPi = _mm_set1_pd(GPS_PI);
+    const __m128d vMinusPi = _mm_set1_pd(-GPS_PI);
+    const __m128d vTwoPi = _mm_set1_pd(TWO_PI);
+    const __m128d vR2 = _mm_set1_pd(R2);
+
+    for (unsigned i = 0; i < count; i += 2) {
+        __m128d dLat = _mm_sub_pd(vLat, _mm_loadu_pd(&fLat[i]));
+        __m128d dLon = _mm_sub_pd(vLon, _mm_loadu_pd(&fLon[i]));
+        /* wrap across the antimeridian */
+        dLon = _mm_sub_pd(dLon, _mm_and_pd(_mm_cmpgt_pd(dLon, vPi), vTwoPi));
+        dLon = _mm_add_pd(dLon, _mm_and_pd(_mm_cmplt_pd(dLon, vMinusPi), vTwoPi));
+        __m128d x = _mm_mul_pd(dLon, _mm_loadu_pd(&cosLat[i]));
+        __m128d d2 = _mm_mul_pd(_mm_add_pd(_mm_mul_pd(dLat, dLat), _mm_mul_pd(x, x)), vR2);
+        int in = _mm_movemask_pd(_mm_cmplt_pd(d2, _mm_loadu_pd(&inner2[i])));
+        int on = _mm_movemask_pd(_mm_cmple_pd(d2, _mm_loadu_pd(&outer2[i])));
+        out[i]     = (uint8_t)(base[i]     + (in & 1)        + (on & 1));
+        out[i + 1] = (uint8_t)(base[i + 1] + ((in >> 1) & 1) + ((on >> 1) & 1));
+    }
+}
+
+#elif defined(GPS_GEOFENCE_NEON)
+
+static void
+statusKernel(double lat, double lon, const double *fLat, const double *fLon,
+             const double *cosLat, const double *inner2, const double *outer2,
+             const uint8_t *base, uint8_t *out, unsigned count)
+{
+    const float64x2_t vLat = vdupq_n_f64(lat);
+    const float64x2_t vLon = vdupq_n_f64(lon);
+    const float64x2_t vPi = vdupq_n_f64(GPS_PI);
+    const float64x2_t vMinusPi = vdupq_n_f64(-GPS_PI);
+    const float64x2_t vTwoPi = vdupq_n_f64(TWO_PI);
+    const float64x2_t vZero = vdupq_n_f64(0.0);
+
+    for (unsigned i = 0; i < count; i += 2) {
+        float64x2_t dLat = vsubq_f64(vLat, vld1q_f64(&fLat[i]));
+        float64x2_t dLon = vsubq_f64(vLon, vld1q_f64(&fLon[i]));
+        /* wrap across the antimeridian */
+        dLon = vsubq_f64(dLon, vbslq_f64(vcgtq_f64(dLon, vPi), vTwoPi, vZero));
+        dLon = vaddq_f64(dLon, vbslq_f64(vcltq_f64(dLon, vMinusPi), vTwoPi, vZero));
+        float64x2_t x = vmulq_f64(dLon, vld1q_f64(&cosLat[i]));
+        float64x2_t d2 = vmulq_n_f64(vfmaq_f64(vmulq_f64(dLat, dLat), x, x), R2);
+        uint64x2_t in = vcltq_f64(d2, vld1q_f64(&inner2[i]));
+        uint64x2_t on = vcleq_f64(d2, vld1q_f64(&outer2[i]));
+        out[i]     = (uint8_t)(base[i]     + (vgetq_lane_u64(in, 0) & 1) + (vgetq_lane_u64(on, 0) & 1));
+        out[i + 1] = (uint8_t)(base[i + 1] + (vgetq_lane_u64(in, 1) & 1) + (vgetq_lane_u64(on, 1) & 1));
+    }
+}
+
+#else
+
+static void
+statusKernel(GPSCoord_t lat, GPSCoord_t lon, const GPSCoord_t *fLat, const GPSCoord_t *fLon,
+             const GPSCosine_t *cosLat, const GPSDistance2_t *inner2, const GPSDistance2_t *outer2,
+             const uint8_t *base, uint8_t *out, unsigned count)
+{
+    for (unsigned i = 0; i < count; i++) {
+        out[i] = fenceStatus(lat, lon, fLat[i], fLon[i], cosLat[i], inner2[i], outer2[i], base[i]);
+    }
+}
+
+#endif
+
+GPSGeofenceEngine::GPSGeofenceEngine() :
+    _fences(NULL),
+    _ids(NULL),
+    _statusInt(NULL),
+    _lat(NULL),
+    _lon(NULL),
+    _cosLat(NULL),
+    _inner2(NULL),
+    _outer2(NULL),
+    _base(NULL),
+    _status(NULL),
+    _newStatus(NULL),
+    _shaped(NULL),
+    _mark(NULL),
+    _active(NULL),
+    _nextActive(NULL),
+    _storage(NULL),
+    _capacity(0),
+    _count(0),
+    _evaluated(0),
+    _shapedCount(0),
+    _index(NULL),
+    _activeCount(0),
+    _epoch(0),
+    _statusCallback(NULL)
+{
+}
+
+GPSGeofenceEngine::~GPSGeofenceEngine()
+{
+    free(_storage);
+}
+
+gps_provider_error_t
+GPSGeofenceEngine::reserve(unsigned capacity)
+{
+    capacity = (capacity + LANES - 1) & ~(LANES - 1);
+    if (capacity <= _capacity) {
+        return GPS_ERROR_NONE;
+    }
+
+    /* one block: the widest columns first to keep them aligned (capacity
+     * is a multiple of LANES) */
+    size_t size = capacity * (2 * sizeof(GPSDistance2_t) + 2 * sizeof(GPSCoord_t) + sizeof(GPSCosine_t) +
+                              sizeof(GPSGeofence *) + 2 * sizeof(int) + 3 * sizeof(uint32_t) +
+                              4 * sizeof(uint8_t));
+    uint8_t *block = (uint8_t *)malloc(size);
+    if (block == NULL) {
+        return GPS_ERROR_NO_MEM;
+    }
+
+    GPSDistance2_t *inner2 = (GPSDistance2_t *)block;
+    GPSDistance2_t *outer2 = &inner2[capacity];
+    GPSCoord_t *lat = (GPSCoord_t *)&outer2[capacity];
+    GPSCoord_t *lon = &lat[capacity];
+    GPSCosine_t *cosLat = (GPSCosine_t *)&lon[capacity];
+    GPSGeofence **fences = (GPSGeofence **)&cosLat[capacity];
+    int *ids = (int *)&fences[capacity];
+    int *statusInt = &ids[capacity];
+    uint32_t *mark = (uint32_t *)&statusInt[capacity];
+    uint32_t *active = &mark[capacity];
+    uint32_t *nextActive = &active[capacity];
+    uint8_t *base = (uint8_t *)&nextActive[capacity];
+    uint8_t *status = &base[capacity];
+    uint8_t *newStatus = &status[capacity];
+    uint8_t *shaped = &newStatus[capacity];
+
+    if (_count > 0) {
+        memcpy(lat, _lat, _count * sizeof(GPSCoord_t));
+        memcpy(lon, _lon, _count * sizeof(GPSCoord_t));
+        memcpy(cosLat, _cosLat, _count * sizeof(GPSCosine_t));
+        memcpy(inner2, _inner2, _count * sizeof(GPSDistance2_t));
+        memcpy(outer2, _outer2, _count * sizeof(GPSDistance2_t));
+        memcpy(fences, _fences, _count * sizeof(GPSGeofence *));
+        memcpy(ids, _ids, _count * sizeof(int));
+        memcpy(statusInt, _statusInt, _count * sizeof(int));
+        memcpy(mark, _mark, _count * sizeof(uint32_t));
+        memcpy(active, _active, _activeCount * sizeof(uint32_t));
+        memcpy(base, _base, _count);
+        memcpy(status, _status, _count);
+        memcpy(shaped, _shaped, _count);
+    }
+    /* padding lanes never match: disabled, negative radii */
+    for (unsigned i = _count; i < capacity; i++) {
+        lat[i] = lon[i] = 0;
+        cosLat[i] = 0;
+        inner2[i] = outer2[i] = -1;
+        base[i] = status[i] = GEOFENCE_STATUS_UNKNOWN;
+        shaped[i] = 0;
+        mark[i] = 0;
+    }
+
+    free(_storage);
+    _storage = block;
+    _capacity = capacity;
+    _lat = lat;
+    _lon = lon;
+    _cosLat = cosLat;
+    _inner2 = inner2;
+    _outer2 = outer2;
+    _fences = fences;
+    _ids = ids;
+    _statusInt = statusInt;
+    _base = base;
+    _status = status;
+    _newStatus = newStatus;
+    _shaped = shaped;
+    _mark = mark;
+    _active = active;
+    _nextActive = nextActive;
+    return GPS_ERROR_NONE;
+}
+
+void
+GPSGeofenceEngine::setSlot(unsigned slot, GPSGeofence *geofence)
+{
+    const GPSGeofence::GeofenceCircle_t &circle = geofence->getGeofenceCircle();
+    double inner = circle.radius - circle.tolerance;
+    double outer = circle.radius + circle.tolerance;
+
+    _fences[slot] = geofence;
+    _ids[slot] = circle.id;
+    _lat[slot] = GPSFixedPoint::toCoord(circle.lat);
+    _lon[slot] = GPSFixedPoint::toCoord(circle.lon);
+    _cosLat[slot] = GPSFixedPoint::toCosine(circle.lat);
+    if (circle.enabled) {
+        _inner2[slot] = GPSFixedPoint::toDistance2((inner > 0.0) ? inner : 0.0);
+        _outer2[slot] = GPSFixedPoint::toDistance2(outer);
+        _base[slot] = GEOFENCE_STATUS_OUTSIDE_CIRCLE;
+    } else {
+        /* disabled fences stay UNKNOWN, like padding lanes */
+        _inner2[slot] = _outer2[slot] = -1;
+        _base[slot] = GEOFENCE_STATUS_UNKNOWN;
+    }
+    _status[slot] = GEOFENCE_STATUS_UNKNOWN;
+    _statusInt[slot] = GEOFENCE_STATUS_UNKNOWN;
+    _shaped[slot] = (geofence->getShape() != GPSGeofence::SHAPE_CIRCLE) ? 1 : 0;
+    _mark[slot] = 0;
+}
+
+void
+GPSGeofenceEngine::clearSlot(unsigned slot)
+{
+    _lat[slot] = _lon[slot] = 0;
+    _cosLat[slot] = 0;
+    _inner2[slot] = _outer2[slot] = -1;
+    _base[slot] = _status[slot] = GEOFENCE_STATUS_UNKNOWN;
+    _shaped[slot] = 0;
+    _mark[slot] = 0;
+}
+
+void
+GPSGeofenceEngine::moveSlot(unsigned from, unsigned to)
+{
+    _fences[to] = _fences[from];
+    _ids[to] = _ids[from];
+    _statusInt[to] = _statusInt[from];
+    _lat[to] = _lat[from];
+    _lon[to] = _lon[from];
+    _cosLat[to] = _cosLat[from];
+    _inner2[to] = _inner2[from];
+    _outer2[to] = _outer2[from];
+    _base[to] = _base[from];
+    _status[to] = _status[from];
+    _shaped[to] = _shaped[from];
+    _mark[to] = _mark[from];
+}
+
+gps_provider_error_t
+GPSGeofenceEngine::indexSlot(unsigned slot)
+{
+    if (_base[slot] == GEOFENCE_STATUS_UNKNOWN) {
+        /* disabled: never a candidate */
+        return GPS_ERROR_NONE;
+    }
+    return indexFence(slot, _fences[slot]);
+}
+
+gps_provider_error_t
+GPSGeofenceEngine::indexFence(unsigned slot, GPSGeofence *geofence)
+{
+    const GPSGeofence::GeofenceCircle_t &circle = geofence->getGeofenceCircle();
+    if (!circle.enabled) {
+        return GPS_ERROR_NONE;
+    }
+    return _index->insert(slot, circle.lat, circle.lon, circle.radius + circle.tolerance);
+}
+
+gps_provider_error_t
+GPSGeofenceEngine::rebuildIndex(void)
+{
+    _index->clear();
+    for (unsigned i = 0; i < _count; i++) {
+        gps_provider_error_t ret = indexSlot(i);
+        if (ret != GPS_ERROR_NONE) {
+            _index->clear();
+            _index = NULL;
+            return ret;
+        }
+    }
+    return GPS_ERROR_NONE;
+}
+
+void
+GPSGeofenceEngine::rebuildActive(void)
+{
+    _activeCount = 0;
+    for (unsigned i = 0; i < _count; i++) {
+        if (isActive(i)) {
+            _active[_activeCount++] = i;
+        }
+    }
+}
+
+bool
+GPSGeofenceEngine::isActive(unsigned slot) const
+{
+    /* inside/boundary, or enabled and not evaluated yet */
+    return (_status[slot] > GEOFENCE_STATUS_OUTSIDE_CIRCLE) ||
+           ((_status[slot] == GEOFENCE_STATUS_UNKNOWN) && (_base[slot] != GEOFENCE_STATUS_UNKNOWN));
+}
+
+unsigned
+GPSGeofenceEngine::findSlot(int id) const
+{
+    for (unsigned i = 0; i < _count; i++) {
+        if (_ids[i] == id) {
+            return i;
+        }
+    }
+    return _count;
+}
+
+gps_provider_error_t
+GPSGeofenceEngine::setIndex(GPSGeofenceIndex *index)
+{
+    _index = index;
+    if (_index == NULL) {
+        return GPS_ERROR_NONE;
+    }
+    rebuildActive();
+    return rebuildIndex();
+}
+
+gps_provider_error_t
+GPSGeofenceEngine::addGeofence(GPSGeofence *geofence)
+{
+    if (_count == _capacity) {
+        gps_provider_error_t ret = reserve((_capacity != 0) ? _capacity * 2 : 64);
+        if (ret != GPS_ERROR_NONE) {
+            return ret;
+        }
+    }
+
+    unsigned slot = _count;
+    setSlot(slot, geofence);
+    if (_index != NULL) {
+        gps_provider_error_t ret = indexSlot(slot);
+        if (ret != GPS_ERROR_NONE) {
+            clearSlot(slot);
+            return ret;
+        }
+    }
+    _count++;
+    _shapedCount += _shaped[slot];
+    if (isActive(slot)) {
+        _active[_activeCount++] = slot;
+    }
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSGeofenceEngine::updateGeofence(GPSGeofence *geofence)
+{
+    unsigned slot = findSlot(geofence->getGeofenceCircle().id);
+    if (slot == _count) {
+        return GPS_ERROR_GEOFENCE_CFG;
+    }
+
+    if (_index != NULL) {
+        /* index the new circle under the spare slot number first: on failure
+         * the old circle and its entries are still in place */
+        gps_provider_error_t ret = indexFence(_count, geofence);
+        if (ret != GPS_ERROR_NONE) {
+            return ret;
+        }
+        _index->remove(slot);
+        _index->move(_count, slot);
+    }
+
+    /* keep the known status so that only real transitions get reported */
+    uint8_t status = _status[slot];
+    _shapedCount -= _shaped[slot];
+    setSlot(slot, geofence);
+    _shapedCount += _shaped[slot];
+    if (_base[slot] != GEOFENCE_STATUS_UNKNOWN) {
+        _status[slot] = status;
+        _statusInt[slot] = status;
+    }
+    geofence->updateGeofenceCircleStatus(_statusInt[slot]);
+
+    if (_base[slot] != GEOFENCE_STATUS_UNKNOWN) {
+        /* re-test it at the next fix */
+        unsigned i = 0;
+        while ((i < _activeCount) && (_active[i] != slot)) {
+            i++;
+        }
+        if (i == _activeCount) {
+            _active[_activeCount++] = slot;
+        }
+    }
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSGeofenceEngine::removeGeofence(int id)
+{
+    unsigned slot = findSlot(id);
+    if (slot == _count) {
+        return GPS_ERROR_GEOFENCE_CFG;
+    }
+
+    unsigned last = _count - 1;
+    _shapedCount -= _shaped[slot];
+    if (_index != NULL) {
+        _index->remove(slot);
+    }
+    if (slot != last) {
+        moveSlot(last, slot);
+        if (_index != NULL) {
+            _index->move(last, slot);
+        }
+    }
+    clearSlot(last);
+    _count--;
+
+    unsigned n = 0;
+    for (unsigned i = 0; i < _activeCount; i++) {
+        if (_active[i] == slot) {
+            continue;
+        }
+        _active[n++] = (_active[i] == last) ? slot : _active[i];
+    }
+    _activeCount = n;
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSGeofenceEngine::configGeofences(GPSGeofence *geofences[], unsigned geofenceCount)
+{
+    gps_provider_error_t ret = reserve(geofenceCount);
+    if (ret != GPS_ERROR_NONE) {
+        return ret;
+    }
+
+    if (_index != NULL) {
+        /* stage the new entries past the live slot numbers, so that a
+         * failure leaves the current set and its index untouched */
+        for (unsigned i = 0; i < geofenceCount; i++) {
+            ret = indexFence(_count + i, geofences[i]);
+            if (ret != GPS_ERROR_NONE) {
+                while (i > 0) {
+                    _index->remove(_count + --i);
+                }
+                return ret;
+            }
+        }
+        for (unsigned i = 0; i < _count; i++) {
+            _index->remove(i);
+        }
+        for (unsigned i = 0; i < geofenceCount; i++) {
+            _index->move(_count + i, i);
+        }
+    }
+
+    _shapedCount = 0;
+    for (unsigned i = 0; i < geofenceCount; i++) {
+        setSlot(i, geofences[i]);
+        _shapedCount += _shaped[i];
+    }
+    for (unsigned i = geofenceCount; i < _count; i++) {
+        clearSlot(i);
+    }
+    _count = geofenceCount;
+    rebuildActive();
+    return GPS_ERROR_NONE;
+}
+
+unsigned
+GPSGeofenceEngine::evaluate(const GPSProvider::LocationUpdateParams_t &location)
+{
+    if (!location.valid || (_count == 0)) {
+        return 0;
+    }
+    if (_index != NULL) {
+        return evaluateIndexed(location);
+    }
+
+    unsigned padded = (_count + LANES - 1) & ~(LANES - 1);
+    statusKernel(GPSFixedPoint::toCoord(location.lat), GPSFixedPoint::toCoord(location.lon),
+                 _lat, _lon, _cosLat, _inner2, _outer2, _base, _newStatus, padded);
+    _evaluated += _count;
+
+    /* the kernel tested the bounding circle of shaped fences: refine the
+     * ones the fix is near */
+    for (unsigned i = 0, n = 0; n < _shapedCount; i++) {
+        if (!_shaped[i]) {
+            continue;
+        }
+        n++;
+        if (_newStatus[i] > GEOFENCE_STATUS_OUTSIDE_CIRCLE) {
+            _newStatus[i] = (uint8_t)_fences[i]->evaluateStatus(location.lat, location.lon);
+        }
+    }
+
+    /* transitions are rare: skip identical blocks wholesale */
+    unsigned changed = 0;
+    bool classified = false;
+    for (unsigned block = 0; block < _count; block += 64) {
+        unsigned end = (block + 64 < _count) ? block + 64 : _count;
+        if (memcmp(&_status[block], &_newStatus[block], end - block) == 0) {
+            continue;
+        }
+        for (unsigned i = block; i < end; i++) {
+            if (_status[i] != _newStatus[i]) {
+                if (applyStatus(i, _newStatus[i])) {
+                    publish(_ids[i], location.utcTime);
+                    changed++;
+                } else {
+                    classified = true;
+                }
+            }
+        }
+    }
+    if (classified) {
+        publish(-1, location.utcTime);
+    }
+    return changed;
+}
+
+unsigned
+GPSGeofenceEngine::evaluateIndexed(const GPSProvider::LocationUpdateParams_t &location)
+{
+    const GPSCoord_t lat = GPSFixedPoint::toCoord(location.lat);
+    const GPSCoord_t lon = GPSFixedPoint::toCoord(location.lon);
+
+    if (++_epoch == 0) {
+        memset(_mark, 0, _count * sizeof(uint32_t));
+        _epoch = 1;
+    }
+
+    /* test the fences of the fix cell, then whatever was inside or pending
+     * (those not in the cell can only be leaving) */
+    unsigned candidateCount;
+    const uint32_t *candidates = _index->query(location.lat, location.lon, candidateCount);
+    unsigned tested = 0;
+    unsigned changed = 0;
+    bool classified = false;
+    unsigned next = 0;
+    for (unsigned pass = 0; pass < 2; pass++) {
+        const uint32_t *slots = (pass == 0) ? candidates : _active;
+        unsigned count = (pass == 0) ? candidateCount : _activeCount;
+        for (unsigned k = 0; k < count; k++) {
+            unsigned i = slots[k];
+            if (_mark[i] == _epoch) {
+                continue;
+            }
+            _mark[i] = _epoch;
+            tested++;
+            uint8_t status = fenceStatus(lat, lon, _lat[i], _lon[i], _cosLat[i],
+                                         _inner2[i], _outer2[i], _base[i]);
+            if (_shaped[i] && (status > GEOFENCE_STATUS_OUTSIDE_CIRCLE)) {
+                status = (uint8_t)_fences[i]->evaluateStatus(location.lat, location.lon);
+            }
+            if (status != _status[i]) {
+                if (applyStatus(i, status)) {
+                    publish(_ids[i], location.utcTime);
+                    changed++;
+                } else {
+                    classified = true;
+                }
+            }
+            if (status > GEOFENCE_STATUS_OUTSIDE_CIRCLE) {
+                _nextActive[next++] = i;
+            }
+        }
+    }
+
+    uint32_t *swap = _active;
+    _active = _nextActive;
+    _nextActive = swap;
+    _activeCount = next;
+    _evaluated += tested;
+    if (classified) {
+        publish(-1, location.utcTime);
+    }
+    return changed;
+}
+
+double
+GPSGeofenceEngine::getBoundaryDistance(GPSProvider::LocationType_t lat, GPSProvider::LocationType_t lon) const
+{
+    const GPSCoord_t fixLat = GPSFixedPoint::toCoord(lat);
+    const GPSCoord_t fixLon = GPSFixedPoint::toCoord(lon);
+
+    double nearest = HUGE_VAL;
+    for (unsigned i = 0; i < _count; i++) {
+        if (_base[i] == GEOFENCE_STATUS_UNKNOWN) {
+            continue;
+        }
+        GPSDistance2_t d2 = GPSFixedPoint::coordDistance2(fixLat, fixLon, _lat[i], _lon[i], _cosLat[i]);
+        double d = GPSFixedPoint::toMeters(d2);
+
+        double edge;
+        if (_shaped[i] && (d2 <= _outer2[i])) {
+            /* within the bounding circle: ask the shape */
+            edge = _fences[i]->boundaryDistance(lat, lon);
+            if (edge < 0.0) {
+                return 0.0;
+            }
+        } else {
+            edge = fabs(d - GPSFixedPoint::toMeters(_outer2[i]));
+            if (!_shaped[i] && (_inner2[i] > 0)) {
+                double inner = fabs(d - GPSFixedPoint::toMeters(_inner2[i]));
+                edge = (inner < edge) ? inner : edge;
+            }
+        }
+        if (edge < nearest) {
+            nearest = edge;
+        }
+    }
+    return nearest;
+}
+
+/*
+ * The first OUTSIDE of a fence is its initial classification, not a
+ * transition: those are published together, once per fix (idAlarm -1),
+ * instead of one status array per fence.
+ */
+bool
+GPSGeofenceEngine::applyStatus(unsigned slot, uint8_t status)
+{
+    bool transition = (_status[slot] != GEOFENCE_STATUS_UNKNOWN) || (status != GEOFENCE_STATUS_OUTSIDE_CIRCLE);
+    _status[slot] = status;
+    _statusInt[slot] = status;
+    _fences[slot]->updateGeofenceCircleStatus(status);
+    return transition;
+}
+
+void
+GPSGeofenceEngine::reportStatus(void)
+{
+    publish(-1, 0);
+}
+
+void
+GPSGeofenceEngine::publish(int idAlarm, uint64_t utcTime)
+{
+    if (_statusCallback == NULL) {
+        return;
+    }
+    GPSProvider::GeofenceStatusParams_t params;
+    GPSProviderUtils::utcMsToTimestamp(utcTime, params.timestamp);
+    params.currentStatus = _statusInt;
+    params.numGeofences = (int)_count;
+    params.idAlarm = idAlarm;
+    GPS_TRACE_SCOPE(TRACE_GEOFENCE_CB, (uint32_t)idAlarm);
+    _statusCallback(&params, GPS_ERROR_NONE);
+}
@@ -0,0 +1,446 @@
+/**
+ ******************************************************************************
+ * @file    GPSGeofenceIndex.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Uniform grid index over circular geofences.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "GPSGeofenceIndex.h"
+#include "GPSProviderUtils.h"
+
+/* meters per degree along a meridian */
+static const double METERS_PER_DEG = GPS_EARTH_RADIUS_M * GPS_DEG_TO_RAD;
+
+GPSGeofenceIndex::GPSGeofenceIndex(double cellSize) :
+    _buckets(NULL),
+    _bucketMask(0),
+    _bucketsUsed(0),
+    _entries(NULL),
+    _entryCapacity(0),
+    _entryCount(0),
+    _entryTop(0),
+    _freeEntry(NONE),
+    _fenceHead(NULL),
+    _oversizePos(NULL),
+    _indexed(NULL),
+    _slotCapacity(0),
+    _oversize(NULL),
+    _oversizeCount(0),
+    _oversizeCapacity(0),
+    _candidates(NULL),
+    _candidateCapacity(0),
+    _fenceCount(0),
+    _queries(0),
+    _candidatesReturned(0)
+{
+    if (!(cellSize >= 10.0)) {
+        cellSize = 10.0;
+    }
+    /* round the pitch so that the columns tile 360 degrees exactly, which
+     * keeps the antimeridian wrap consistent */
+    _cols = (int64_t)ceil(360.0 * METERS_PER_DEG / cellSize);
+    _cellDeg = 360.0 / (double)_cols;
+    _rows = (int64_t)ceil(180.0 / _cellDeg) + 1;
+}
+
+GPSGeofenceIndex::~GPSGeofenceIndex()
+{
+    free(_buckets);
+    free(_entries);
+    free(_fenceHead);
+    free(_oversizePos);
+    free(_indexed);
+    free(_oversize);
+    free(_candidates);
+}
+
+uint64_t
+GPSGeofenceIndex::cellKey(int64_t row, int64_t col) const
+{
+    col %= _cols;
+    if (col < 0) {
+        col += _cols;
+    }
+    return (uint64_t)(row * _cols + col) + 1;
+}
+
+int64_t
+GPSGeofenceIndex::rowOf(double lat) const
+{
+    int64_t row = (int64_t)floor((lat + 90.0) / _cellDeg);
+    if (row < 0) {
+        return 0;
+    }
+    return (row >= _rows) ? _rows - 1 : row;
+}
+
+int64_t
+GPSGeofenceIndex::colOf(double lon) const
+{
+    return (int64_t)floor((lon + 180.0) / _cellDeg);
+}
+
+static uint32_t
+hashKey(uint64_t key)
+{
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+uint32_t
+GPSGeofenceIndex::findBucket(uint64_t key, bool create)
+{
+    if (_buckets == NULL) {
+        if (!create || !growBuckets()) {
+            return NONE;
+        }
+    }
+
+    for (uint32_t i = hashKey(key) & _bucketMask; ; i = (i + 1) & _bucketMask) {
+        if (_buckets[i].key == key) {
+            return i;
+        }
+        if (_buckets[i].key != 0) {
+            continue;
+        }
+        if (!create) {
+            return NONE;
+        }
+        /* keep the load factor under 1/2 */
+        if ((_bucketsUsed + 1) * 2 > _bucketMask + 1) {
+            if (!growBuckets()) {
+                return NONE;
+            }
+            return findBucket(key, true);
+        }
+        _buckets[i].key = key;
+        _buckets[i].head = NONE;
+        _bucketsUsed++;
+        return i;
+    }
+}
+
+bool
+GPSGeofenceIndex::growBuckets(void)
+{
+    uint32_t size = (_buckets != NULL) ? (_bucketMask + 1) * 2 : 1024;
+    Bucket_t *buckets = (Bucket_t *)calloc(size, sizeof(Bucket_t));
+    if (buckets == NULL) {
+        return false;
+    }
+
+    uint32_t mask = size - 1;
+    if (_buckets != NULL) {
+        for (uint32_t b = 0; b <= _bucketMask; b++) {
+            if (_buckets[b].key == 0) {
+                continue;
+            }
+            uint32_t i = hashKey(_buckets[b].key) & mask;
+            while (buckets[i].key != 0) {
+                i = (i + 1) & mask;
+            }
+            buckets[i] = _buckets[b];
+            for (uint32_t e = buckets[i].head; e != NONE; e = _entries[e].cellNext) {
+                _entries[e].bucket = i;
+            }
+        }
+        free(_buckets);
+    }
+    _buckets = buckets;
+    _bucketMask = mask;
+    return true;
+}
+
+uint32_t
+GPSGeofenceIndex::allocEntry(void)
+{
+    if (_freeEntry != NONE) {
+        uint32_t e = _freeEntry;
+        _freeEntry = _entries[e].cellNext;
+        _entryCount++;
+        return e;
+    }
+    if (_entryTop == _entryCapacity) {
+        uint32_t capacity = (_entryCapacity != 0) ? _entryCapacity * 2 : 256;
+        Entry_t *entries = (Entry_t *)realloc(_entries, capacity * sizeof(Entry_t));
+        if (entries == NULL) {
+            return NONE;
+        }
+        _entries = entries;
+        _entryCapacity = capacity;
+    }
+    _entryCount++;
+    return _entryTop++;
+}
+
+bool
+GPSGeofenceIndex::growSlots(uint32_t slot)
+{
+    if (slot < _slotCapacity) {
+        return true;
+    }
+
+    uint32_t capacity = (_slotCapacity != 0) ? _slotCapacity * 2 : 64;
+    if (capacity <= slot) {
+        capacity = slot + 1;
+    }
+    uint32_t *fenceHead = (uint32_t *)realloc(_fenceHead, capacity * sizeof(uint32_t));
+    if (fenceHead == NULL) {
+        return false;
+    }
+    _fenceHead = fenceHead;
+    uint32_t *oversizePos = (uint32_t *)realloc(_oversizePos, capacity * sizeof(uint32_t));
+    if (oversizePos == NULL) {
+        return false;
+    }
+    _oversizePos = oversizePos;
+    uint8_t *indexed = (uint8_t *)realloc(_indexed, capacity);
+    if (indexed == NULL) {
+        return false;
+    }
+    _indexed = indexed;
+
+    for (uint32_t i = _slotCapacity; i < capacity; i++) {
+        _fenceHead[i] = NONE;
+        _oversizePos[i] = NONE;
+        _indexed[i] = 0;
+    }
+    _slotCapacity = capacity;
+    return true;
+}
+
+bool
+GPSGeofenceIndex::growCandidates(unsigned count)
+{
+    if (count <= _candidateCapacity) {
+        return true;
+    }
+    unsigned capacity = (_candidateCapacity != 0) ? _candidateCapacity * 2 : 64;
+    if (capacity < count) {
+        capacity = count;
+    }
+    uint32_t *candidates = (uint32_t *)realloc(_candidates, capacity * sizeof(uint32_t));
+    if (candidates == NULL) {
+        return false;
+    }
+    _candidates = candidates;
+    _candidateCapacity = capacity;
+    return true;
+}
+
+gps_provider_error_t
+GPSGeofenceIndex::insert(uint32_t slot, double lat, double lon, double radius)
+{
+    if (!growSlots(slot)) {
+        return GPS_ERROR_NO_MEM;
+    }
+    if (!(radius > 0.0)) {
+        radius = 0.0;
+    }
+    _indexed[slot] = 1;
+    _fenceCount++;
+
+    double dLat = radius / METERS_PER_DEG;
+    double cosLat = cos(lat * GPS_DEG_TO_RAD);
+    int64_t rowLo = rowOf(lat - dLat);
+    int64_t rowHi = rowOf(lat + dLat);
+    int64_t colLo = 0;
+    int64_t colHi = -1;
+    if ((lat + dLat < 90.0) && (lat - dLat > -90.0) && (cosLat > 1e-6) &&
+        (dLat / cosLat < 180.0)) {
+        double dLon = dLat / cosLat;
+        colLo = colOf(lon - dLon);
+        colHi = colOf(lon + dLon);
+    }
+    uint64_t cells = (uint64_t)(rowHi - rowLo + 1) * (uint64_t)(colHi - colLo + 1);
+
+    if ((colHi < colLo) || (colHi - colLo + 1 > _cols) || (cells > MAX_CELLS_PER_FENCE)) {
+        if (_oversizeCount == _oversizeCapacity) {
+            uint32_t capacity = (_oversizeCapacity != 0) ? _oversizeCapacity * 2 : 16;
+            uint32_t *oversize = (uint32_t *)realloc(_oversize, capacity * sizeof(uint32_t));
+            if (oversize == NULL) {
+                remove(slot);
+                return GPS_ERROR_NO_MEM;
+            }
+            _oversize = oversize;
+            _oversizeCapacity = capacity;
+        }
+        _oversizePos[slot] = _oversizeCount;
+        _oversize[_oversizeCount++] = slot;
+        return GPS_ERROR_NONE;
+    }
+
+    for (int64_t row = rowLo; row <= rowHi; row++) {
+        for (int64_t col = colLo; col <= colHi; col++) {
+            uint32_t b = findBucket(cellKey(row, col), true);
+            uint32_t e = (b != NONE) ? allocEntry() : NONE;
+            if (e == NONE) {
+                remove(slot);
+                return GPS_ERROR_NO_MEM;
+            }
+            Entry_t &entry = _entries[e];
+            uint32_t head = _buckets[b].head;
+            entry.slot = slot;
+            entry.bucket = b;
+            entry.cellNext = head;
+            entry.cellPrev = NONE;
+            entry.fenceNext = _fenceHead[slot];
+            if (head != NONE) {
+                _entries[head].cellPrev = e;
+            }
+            _buckets[b].head = e;
+            _fenceHead[slot] = e;
+        }
+    }
+    return GPS_ERROR_NONE;
+}
+
+void
+GPSGeofenceIndex::remove(uint32_t slot)
+{
+    if ((slot >= _slotCapacity) || !_indexed[slot]) {
+        return;
+    }
+
+    uint32_t e = _fenceHead[slot];
+    while (e != NONE) {
+        Entry_t &entry = _entries[e];
+        uint32_t next = entry.fenceNext;
+        if (entry.cellPrev != NONE) {
+            _entries[entry.cellPrev].cellNext = entry.cellNext;
+        } else {
+            _buckets[entry.bucket].head = entry.cellNext;
+        }
+        if (entry.cellNext != NONE) {
+            _entries[entry.cellNext].cellPrev = entry.cellPrev;
+        }
+        entry.cellNext = _freeEntry;
+        _freeEntry = e;
+        _entryCount--;
+        e = next;
+    }
+    _fenceHead[slot] = NONE;
+
+    uint32_t pos = _oversizePos[slot];
+    if (pos != NONE) {
+        uint32_t last = _oversize[--_oversizeCount];
+        _oversize[pos] = last;
+        _oversizePos[last] = pos;
+        _oversizePos[slot] = NONE;
+    }
+
+    _indexed[slot] = 0;
+    _fenceCount--;
+}
+
+void
+GPSGeofenceIndex::move(uint32_t from, uint32_t to)
+{
+    if ((from == to) || (from >= _slotCapacity) || !_indexed[from] || !growSlots(to)) {
+        return;
+    }
+
+    for (uint32_t e = _fenceHead[from]; e != NONE; e = _entries[e].fenceNext) {
+        _entries[e].slot = to;
+    }
+    _fenceHead[to] = _fenceHead[from];
+    _fenceHead[from] = NONE;
+
+    uint32_t pos = _oversizePos[from];
+    if (pos != NONE) {
+        _oversize[pos] = to;
+    }
+    _oversizePos[to] = pos;
+    _oversizePos[from] = NONE;
+
+    _indexed[to] = 1;
+    _indexed[from] = 0;
+}
+
+void
+GPSGeofenceIndex::clear(void)
+{
+    if (_buckets != NULL) {
+        memset(_buckets, 0, (_bucketMask + 1) * sizeof(Bucket_t));
+    }
+    _bucketsUsed = 0;
+    _entryCount = 0;
+    _entryTop = 0;
+    _freeEntry = NONE;
+    for (uint32_t i = 0; i < _slotCapacity; i++) {
+        _fenceHead[i] = NONE;
+        _oversizePos[i] = NONE;
+        _indexed[i] = 0;
+    }
+    _oversizeCount = 0;
+    _fenceCount = 0;
+}
+
+const uint32_t *
+GPSGeofenceIndex::query(double lat, double lon, unsigned &count)
+{
+    unsigned n = 0;
+    uint32_t b = findBucket(cellKey(rowOf(lat), colOf(lon)), false);
+
+    if (b != NONE) {
+        for (uint32_t e = _buckets[b].head; e != NONE; e = _entries[e].cellNext) {
+            if ((n == _candidateCapacity) && !growCandidates(n + 1)) {
+                break;
+            }
+            _candidates[n++] = _entries[e].slot;
+        }
+    }
+    if ((_oversizeCount > 0) && growCandidates(n + _oversizeCount)) {
+        memcpy(&_candidates[n], _oversize, _oversizeCount * sizeof(uint32_t));
+        n += _oversizeCount;
+    }
+
+    _queries++;
+    _candidatesReturned += n;
+    count = n;
+    return _candidates;
+}
+
+void
+GPSGeofenceIndex::getStats(IndexStats_t &stats) const
+{
+    stats.fences = _fenceCount;
+    stats.cells = _bucketsUsed;
+    stats.entries = _entryCount;
+    stats.oversize = _oversizeCount;
+    stats.queries = _queries;
+    stats.candidates = _candidatesReturned;
+}
@@ -0,0 +1,304 @@
+/**
+ ******************************************************************************
+ * @file    GPSGeofenceScheduler.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Expiration, dwell and notification timing of geofence transitions.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "GPSGeofenceScheduler.h"
+
+static const int ALL_TRANSITIONS = GPSGeofence::GEOFENCE_TRANSITION_ENTER |
+                                   GPSGeofence::GEOFENCE_TRANSITION_EXIT |
+                                   GPSGeofence::GEOFENCE_TRANSITION_DWELL;
+
+GPSGeofenceScheduler::GPSGeofenceScheduler(GPSProvider *gps, uint32_t tickMs) :
+    _gps(gps),
+    _wheel(tickMs),
+    _fences(NULL),
+    _count(0),
+    _loaded(0),
+    _debounceMs(0),
+    _transitionCallback(NULL)
+{
+}
+
+GPSGeofenceScheduler::~GPSGeofenceScheduler()
+{
+    release();
+}
+
+void
+GPSGeofenceScheduler::release(void)
+{
+    for (unsigned i = 0; i < _count; i++) {
+        _wheel.cancel(_fences[i].expiry);
+        _wheel.cancel(_fences[i].debounce);
+        _wheel.cancel(_fences[i].dwell);
+        _wheel.cancel(_fences[i].notify);
+    }
+    free(_fences);
+    _fences = NULL;
+    _count = 0;
+    _loaded = 0;
+}
+
+int
+GPSGeofenceScheduler::compareFences(const void *a, const void *b)
+{
+    const Fence_t *fenceA = (const Fence_t *)a;
+    const Fence_t *fenceB = (const Fence_t *)b;
+    if (fenceA->id != fenceB->id) {
+        return (fenceA->id < fenceB->id) ? -1 : 1;
+    }
+    return (fenceA->position < fenceB->position) ? -1 : ((fenceA->position > fenceB->position) ? 1 : 0);
+}
+
+gps_provider_error_t
+GPSGeofenceScheduler::configGeofences(GPSGeofence *geofences[], unsigned geofenceCount, uint64_t nowMs)
+{
+    release();
+    _wheel.advance(nowMs);
+    if (geofenceCount == 0) {
+        return GPS_ERROR_NONE;
+    }
+
+    _fences = (Fence_t *)malloc(geofenceCount * sizeof(Fence_t));
+    if (_fences == NULL) {
+        return GPS_ERROR_NO_MEM;
+    }
+    /* sort the entries themselves, carrying the position in the caller's list */
+    for (unsigned i = 0; i < geofenceCount; i++) {
+        _fences[i].geofence = geofences[i];
+        _fences[i].id = geofences[i]->getGeofenceCircle().id;
+        _fences[i].position = i;
+    }
+    qsort(_fences, geofenceCount, sizeof(Fence_t), compareFences);
+
+    for (unsigned i = 0; i < geofenceCount; i++) {
+        Fence_t &fence = _fences[i];
+        fence.owner = this;
+        fence.accepted = GEOFENCE_STATUS_UNKNOWN;
+        fence.pending = GEOFENCE_STATUS_UNKNOWN;
+        fence.queued = 0;
+        fence.delivered = 0;
+        fence.inside = false;
+        fence.expired = false;
+        GPSTimerWheel::init(fence.expiry, onExpiry, &fence);
+        GPSTimerWheel::init(fence.debounce, onDebounce, &fence);
+        GPSTimerWheel::init(fence.dwell, onDwell, &fence);
+        GPSTimerWheel::init(fence.notify, onNotify, &fence);
+
+        long expiration = fence.geofence->getExpirationDuration();
+        if (expiration != GPSGeofence::NEVER_EXPIRE) {
+            _wheel.start(fence.expiry, (expiration > 0) ? (uint32_t)expiration : 0);
+        }
+    }
+    _count = geofenceCount;
+    _loaded = geofenceCount;
+    return GPS_ERROR_NONE;
+}
+
+GPSGeofenceScheduler::Fence_t *
+GPSGeofenceScheduler::find(int id)
+{
+    unsigned lo = 0;
+    unsigned hi = _count;
+    while (lo < hi) {
+        unsigned mid = lo + (hi - lo) / 2;
+        if (_fences[mid].id < id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return ((lo < _count) && (_fences[lo].id == id)) ? &_fences[lo] : NULL;
+}
+
+void
+GPSGeofenceScheduler::handleStatus(const GPSProvider::GeofenceStatusParams_t *params, int ret_code)
+{
+    if ((params == NULL) || (ret_code != GPS_ERROR_NONE) || (params->currentStatus == NULL)) {
+        return;
+    }
+
+    unsigned reported = (unsigned)params->numGeofences;
+    if (params->idAlarm < 0) {
+        for (unsigned i = 0; i < _count; i++) {
+            if (_fences[i].position < reported) {
+                raw(_fences[i], params->currentStatus[_fences[i].position]);
+            }
+        }
+        return;
+    }
+
+    Fence_t *fence = find(params->idAlarm);
+    if ((fence != NULL) && (fence->position < reported)) {
+        raw(*fence, params->currentStatus[fence->position]);
+    }
+}
+
+void
+GPSGeofenceScheduler::process(uint64_t nowMs)
+{
+    _wheel.advance(nowMs);
+}
+
+void
+GPSGeofenceScheduler::raw(Fence_t &fence, int status)
+{
+    if (fence.expired || (status == GEOFENCE_STATUS_UNKNOWN) || (status == fence.pending)) {
+        return;
+    }
+    fence.pending = status;
+    if (status == fence.accepted) {
+        /* back to the accepted status before the debounce elapsed */
+        _wheel.cancel(fence.debounce);
+        return;
+    }
+    if (_debounceMs == 0) {
+        accept(fence, status);
+    } else {
+        _wheel.start(fence.debounce, _debounceMs);
+    }
+}
+
+void
+GPSGeofenceScheduler::accept(Fence_t &fence, int status)
+{
+    fence.accepted = status;
+    fence.pending = status;
+
+    if ((status == GEOFENCE_STATUS_INSIDE_CIRCLE) && !fence.inside) {
+        fence.inside = true;
+        notify(fence, GPSGeofence::GEOFENCE_TRANSITION_ENTER);
+        int loitering = fence.geofence->getLoiteringDelay();
+        if (loitering > 0) {
+            _wheel.start(fence.dwell, (uint32_t)loitering);
+        }
+    } else if ((status == GEOFENCE_STATUS_OUTSIDE_CIRCLE) && fence.inside) {
+        fence.inside = false;
+        _wheel.cancel(fence.dwell);
+        notify(fence, GPSGeofence::GEOFENCE_TRANSITION_EXIT);
+    }
+}
+
+void
+GPSGeofenceScheduler::notify(Fence_t &fence, int transition)
+{
+    int mask = fence.geofence->getTransitionTypes();
+    if ((mask != 0 ? mask : ALL_TRANSITIONS) & transition) {
+        if (GPSTimerWheel::isArmed(fence.notify)) {
+            /* rate limited: keep the latest */
+            fence.queued = transition;
+            return;
+        }
+        deliver(fence, transition);
+        int responsiveness = fence.geofence->getNotificationResponsiveness();
+        if (responsiveness > 0) {
+            _wheel.start(fence.notify, (uint32_t)responsiveness);
+        }
+    }
+}
+
+void
+GPSGeofenceScheduler::deliver(Fence_t &fence, int transition)
+{
+    fence.delivered = transition;
+    if (_transitionCallback == NULL) {
+        return;
+    }
+    TransitionParams_t params;
+    params.id = fence.id;
+    params.transition = transition;
+    params.status = fence.accepted;
+    params.timeMs = _wheel.now();
+    _transitionCallback(&params);
+}
+
+void
+GPSGeofenceScheduler::onExpiry(void *context)
+{
+    Fence_t &fence = *(Fence_t *)context;
+    GPSGeofenceScheduler &self = *fence.owner;
+
+    fence.expired = true;
+    self._wheel.cancel(fence.debounce);
+    self._wheel.cancel(fence.dwell);
+    self._wheel.cancel(fence.notify);
+    self.deliver(fence, GEOFENCE_TRANSITION_EXPIRED);
+    if ((self._gps != NULL) && (self._gps->removeGeofence(fence.id) == GPS_ERROR_NONE)) {
+        /* the provider moved its last fence into the freed position; providers
+         * without incremental configuration keep it loaded where it was */
+        unsigned last = --self._loaded;
+        for (unsigned i = 0; i < self._count; i++) {
+            if (self._fences[i].position == last) {
+                self._fences[i].position = fence.position;
+                break;
+            }
+        }
+        fence.position = NOT_LOADED;
+    }
+}
+
+void
+GPSGeofenceScheduler::onDebounce(void *context)
+{
+    Fence_t &fence = *(Fence_t *)context;
+    fence.owner->accept(fence, fence.pending);
+}
+
+void
+GPSGeofenceScheduler::onDwell(void *context)
+{
+    Fence_t &fence = *(Fence_t *)context;
+    if (fence.inside) {
+        fence.owner->notify(fence, GPSGeofence::GEOFENCE_TRANSITION_DWELL);
+    }
+}
+
+void
+GPSGeofenceScheduler::onNotify(void *context)
+{
+    Fence_t &fence = *(Fence_t *)context;
+    GPSGeofenceScheduler &self = *fence.owner;
+
+    int transition = fence.queued;
+    fence.queued = 0;
+    if ((transition == 0) || (transition == fence.delivered)) {
+        return;
+    }
+    self.deliver(fence, transition);
+    self._wheel.start(fence.notify, (uint32_t)fence.geofence->getNotificationResponsiveness());
+}
@@ -0,0 +1,275 @@
+/**
+ ******************************************************************************
+ * @file    GPSGeofenceShadow.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Mirror of the geofences configured in the receiver.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "GPSGeofenceShadow.h"
+
+/* enable/disable/remove commands only carry the id */
+static const unsigned SHORT_COMMAND_BYTES = 28;
+
+GPSGeofenceShadow::GPSGeofenceShadow() :
+    _geofences(NULL),
+    _circles(NULL),
+    _count(0),
+    _capacity(0),
+    _fullBytes(0),
+    _lastBytes(0),
+    _undoValid(false),
+    _undoGeofence(NULL)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+GPSGeofenceShadow::~GPSGeofenceShadow()
+{
+    free(_geofences);
+    free(_circles);
+}
+
+unsigned
+GPSGeofenceShadow::commandBytes(const GPSGeofence::GeofenceCircle_t &circle)
+{
+    char sentence[96];
+    int len = snprintf(sentence, sizeof(sentence), "$PSTMCFGGEOCIR,%d,%d,%.6f,%.6f,%.2f*00\r\n",
+                       circle.id, circle.enabled ? 1 : 0, circle.lat, circle.lon, circle.radius);
+    return (len > 0) ? (unsigned)len : 0;
+}
+
+bool
+GPSGeofenceShadow::grow(unsigned count)
+{
+    if (count <= _capacity) {
+        return true;
+    }
+    unsigned capacity = (_capacity != 0) ? _capacity * 2 : 8;
+    if (capacity < count) {
+        capacity = count;
+    }
+    GPSGeofence **geofences = (GPSGeofence **)realloc(_geofences, capacity * sizeof(GPSGeofence *));
+    if (geofences == NULL) {
+        return false;
+    }
+    _geofences = geofences;
+    GPSGeofence::GeofenceCircle_t *circles =
+        (GPSGeofence::GeofenceCircle_t *)realloc(_circles, capacity * sizeof(GPSGeofence::GeofenceCircle_t));
+    if (circles == NULL) {
+        return false;
+    }
+    _circles = circles;
+    _capacity = capacity;
+    return true;
+}
+
+unsigned
+GPSGeofenceShadow::find(int id, bool &found) const
+{
+    unsigned lo = 0;
+    unsigned hi = _count;
+    while (lo < hi) {
+        unsigned mid = lo + (hi - lo) / 2;
+        if (_circles[mid].id < id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    found = (lo < _count) && (_circles[lo].id == id);
+    return lo;
+}
+
+gps_provider_error_t
+GPSGeofenceShadow::reset(GPSGeofence *geofences[], unsigned geofenceCount)
+{
+    _undoValid = false;
+    _count = 0;
+    _fullBytes = 0;
+    if (!grow(geofenceCount)) {
+        return GPS_ERROR_NO_MEM;
+    }
+
+    /* insertion keeps the mirror sorted; sets are receiver-sized */
+    for (unsigned i = 0; i < geofenceCount; i++) {
+        Command_t cmd;
+        gps_provider_error_t ret = diffAdd(geofences[i], cmd);
+        if (ret != GPS_ERROR_NONE) {
+            return ret;
+        }
+    }
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSGeofenceShadow::diffAdd(GPSGeofence *geofence, Command_t &cmd)
+{
+    const GPSGeofence::GeofenceCircle_t &circle = geofence->getGeofenceCircle();
+    bool found;
+    unsigned pos = find(circle.id, found);
+    cmd = CMD_NONE;
+    if (found) {
+        return GPS_ERROR_GEOFENCE_CFG;
+    }
+    if (!grow(_count + 1)) {
+        return GPS_ERROR_NO_MEM;
+    }
+
+    memmove(&_geofences[pos + 1], &_geofences[pos], (_count - pos) * sizeof(GPSGeofence *));
+    memmove(&_circles[pos + 1], &_circles[pos], (_count - pos) * sizeof(GPSGeofence::GeofenceCircle_t));
+    _geofences[pos] = geofence;
+    _circles[pos] = circle;
+    _count++;
+
+    _lastBytes = commandBytes(circle);
+    _fullBytes += _lastBytes;
+    cmd = CMD_ADD;
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSGeofenceShadow::diffUpdate(GPSGeofence *geofence, Command_t &cmd)
+{
+    const GPSGeofence::GeofenceCircle_t &circle = geofence->getGeofenceCircle();
+    bool found;
+    unsigned pos = find(circle.id, found);
+    cmd = CMD_NONE;
+    if (!found) {
+        return GPS_ERROR_GEOFENCE_CFG;
+    }
+
+    GPSGeofence::GeofenceCircle_t &old = _circles[pos];
+    bool sameCircle = (old.lat == circle.lat) && (old.lon == circle.lon) &&
+                      (old.radius == circle.radius) && (old.tolerance == circle.tolerance);
+    if (sameCircle && (old.enabled == circle.enabled)) {
+        _lastBytes = 0;
+    } else if (sameCircle) {
+        cmd = circle.enabled ? CMD_ENABLE : CMD_DISABLE;
+        _lastBytes = SHORT_COMMAND_BYTES;
+    } else {
+        cmd = CMD_SET;
+        _lastBytes = commandBytes(circle);
+    }
+
+    _undoValid = true;
+    _undoGeofence = _geofences[pos];
+    _undoCircle = old;
+
+    _fullBytes -= commandBytes(old);
+    _fullBytes += commandBytes(circle);
+    _geofences[pos] = geofence;
+    old = circle;
+    return GPS_ERROR_NONE;
+}
+
+void
+GPSGeofenceShadow::revertUpdate(void)
+{
+    if (!_undoValid) {
+        return;
+    }
+    _undoValid = false;
+    bool found;
+    unsigned pos = find(_undoCircle.id, found);
+    if (!found) {
+        return;
+    }
+    _fullBytes -= commandBytes(_circles[pos]);
+    _fullBytes += commandBytes(_undoCircle);
+    _geofences[pos] = _undoGeofence;
+    _circles[pos] = _undoCircle;
+}
+
+void
+GPSGeofenceShadow::swap(GPSGeofenceShadow &other)
+{
+    GPSGeofence **geofences = _geofences;
+    GPSGeofence::GeofenceCircle_t *circles = _circles;
+    unsigned count = _count;
+    unsigned capacity = _capacity;
+    uint32_t fullBytes = _fullBytes;
+
+    _geofences = other._geofences;
+    _circles = other._circles;
+    _count = other._count;
+    _capacity = other._capacity;
+    _fullBytes = other._fullBytes;
+    _undoValid = false;
+
+    other._geofences = geofences;
+    other._circles = circles;
+    other._count = count;
+    other._capacity = capacity;
+    other._fullBytes = fullBytes;
+    other._undoValid = false;
+}
+
+gps_provider_error_t
+GPSGeofenceShadow::diffRemove(int id, Command_t &cmd)
+{
+    bool found;
+    unsigned pos = find(id, found);
+    cmd = CMD_NONE;
+    if (!found) {
+        return GPS_ERROR_GEOFENCE_CFG;
+    }
+
+    _fullBytes -= commandBytes(_circles[pos]);
+    _count--;
+    memmove(&_geofences[pos], &_geofences[pos + 1], (_count - pos) * sizeof(GPSGeofence *));
+    memmove(&_circles[pos], &_circles[pos + 1], (_count - pos) * sizeof(GPSGeofence::GeofenceCircle_t));
+
+    _lastBytes = SHORT_COMMAND_BYTES;
+    cmd = CMD_REMOVE;
+    return GPS_ERROR_NONE;
+}
+
+void
+GPSGeofenceShadow::account(Command_t cmd)
+{
+    uint32_t sent = (cmd != CMD_NONE) ? 1 : 0;
+    uint32_t sentBytes = (cmd != CMD_NONE) ? _lastBytes : 0;
+
+    _stats.commandsSent += sent;
+    _stats.bytesSent += sentBytes;
+    if (_count > sent) {
+        _stats.commandsSaved += _count - sent;
+    }
+    if (_fullBytes > sentBytes) {
+        _stats.bytesSaved += _fullBytes - sentBytes;
+    }
+}
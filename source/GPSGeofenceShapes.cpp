@@ -0,0 +1,314 @@
+/**
+ ******************************************************************************
+ * @file    GPSGeofenceShapes.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Polygon and corridor geofences.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <stdlib.h>
+#include <math.h>
+#include "GPSGeofenceShapes.h"
+#include "GPSProviderUtils.h"
+
+static const double METERS_PER_DEG = GPS_EARTH_RADIUS_M * GPS_DEG_TO_RAD;
+
+static double
+wrapDegrees(double lon)
+{
+    if (lon > 180.0) {
+        return lon - 360.0;
+    }
+    if (lon < -180.0) {
+        return lon + 360.0;
+    }
+    return lon;
+}
+
+GPSShapeGeofence::GPSShapeGeofence() :
+    _edges(NULL),
+    _edgeCount(0),
+    _vertexCount(0),
+    _lat0(0.0),
+    _lon0(0.0),
+    _cosLat0(1.0),
+    _minX(0.0),
+    _maxX(-1.0),
+    _minY(0.0),
+    _maxY(-1.0)
+{
+    _geofenceCircle.id = 0;
+    _geofenceCircle.enabled = false;
+    _geofenceCircle.tolerance = 0;
+    _geofenceCircle.lat = 0.0;
+    _geofenceCircle.lon = 0.0;
+    _geofenceCircle.radius = 0.0;
+    _geofenceCircle.status = GEOFENCE_STATUS_UNKNOWN;
+}
+
+GPSShapeGeofence::~GPSShapeGeofence()
+{
+    free(_edges);
+}
+
+void
+GPSShapeGeofence::project(GPSProvider::LocationType_t lat, GPSProvider::LocationType_t lon,
+                          double &x, double &y) const
+{
+    x = wrapDegrees(lon - _lon0) * _cosLat0 * METERS_PER_DEG;
+    y = (lat - _lat0) * METERS_PER_DEG;
+}
+
+gps_provider_error_t
+GPSShapeGeofence::buildEdges(int id, const GPSProvider::LocationType_t *lat,
+                             const GPSProvider::LocationType_t *lon, unsigned count,
+                             bool closed, double margin, int tolerance, bool enabled)
+{
+    unsigned edgeCount = closed ? count : count - 1;
+    Edge_t *edges = (Edge_t *)malloc(edgeCount * sizeof(Edge_t));
+    if (edges == NULL) {
+        return GPS_ERROR_NO_MEM;
+    }
+    free(_edges);
+    _edges = edges;
+    _edgeCount = edgeCount;
+    _vertexCount = count;
+
+    /* center of the bounding box, longitudes taken relative to the first
+     * vertex so that shapes across the antimeridian stay contiguous */
+    double minLat = lat[0], maxLat = lat[0];
+    double minLon = 0.0, maxLon = 0.0;
+    for (unsigned i = 1; i < count; i++) {
+        double relLon = wrapDegrees(lon[i] - lon[0]);
+        minLat = (lat[i] < minLat) ? lat[i] : minLat;
+        maxLat = (lat[i] > maxLat) ? lat[i] : maxLat;
+        minLon = (relLon < minLon) ? relLon : minLon;
+        maxLon = (relLon > maxLon) ? relLon : maxLon;
+    }
+    _lat0 = (minLat + maxLat) / 2.0;
+    _lon0 = wrapDegrees(lon[0] + (minLon + maxLon) / 2.0);
+    _cosLat0 = cos(_lat0 * GPS_DEG_TO_RAD);
+
+    double radius2 = 0.0;
+    double x, y;
+    project(lat[0], lon[0], x, y);
+    _minX = _maxX = x;
+    _minY = _maxY = y;
+    for (unsigned i = 0; i < edgeCount; i++) {
+        unsigned j = (i + 1 < count) ? i + 1 : 0;
+        double x1, y1;
+        project(lat[j], lon[j], x1, y1);
+
+        Edge_t &edge = _edges[i];
+        edge.x0 = x;
+        edge.y0 = y;
+        edge.dx = x1 - x;
+        edge.dy = y1 - y;
+        double len2 = edge.dx * edge.dx + edge.dy * edge.dy;
+        edge.invLen2 = (len2 > 0.0) ? 1.0 / len2 : 0.0;
+        edge.xPerY = (edge.dy != 0.0) ? edge.dx / edge.dy : 0.0;
+
+        double r2 = x * x + y * y;
+        radius2 = (r2 > radius2) ? r2 : radius2;
+        x = x1;
+        y = y1;
+        _minX = (x < _minX) ? x : _minX;
+        _maxX = (x > _maxX) ? x : _maxX;
+        _minY = (y < _minY) ? y : _minY;
+        _maxY = (y > _maxY) ? y : _maxY;
+    }
+    double r2 = x * x + y * y;
+    radius2 = (r2 > radius2) ? r2 : radius2;
+
+    double pad = margin + ((tolerance > 0) ? tolerance : 0);
+    _minX -= pad;
+    _maxX += pad;
+    _minY -= pad;
+    _maxY += pad;
+
+    _geofenceCircle.id = id;
+    _geofenceCircle.enabled = enabled;
+    _geofenceCircle.tolerance = tolerance;
+    _geofenceCircle.lat = _lat0;
+    _geofenceCircle.lon = _lon0;
+    _geofenceCircle.radius = sqrt(radius2) + margin;
+    _geofenceCircle.status = GEOFENCE_STATUS_UNKNOWN;
+    return GPS_ERROR_NONE;
+}
+
+bool
+GPSShapeGeofence::inBoundingBox(double x, double y) const
+{
+    return (x >= _minX) && (x <= _maxX) && (y >= _minY) && (y <= _maxY);
+}
+
+double
+GPSShapeGeofence::distance2(double x, double y) const
+{
+    double best = HUGE_VAL;
+    for (unsigned i = 0; i < _edgeCount; i++) {
+        const Edge_t &edge = _edges[i];
+        double px = x - edge.x0;
+        double py = y - edge.y0;
+        double t = (px * edge.dx + py * edge.dy) * edge.invLen2;
+        t = (t < 0.0) ? 0.0 : ((t > 1.0) ? 1.0 : t);
+        double ex = px - t * edge.dx;
+        double ey = py - t * edge.dy;
+        double d2 = ex * ex + ey * ey;
+        best = (d2 < best) ? d2 : best;
+    }
+    return best;
+}
+
+bool
+GPSShapeGeofence::contains(double x, double y) const
+{
+    /* even-odd crossing count of a ray towards -x */
+    bool inside = false;
+    for (unsigned i = 0; i < _edgeCount; i++) {
+        const Edge_t &edge = _edges[i];
+        if ((edge.y0 > y) == (edge.y0 + edge.dy > y)) {
+            continue;
+        }
+        if (x < edge.x0 + (y - edge.y0) * edge.xPerY) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+/*
+ * Polygon
+ */
+
+gps_provider_error_t
+GPSPolygonGeofence::setPolygon(int id, const GPSProvider::LocationType_t *lat,
+                               const GPSProvider::LocationType_t *lon, unsigned count,
+                               int tolerance, bool enabled)
+{
+    if (count < 3) {
+        return GPS_ERROR_GEOFENCE_CFG;
+    }
+    return buildEdges(id, lat, lon, count, true, 0.0, tolerance, enabled);
+}
+
+int
+GPSPolygonGeofence::evaluateStatus(GPSProvider::LocationType_t lat, GPSProvider::LocationType_t lon) const
+{
+    if (!_geofenceCircle.enabled || (_edgeCount == 0)) {
+        return GEOFENCE_STATUS_UNKNOWN;
+    }
+
+    double x, y;
+    project(lat, lon, x, y);
+    if (!inBoundingBox(x, y)) {
+        return GEOFENCE_STATUS_OUTSIDE_CIRCLE;
+    }
+
+    double tolerance = _geofenceCircle.tolerance;
+    if ((tolerance > 0.0) && (distance2(x, y) <= tolerance * tolerance)) {
+        return GEOFENCE_STATUS_BOUNDARY_CIRCLE;
+    }
+    return contains(x, y) ? GEOFENCE_STATUS_INSIDE_CIRCLE : GEOFENCE_STATUS_OUTSIDE_CIRCLE;
+}
+
+double
+GPSPolygonGeofence::boundaryDistance(GPSProvider::LocationType_t lat, GPSProvider::LocationType_t lon) const
+{
+    if (!_geofenceCircle.enabled || (_edgeCount == 0)) {
+        return -1.0;
+    }
+
+    double x, y;
+    project(lat, lon, x, y);
+    double tolerance = (_geofenceCircle.tolerance > 0) ? _geofenceCircle.tolerance : 0.0;
+    return fabs(sqrt(distance2(x, y)) - tolerance);
+}
+
+/*
+ * Corridor
+ */
+
+gps_provider_error_t
+GPSCorridorGeofence::setCorridor(int id, const GPSProvider::LocationType_t *lat,
+                                 const GPSProvider::LocationType_t *lon, unsigned count,
+                                 double halfWidth, int tolerance, bool enabled)
+{
+    if ((count < 2) || !(halfWidth > 0.0)) {
+        return GPS_ERROR_GEOFENCE_CFG;
+    }
+    _halfWidth = halfWidth;
+    return buildEdges(id, lat, lon, count, false, halfWidth, tolerance, enabled);
+}
+
+int
+GPSCorridorGeofence::evaluateStatus(GPSProvider::LocationType_t lat, GPSProvider::LocationType_t lon) const
+{
+    if (!_geofenceCircle.enabled || (_edgeCount == 0)) {
+        return GEOFENCE_STATUS_UNKNOWN;
+    }
+
+    double x, y;
+    project(lat, lon, x, y);
+    if (!inBoundingBox(x, y)) {
+        return GEOFENCE_STATUS_OUTSIDE_CIRCLE;
+    }
+
+    double tolerance = (_geofenceCircle.tolerance > 0) ? _geofenceCircle.tolerance : 0.0;
+    double inner = _halfWidth - tolerance;
+    double outer = _halfWidth + tolerance;
+    double d2 = distance2(x, y);
+    if ((inner > 0.0) && (d2 < inner * inner)) {
+        return GEOFENCE_STATUS_INSIDE_CIRCLE;
+    }
+    return (d2 <= outer * outer) ? GEOFENCE_STATUS_BOUNDARY_CIRCLE : GEOFENCE_STATUS_OUTSIDE_CIRCLE;
+}
+
+double
+GPSCorridorGeofence::boundaryDistance(GPSProvider::LocationType_t lat, GPSProvider::LocationType_t lon) const
+{
+    if (!_geofenceCircle.enabled || (_edgeCount == 0)) {
+        return -1.0;
+    }
+
+    double x, y;
+    project(lat, lon, x, y);
+    double tolerance = (_geofenceCircle.tolerance > 0) ? _geofenceCircle.tolerance : 0.0;
+    double inner = _halfWidth - tolerance;
+    double d = sqrt(distance2(x, y));
+    double nearest = fabs(d - (_halfWidth + tolerance));
+    if ((inner > 0.0) && (fabs(d - inner) < nearest)) {
+        nearest = fabs(d - inner);
+    }
+    return nearest;
+}
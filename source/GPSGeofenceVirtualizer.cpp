@@ -0,0 +1,335 @@
+/**
+ ******************************************************************************
+ * @file    GPSGeofenceVirtualizer.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Keeps the receiver loaded with the geofences nearest to the device.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "GPSGeofenceVirtualizer.h"
+#include "GPSProviderUtils.h"
+
+GPSGeofenceVirtualizer::GPSGeofenceVirtualizer(GPSProvider &gps, unsigned slots) :
+    _gps(gps),
+    _slots((slots >= 2) ? slots : 2),
+    _fences(NULL),
+    _status(NULL),
+    _edge(NULL),
+    _order(NULL),
+    _count(0),
+    _loaded(NULL),
+    _loadedIndex(NULL),
+    _loadedCount(0),
+    _recomputeLoaded(false),
+    _recomputePending(false),
+    _statusCallback(NULL)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+GPSGeofenceVirtualizer::~GPSGeofenceVirtualizer()
+{
+    free(_fences);
+    free(_status);
+    free(_edge);
+    free(_order);
+    free(_loaded);
+    free(_loadedIndex);
+}
+
+gps_provider_error_t
+GPSGeofenceVirtualizer::configGeofences(GPSGeofence *geofences[], unsigned geofenceCount)
+{
+    GPSGeofence **fences = (GPSGeofence **)malloc((geofenceCount + 1) * sizeof(GPSGeofence *));
+    int *status = (int *)malloc((geofenceCount + 1) * sizeof(int));
+    double *edge = (double *)malloc((geofenceCount + 1) * sizeof(double));
+    uint32_t *order = (uint32_t *)malloc((geofenceCount + 1) * sizeof(uint32_t));
+    if (_loaded == NULL) {
+        _loaded = (GPSGeofence **)malloc(_slots * sizeof(GPSGeofence *));
+    }
+    if (_loadedIndex == NULL) {
+        _loadedIndex = (uint32_t *)malloc(_slots * sizeof(uint32_t));
+    }
+    if ((fences == NULL) || (status == NULL) || (edge == NULL) || (order == NULL) ||
+        (_loaded == NULL) || (_loadedIndex == NULL)) {
+        /* the current set stays configured */
+        free(fences);
+        free(status);
+        free(edge);
+        free(order);
+        return GPS_ERROR_NO_MEM;
+    }
+
+    free(_fences);
+    free(_status);
+    free(_edge);
+    free(_order);
+    _fences = fences;
+    _status = status;
+    _edge = edge;
+    _order = order;
+    _count = 0;
+    _loadedCount = 0;
+    _recomputeLoaded = false;
+    _recomputePending = false;
+
+    for (unsigned i = 0; i < geofenceCount; i++) {
+        _fences[i] = geofences[i];
+        _status[i] = GEOFENCE_STATUS_UNKNOWN;
+    }
+    _count = geofenceCount;
+    _stats.fences = geofenceCount;
+
+    /* a set that fits is loaded once and for all; otherwise the selection
+     * needs a position */
+    const GPSProvider::LocationUpdateParams_t *location = _gps.getLastLocation();
+    select(location);
+    if ((location == NULL) && (_loadedCount < _count)) {
+        _recomputePending = true;
+        return GPS_ERROR_NONE;
+    }
+    return push();
+}
+
+void
+GPSGeofenceVirtualizer::select(const GPSProvider::LocationUpdateParams_t *location)
+{
+    unsigned n = 0;
+    for (unsigned i = 0; i < _count; i++) {
+        if (_fences[i]->getGeofenceCircle().enabled) {
+            _order[n++] = i;
+        }
+    }
+
+    _recomputeLoaded = false;
+    if ((n <= _slots) || (location == NULL)) {
+        _loadedCount = (n <= _slots) ? n : 0;
+        for (unsigned k = 0; k < _loadedCount; k++) {
+            _loadedIndex[k] = _order[k];
+            _loaded[k] = _fences[_order[k]];
+        }
+        return;
+    }
+
+    /* one conversion of the fix for the whole set */
+    const GPSLocalFrame::Point_t &point = _frame.update(*location);
+    for (unsigned k = 0; k < n; k++) {
+        const GPSGeofence::GeofenceCircle_t &circle = _fences[_order[k]]->getGeofenceCircle();
+        _edge[_order[k]] = GPSLocalFrame::distanceTo(point, circle.lat, circle.lon) -
+                           (circle.radius + circle.tolerance);
+    }
+
+    /* quickselect: the `keep` nearest fence bands end up in front of
+     * _order[keep], the nearest one left out */
+    const unsigned keep = _slots - 1;
+    unsigned lo = 0;
+    unsigned hi = n - 1;
+    while (lo < hi) {
+        double pivot = _edge[_order[lo + (hi - lo) / 2]];
+        unsigned i = lo;
+        unsigned j = hi;
+        while (i <= j) {
+            while (_edge[_order[i]] < pivot) {
+                i++;
+            }
+            while (_edge[_order[j]] > pivot) {
+                j--;
+            }
+            if (i <= j) {
+                uint32_t swap = _order[i];
+                _order[i] = _order[j];
+                _order[j] = swap;
+                i++;
+                if (j == 0) {
+                    break;
+                }
+                j--;
+            }
+        }
+        if (keep <= j) {
+            hi = j;
+        } else if (keep >= i) {
+            lo = i;
+        } else {
+            break;
+        }
+    }
+
+    _loadedCount = keep;
+    for (unsigned k = 0; k < keep; k++) {
+        _loadedIndex[k] = _order[k];
+        _loaded[k] = _fences[_order[k]];
+    }
+    /* fences left out are provably outside, unless the device is within
+     * more fences than the receiver holds; report the exits the receiver
+     * will no longer see */
+    GPSProvider::Timestamp_t timestamp;
+    GPSProviderUtils::utcMsToTimestamp(location->utcTime, timestamp);
+    for (unsigned k = keep; k < n; k++) {
+        unsigned i = _order[k];
+        if ((_edge[i] <= 0.0) || (_status[i] == GEOFENCE_STATUS_OUTSIDE_CIRCLE)) {
+            continue;
+        }
+        bool known = (_status[i] != GEOFENCE_STATUS_UNKNOWN);
+        _status[i] = GEOFENCE_STATUS_OUTSIDE_CIRCLE;
+        if (known) {
+            _stats.forwardedEvents++;
+            publish(timestamp, _fences[i]->getGeofenceCircle().id, GPS_ERROR_NONE);
+        }
+    }
+
+    double radius = _edge[_order[keep]] / 2.0;
+    if (radius < MIN_RECOMPUTE_RADIUS) {
+        radius = MIN_RECOMPUTE_RADIUS;
+    }
+    GPSGeofence::GeofenceCircle_t circle;
+    circle.id = RECOMPUTE_FENCE_ID;
+    circle.enabled = true;
+    circle.tolerance = 0;
+    circle.lat = location->lat;
+    circle.lon = location->lon;
+    circle.radius = radius;
+    circle.status = GEOFENCE_STATUS_UNKNOWN;
+    _recompute.setGeofenceCircle(circle);
+    _loaded[keep] = &_recompute;
+    _recomputeLoaded = true;
+    _stats.recomputeRadius = (uint32_t)radius;
+    _stats.recomputations++;
+}
+
+gps_provider_error_t
+GPSGeofenceVirtualizer::push(void)
+{
+    _stats.loaded = _loadedCount;
+    _stats.configTransactions++;
+    return _gps.configGeofences(_loaded, _loadedCount + (_recomputeLoaded ? 1 : 0));
+}
+
+gps_provider_error_t
+GPSGeofenceVirtualizer::update(const GPSProvider::LocationUpdateParams_t &location)
+{
+    _recomputePending = false;
+    select(&location);
+    return push();
+}
+
+void
+GPSGeofenceVirtualizer::process(void)
+{
+    if (!_recomputePending) {
+        return;
+    }
+    const GPSProvider::LocationUpdateParams_t *location = _gps.getLastLocation();
+    if (location != NULL) {
+        update(*location);
+    }
+}
+
+unsigned
+GPSGeofenceVirtualizer::loadedIndexOf(int id) const
+{
+    for (unsigned k = 0; k < _loadedCount; k++) {
+        if (_loaded[k]->getGeofenceCircle().id == id) {
+            return k;
+        }
+    }
+    return _loadedCount;
+}
+
+void
+GPSGeofenceVirtualizer::handleStatus(const GPSProvider::GeofenceStatusParams_t *params, int ret_code)
+{
+    _stats.receiverMessages++;
+    if (params == NULL) {
+        return;
+    }
+    if (ret_code != GPS_ERROR_NONE) {
+        publish(params->timestamp, params->idAlarm, ret_code);
+        return;
+    }
+
+    const int *current = params->currentStatus;
+    unsigned reported = (current != NULL) ? (unsigned)params->numGeofences : 0;
+
+    if (params->idAlarm == RECOMPUTE_FENCE_ID) {
+        if (_recomputeLoaded && (_loadedCount < reported) &&
+            (current[_loadedCount] == GEOFENCE_STATUS_OUTSIDE_CIRCLE)) {
+            _recomputePending = true;
+        }
+        return;
+    }
+
+    if (params->idAlarm < 0) {
+        /* status request: refresh every loaded fence */
+        for (unsigned k = 0; (k < _loadedCount) && (k < reported); k++) {
+            if (current[k] != GEOFENCE_STATUS_UNKNOWN) {
+                _status[_loadedIndex[k]] = current[k];
+            }
+        }
+        publish(params->timestamp, params->idAlarm, ret_code);
+        return;
+    }
+
+    unsigned k = loadedIndexOf(params->idAlarm);
+    if ((k >= reported) || (current[k] == GEOFENCE_STATUS_UNKNOWN) ||
+        (current[k] == _status[_loadedIndex[k]])) {
+        /* stale, or a freshly loaded fence confirming what we knew */
+        _stats.suppressedEvents++;
+        return;
+    }
+    _status[_loadedIndex[k]] = current[k];
+    _stats.forwardedEvents++;
+    publish(params->timestamp, params->idAlarm, ret_code);
+}
+
+void
+GPSGeofenceVirtualizer::publish(const GPSProvider::Timestamp_t &timestamp, int idAlarm, int ret_code)
+{
+    if (_statusCallback == NULL) {
+        return;
+    }
+    GPSProvider::GeofenceStatusParams_t params;
+    params.timestamp = timestamp;
+    params.currentStatus = _status;
+    params.numGeofences = (int)_count;
+    params.idAlarm = idAlarm;
+    _statusCallback(&params, ret_code);
+}
+
+void
+GPSGeofenceVirtualizer::getStats(VirtualizerStats_t &stats) const
+{
+    stats = _stats;
+}
@@ -0,0 +1,145 @@
+/**
+ ******************************************************************************
+ * @file    GPSGeofenceWakeup.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Time-to-boundary planning of geofence checks.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <math.h>
+#include <string.h>
+#include "GPSGeofenceWakeup.h"
+#include "GPSGeofenceEngine.h"
+
+GPSGeofenceWakeup::GPSGeofenceWakeup(const GPSGeofenceEngine &engine) :
+    _engine(engine),
+    _minIntervalMs(1000),
+    _maxIntervalMs(600000),
+    _maxAccel(2.0),
+    _margin(10.0)
+{
+    reset();
+}
+
+void
+GPSGeofenceWakeup::reset(void)
+{
+    memset(&_lastPoint, 0, sizeof(_lastPoint));
+    _lastCheck = 0;
+    _firstCheck = 0;
+    _nextCheck = 0;
+    _delayMs = 0;
+    _speed = 0.0;
+    _distance = 0.0;
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+uint64_t
+GPSGeofenceWakeup::update(const GPSProvider::LocationUpdateParams_t &location)
+{
+    if (!location.valid) {
+        return update(location, _frame.getPoint());
+    }
+    return update(location, _frame.update(location));
+}
+
+uint64_t
+GPSGeofenceWakeup::update(const GPSProvider::LocationUpdateParams_t &location, const GPSLocalFrame::Point_t &point)
+{
+    if (!location.valid) {
+        /* no position: try again as soon as allowed */
+        _delayMs = _minIntervalMs;
+        _nextCheck = location.utcTime + _delayMs;
+        return _nextCheck;
+    }
+
+    _distance = _engine.getBoundaryDistance(location.lat, location.lon);
+
+    double seconds;
+    if ((_lastCheck == 0) || (location.utcTime <= _lastCheck)) {
+        /* speed unknown */
+        _speed = 0.0;
+        seconds = 0.0;
+    } else {
+        double dt = (double)(location.utcTime - _lastCheck) / 1000.0;
+        double moved = GPSLocalFrame::distance(_lastPoint, point);
+        _speed = moved / dt + _maxAccel * dt / 2.0;
+
+        double reach = _distance - _margin;
+        if (reach <= 0.0) {
+            seconds = 0.0;
+        } else if (_maxAccel > 0.0) {
+            seconds = (sqrt(_speed * _speed + 2.0 * _maxAccel * reach) - _speed) / _maxAccel;
+        } else if (_speed > 0.0) {
+            seconds = reach / _speed;
+        } else {
+            seconds = HUGE_VAL;
+        }
+    }
+
+    if (seconds * 1000.0 <= (double)_minIntervalMs) {
+        _delayMs = _minIntervalMs;
+        _stats.shortest++;
+    } else if (seconds * 1000.0 >= (double)_maxIntervalMs) {
+        _delayMs = _maxIntervalMs;
+        _stats.longest++;
+    } else {
+        _delayMs = (uint32_t)(seconds * 1000.0);
+    }
+
+    if (_firstCheck == 0) {
+        _firstCheck = location.utcTime;
+    }
+    _stats.checks++;
+    _stats.spanMs = location.utcTime - _firstCheck;
+
+    _lastPoint = point;
+    _lastCheck = location.utcTime;
+    _nextCheck = location.utcTime + _delayMs;
+    return _nextCheck;
+}
+
+uint32_t
+GPSGeofenceWakeup::getFixedPollingChecks(uint32_t periodMs) const
+{
+    if ((periodMs == 0) || (_stats.checks == 0)) {
+        return _stats.checks;
+    }
+    return (uint32_t)(_stats.spanMs / periodMs) + 1;
+}
+
+void
+GPSGeofenceWakeup::getStats(WakeupStats_t &stats) const
+{
+    stats = _stats;
+}
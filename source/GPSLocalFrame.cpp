@@ -0,0 +1,169 @@
+/**
+ ******************************************************************************
+ * @file    GPSLocalFrame.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Local east-north frame shared by the per-fix distance math.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <string.h>
+#include <math.h>
+#include "GPSLocalFrame.h"
+#include "GPSProviderUtils.h"
+
+/* latitude offset (radians) up to which cos() is derived from the origin
+ * terms; the truncated series is then accurate to ~1e-13 */
+static const double SERIES_LAT = 2e-3;
+
+static const double METERS_PER_RAD = GPS_EARTH_RADIUS_M;
+
+static double
+wrapLon(double dLon)
+{
+    if (dLon > 180.0) {
+        dLon -= 360.0;
+    } else if (dLon < -180.0) {
+        dLon += 360.0;
+    }
+    return dLon;
+}
+
+GPSLocalFrame::GPSLocalFrame() :
+    _haveOrigin(false),
+    _reanchor(10000.0),
+    _originLat(0.0),
+    _originLon(0.0),
+    _originLatRad(0.0),
+    _cos0(1.0),
+    _sin0(0.0)
+{
+    memset(&_point, 0, sizeof(_point));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void
+GPSLocalFrame::setReanchorDistance(double meters)
+{
+    /* beyond SERIES_LAT every conversion would need a cos() */
+    const double limit = SERIES_LAT * METERS_PER_RAD;
+    _reanchor = (meters > 0.0) ? ((meters < limit) ? meters : limit) : limit;
+}
+
+void
+GPSLocalFrame::anchor(double lat, double lon)
+{
+    _originLat = lat;
+    _originLon = lon;
+    _originLatRad = lat * GPS_DEG_TO_RAD;
+    _cos0 = cos(_originLatRad);
+    double s = sqrt(fabs(1.0 - _cos0 * _cos0));
+    _sin0 = (lat < 0.0) ? -s : s;
+    _haveOrigin = true;
+    _stats.trigCalls++;
+    _stats.reanchors++;
+}
+
+void
+GPSLocalFrame::convert(double lat, double lon, Point_t &point)
+{
+    double d = lat * GPS_DEG_TO_RAD - _originLatRad;
+    double cosLat;
+    if ((d <= SERIES_LAT) && (d >= -SERIES_LAT)) {
+        /* cos(lat0 + d) with cos(d), sin(d) from their series */
+        double d2 = d * d;
+        double cosD = 1.0 - d2 * (0.5 - d2 * (1.0 / 24.0));
+        double sinD = d * (1.0 - d2 * (1.0 / 6.0));
+        cosLat = _cos0 * cosD - _sin0 * sinD;
+    } else {
+        cosLat = cos(lat * GPS_DEG_TO_RAD);
+        _stats.trigCalls++;
+    }
+
+    point.lat = lat;
+    point.lon = lon;
+    point.cosLat = cosLat;
+    point.east = wrapLon(lon - _originLon) * GPS_DEG_TO_RAD * METERS_PER_RAD * 0.5 * (_cos0 + cosLat);
+    point.north = d * METERS_PER_RAD;
+#if defined(GPS_LOCATION_FIXED_POINT)
+    point.latUnits = GPSFixedPoint::toUnits(lat);
+    point.lonUnits = GPSFixedPoint::toUnits(lon);
+    point.cosQ30 = (int32_t)(cosLat * (double)(1L << 30));
+#endif
+}
+
+const GPSLocalFrame::Point_t &
+GPSLocalFrame::update(const GPSProvider::LocationUpdateParams_t &location)
+{
+    _stats.fixes++;
+    if (!_haveOrigin) {
+        anchor(location.lat, location.lon);
+    }
+    convert(location.lat, location.lon, _point);
+    if ((fabs(_point.east) > _reanchor) || (fabs(_point.north) > _reanchor)) {
+        anchor(location.lat, location.lon);
+        _point.cosLat = _cos0;
+#if defined(GPS_LOCATION_FIXED_POINT)
+        _point.cosQ30 = (int32_t)(_cos0 * (double)(1L << 30));
+#endif
+        _point.east = 0.0;
+        _point.north = 0.0;
+    }
+    return _point;
+}
+
+void
+GPSLocalFrame::project(double lat, double lon, Point_t &point)
+{
+    _stats.projected++;
+    if (!_haveOrigin) {
+        anchor(lat, lon);
+    }
+    convert(lat, lon, point);
+}
+
+double
+GPSLocalFrame::distance(const Point_t &a, const Point_t &b)
+{
+    /* the mean of the cosines is cos(mean latitude) to O(dLat^2) */
+    double x = wrapLon(b.lon - a.lon) * 0.5 * (a.cosLat + b.cosLat);
+    double y = b.lat - a.lat;
+    return sqrt(x * x + y * y) * (GPS_DEG_TO_RAD * METERS_PER_RAD);
+}
+
+double
+GPSLocalFrame::distanceTo(const Point_t &point, double lat, double lon)
+{
+    double x = wrapLon(lon - point.lon) * point.cosLat;
+    double y = lat - point.lat;
+    return sqrt(x * x + y * y) * (GPS_DEG_TO_RAD * METERS_PER_RAD);
+}
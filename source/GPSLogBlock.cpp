@@ -0,0 +1,447 @@
+/**
+ ******************************************************************************
+ * @file    GPSLogBlock.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Compact columnar block format for logged fixes.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "GPSLogBlock.h"
+#include "GPSVarint.h"
+#include "GPSProviderUtils.h"
+
+static const uint16_t BLOCK_MAGIC = 0x4C47; /* "GL" */
+
+enum {
+    COLUMN_TIME,
+    COLUMN_LAT,
+    COLUMN_LON,
+    COLUMN_ALT,
+    COLUMN_SPEED,
+    COLUMN_ODO,
+    COLUMN_FLAGS,
+    COLUMN_STATUS
+};
+
+/* worst case bytes per entry over all columns */
+static const unsigned MAX_ENTRY_BYTES = GPSVarint::MAX_BYTES * 3 + GPSVarint::MAX_BYTES32 * 5 + 2;
+
+static void
+put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void
+put32(uint8_t *p, uint32_t v)
+{
+    put16(p, (uint16_t)v);
+    put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static void
+put64(uint8_t *p, uint64_t v)
+{
+    put32(p, (uint32_t)v);
+    put32(p + 4, (uint32_t)(v >> 32));
+}
+
+static uint16_t
+get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t
+get32(const uint8_t *p)
+{
+    return (uint32_t)get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+static uint64_t
+get64(const uint8_t *p)
+{
+    return (uint64_t)get32(p) | ((uint64_t)get32(p + 4) << 32);
+}
+
+static int64_t
+toFixed(double value, double scale)
+{
+    return (int64_t)floor(value * scale + 0.5);
+}
+
+/*
+ * Encoder
+ */
+
+GPSLogBlockEncoder::GPSLogBlockEncoder(unsigned maxEntries) :
+    _maxEntries((maxEntries == 0) ? 1 : ((maxEntries > MAX_ENTRIES) ? MAX_ENTRIES : maxEntries)),
+    _count(0)
+{
+    /* 8 byte columns first, then 4 and 1 byte ones */
+    size_t n = _maxEntries;
+    _storage = malloc(n * (2 * sizeof(uint64_t) + 5 * sizeof(uint32_t) + 2));
+    if (_storage == NULL) {
+        _maxEntries = 0;
+    }
+    uint8_t *p = (uint8_t *)_storage;
+    _time = (uint64_t *)p;
+    _odo = (int64_t *)(p + n * 8);
+    _lat = (int32_t *)(p + n * 16);
+    _lon = (int32_t *)(p + n * 20);
+    _alt = (int32_t *)(p + n * 24);
+    _speed = (int32_t *)(p + n * 28);
+    _flags = (uint32_t *)(p + n * 32);
+    _status = p + n * 36;
+    _mask = p + n * 37;
+}
+
+GPSLogBlockEncoder::~GPSLogBlockEncoder()
+{
+    free(_storage);
+}
+
+bool
+GPSLogBlockEncoder::add(const GPSProvider::LogQueryRespParams_t &entry)
+{
+    if (_count >= _maxEntries) {
+        return false;
+    }
+    unsigned i = _count++;
+    _time[i] = GPSProviderUtils::timestampToUtcMs(entry.timestamp);
+    _lat[i] = (int32_t)toFixed(entry.lat, 1e7);
+    _lon[i] = (int32_t)toFixed(entry.lon, 1e7);
+    _alt[i] = (int32_t)toFixed(entry.altitude, 100.0);
+    _speed[i] = (int32_t)toFixed(entry.speed, 100.0);
+    _odo[i] = toFixed(entry.odo, 100.0);
+    _flags[i] = (uint32_t)(entry.fix & 7) | ((uint32_t)(entry.geo & 7) << 3) | ((uint32_t)entry.quality << 6);
+    _status[i] = entry.statusBitmap;
+    _mask[i] = entry.logMask;
+    return true;
+}
+
+size_t
+GPSLogBlockEncoder::getMaxBlockSize(unsigned count)
+{
+    return HEADER_SIZE + (size_t)count * MAX_ENTRY_BYTES;
+}
+
+/* zig-zag varints of the (modulo 2^32) deltas of a column */
+static unsigned
+encodeDeltas32(uint8_t *out, const int32_t *values, unsigned count)
+{
+    unsigned n = 0;
+    uint32_t previous = 0;
+    for (unsigned i = 0; i < count; i++) {
+        int32_t delta = (int32_t)((uint32_t)values[i] - previous);
+        n += GPSVarint::put32(&out[n], GPSVarint::zigzag32(delta));
+        previous = (uint32_t)values[i];
+    }
+    return n;
+}
+
+size_t
+GPSLogBlockEncoder::finish(uint8_t *out, size_t capacity)
+{
+    if ((_count == 0) || (out == NULL) || (capacity < getMaxBlockSize(_count))) {
+        return 0;
+    }
+
+    uint16_t columnBytes[GPSLogBlockDecoder::COLUMNS];
+    uint8_t *p = out + HEADER_SIZE;
+    unsigned n;
+
+    /* time: delta of delta, 0 for a steady rate */
+    n = 0;
+    uint64_t previous = _time[0];
+    int64_t previousDelta = 0;
+    for (unsigned i = 0; i < _count; i++) {
+        int64_t delta = (int64_t)(_time[i] - previous);
+        n += GPSVarint::put64(&p[n], GPSVarint::zigzag64(delta - previousDelta));
+        previous = _time[i];
+        previousDelta = delta;
+    }
+    columnBytes[COLUMN_TIME] = (uint16_t)n;
+    p += n;
+
+    columnBytes[COLUMN_LAT] = (uint16_t)(n = encodeDeltas32(p, _lat, _count));
+    p += n;
+    columnBytes[COLUMN_LON] = (uint16_t)(n = encodeDeltas32(p, _lon, _count));
+    p += n;
+    columnBytes[COLUMN_ALT] = (uint16_t)(n = encodeDeltas32(p, _alt, _count));
+    p += n;
+    columnBytes[COLUMN_SPEED] = (uint16_t)(n = encodeDeltas32(p, _speed, _count));
+    p += n;
+
+    n = 0;
+    uint64_t previousOdo = 0;
+    for (unsigned i = 0; i < _count; i++) {
+        n += GPSVarint::put64(&p[n], GPSVarint::zigzag64((int64_t)((uint64_t)_odo[i] - previousOdo)));
+        previousOdo = (uint64_t)_odo[i];
+    }
+    columnBytes[COLUMN_ODO] = (uint16_t)n;
+    p += n;
+
+    n = 0;
+    for (unsigned i = 0; i < _count; i++) {
+        bool same = (i > 0) && (_flags[i] == _flags[i - 1]);
+        n += GPSVarint::put32(&p[n], same ? 0 : _flags[i] + 1);
+    }
+    columnBytes[COLUMN_FLAGS] = (uint16_t)n;
+    p += n;
+
+    n = 0;
+    for (unsigned i = 0; i < _count; ) {
+        unsigned run = 1;
+        while ((i + run < _count) && (_status[i + run] == _status[i]) && (_mask[i + run] == _mask[i])) {
+            run++;
+        }
+        n += GPSVarint::put32(&p[n], run);
+        p[n++] = _status[i];
+        p[n++] = _mask[i];
+        i += run;
+    }
+    columnBytes[COLUMN_STATUS] = (uint16_t)n;
+    p += n;
+
+    size_t size = (size_t)(p - out);
+    put16(&out[0], BLOCK_MAGIC);
+    put16(&out[2], (uint16_t)_count);
+    put64(&out[4], _time[0]);
+    put64(&out[12], _time[_count - 1]);
+    for (unsigned c = 0; c < GPSLogBlockDecoder::COLUMNS; c++) {
+        put16(&out[20 + 2 * c], columnBytes[c]);
+    }
+    put32(&out[36], (uint32_t)size);
+
+    _count = 0;
+    return size;
+}
+
+/*
+ * Decoder
+ */
+
+bool
+GPSLogBlockDecoder::readHeader(const uint8_t *data, size_t len, BlockHeader_t &header)
+{
+    if ((data == NULL) || (len < GPSLogBlockEncoder::HEADER_SIZE) || (get16(&data[0]) != BLOCK_MAGIC)) {
+        return false;
+    }
+    header.count = get16(&data[2]);
+    header.firstUtcMs = get64(&data[4]);
+    header.lastUtcMs = get64(&data[12]);
+    size_t total = GPSLogBlockEncoder::HEADER_SIZE;
+    for (unsigned c = 0; c < COLUMNS; c++) {
+        header.columnBytes[c] = get16(&data[20 + 2 * c]);
+        total += header.columnBytes[c];
+    }
+    header.size = get32(&data[36]);
+    return (header.count > 0) && (header.size == total) && (header.size <= len);
+}
+
+static bool
+decodeDeltas32(const uint8_t *in, size_t len, unsigned count, int32_t *values, size_t stride)
+{
+    /* values[i * stride] receive the decoded column */
+    size_t pos = 0;
+    uint32_t current = 0;
+    for (unsigned i = 0; i < count; i++) {
+        uint32_t zz;
+        unsigned n = GPSVarint::get32(&in[pos], len - pos, zz);
+        if (n == 0) {
+            return false;
+        }
+        pos += n;
+        current += (uint32_t)GPSVarint::unzigzag32(zz);
+        values[i * stride] = (int32_t)current;
+    }
+    return pos == len;
+}
+
+unsigned
+GPSLogBlockDecoder::decode(const uint8_t *data, size_t len,
+                           GPSProvider::LogQueryRespParams_t *out, unsigned maxEntries)
+{
+    BlockHeader_t header;
+    if ((out == NULL) || !readHeader(data, len, header) || (header.count > maxEntries)) {
+        return 0;
+    }
+
+    const unsigned count = header.count;
+    const uint8_t *column[COLUMNS];
+    column[0] = data + GPSLogBlockEncoder::HEADER_SIZE;
+    for (unsigned c = 1; c < COLUMNS; c++) {
+        column[c] = column[c - 1] + header.columnBytes[c - 1];
+    }
+
+    /* the four 32 bit columns go through an interleaved scratch array */
+    int32_t *scratch = (int32_t *)malloc(count * sizeof(int32_t) * 4);
+    if (scratch == NULL) {
+        return 0;
+    }
+    bool ok = decodeDeltas32(column[COLUMN_LAT], header.columnBytes[COLUMN_LAT], count, &scratch[0], 4) &&
+              decodeDeltas32(column[COLUMN_LON], header.columnBytes[COLUMN_LON], count, &scratch[1], 4) &&
+              decodeDeltas32(column[COLUMN_ALT], header.columnBytes[COLUMN_ALT], count, &scratch[2], 4) &&
+              decodeDeltas32(column[COLUMN_SPEED], header.columnBytes[COLUMN_SPEED], count, &scratch[3], 4);
+    for (unsigned i = 0; ok && (i < count); i++) {
+        GPSProvider::LogQueryRespParams_t &entry = out[i];
+        entry.lat = scratch[4 * i] / 1e7;
+        entry.lon = scratch[4 * i + 1] / 1e7;
+        entry.altitude = (float)(scratch[4 * i + 2] / 100.0);
+        entry.speed = scratch[4 * i + 3] / 100.0;
+    }
+    free(scratch);
+    if (!ok) {
+        return 0;
+    }
+
+    /* time */
+    const uint8_t *in = column[COLUMN_TIME];
+    size_t pos = 0;
+    size_t end = header.columnBytes[COLUMN_TIME];
+    uint64_t time = header.firstUtcMs;
+    int64_t delta = 0;
+    int64_t cachedDay = -1;
+    int year = 0, month = 0, day = 0;
+    for (unsigned i = 0; i < count; i++) {
+        uint64_t zz;
+        unsigned n = GPSVarint::get64(&in[pos], end - pos, zz);
+        if (n == 0) {
+            return 0;
+        }
+        pos += n;
+        delta += GPSVarint::unzigzag64(zz);
+        time += (uint64_t)delta;
+
+        /* calendar conversion once per day */
+        uint64_t secs = time / 1000ULL;
+        int64_t days = (int64_t)(secs / 86400ULL);
+        if (days != cachedDay) {
+            GPSProviderUtils::civilFromDays(days, year, month, day);
+            cachedDay = days;
+        }
+        unsigned sod = (unsigned)(secs % 86400ULL);
+        GPSProvider::Timestamp_t &ts = out[i].timestamp;
+        ts.year = year;
+        ts.month = month;
+        ts.day = day;
+        ts.hh = (int)(sod / 3600);
+        ts.mm = (int)((sod / 60) % 60);
+        ts.ss = (int)(sod % 60);
+    }
+    if ((pos != end) || (time != header.lastUtcMs)) {
+        return 0;
+    }
+
+    /* odometer */
+    in = column[COLUMN_ODO];
+    pos = 0;
+    end = header.columnBytes[COLUMN_ODO];
+    uint64_t odo = 0;
+    for (unsigned i = 0; i < count; i++) {
+        uint64_t zz;
+        unsigned n = GPSVarint::get64(&in[pos], end - pos, zz);
+        if (n == 0) {
+            return 0;
+        }
+        pos += n;
+        odo += (uint64_t)GPSVarint::unzigzag64(zz);
+        out[i].odo = (int64_t)odo / 100.0;
+    }
+    if (pos != end) {
+        return 0;
+    }
+
+    /* fix, geo, quality */
+    in = column[COLUMN_FLAGS];
+    pos = 0;
+    end = header.columnBytes[COLUMN_FLAGS];
+    uint32_t flags = 0;
+    for (unsigned i = 0; i < count; i++) {
+        uint32_t value;
+        unsigned n = GPSVarint::get32(&in[pos], end - pos, value);
+        if (n == 0) {
+            return 0;
+        }
+        pos += n;
+        if (value != 0) {
+            flags = value - 1;
+        }
+        out[i].fix = (uint8_t)(flags & 7);
+        out[i].geo = (uint8_t)((flags >> 3) & 7);
+        out[i].quality = flags >> 6;
+    }
+    if (pos != end) {
+        return 0;
+    }
+
+    /* status bitmap and log mask runs */
+    in = column[COLUMN_STATUS];
+    pos = 0;
+    end = header.columnBytes[COLUMN_STATUS];
+    unsigned i = 0;
+    while (i < count) {
+        uint32_t run;
+        unsigned n = GPSVarint::get32(&in[pos], end - pos, run);
+        if ((n == 0) || (run == 0) || (run > count - i) || (pos + n + 2 > end)) {
+            return 0;
+        }
+        pos += n;
+        uint8_t status = in[pos++];
+        uint8_t mask = in[pos++];
+        for (unsigned k = 0; k < run; k++, i++) {
+            out[i].statusBitmap = status;
+            out[i].logMask = mask;
+        }
+    }
+    return (pos == end) ? count : 0;
+}
+
+size_t
+GPSLogBlockDecoder::findBlock(const uint8_t *data, size_t len, uint64_t utcMs)
+{
+    size_t offset = 0;
+    BlockHeader_t header;
+    while ((offset < len) && readHeader(&data[offset], len - offset, header)) {
+        if (header.lastUtcMs >= utcMs) {
+            return offset;
+        }
+        offset += header.size;
+    }
+    return len;
+}
@@ -0,0 +1,522 @@
+/**
+ ******************************************************************************
+ * @file    GPSNmeaParser.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Incremental, zero-copy NMEA sentence parser.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+#include <string.h>
+#include "GPSNmeaParser.h"
+#include "GPSProviderUtils.h"
+#include "GPSTraceRecorder.h"
+
+#define SENTENCE_TYPE(a, b, c) (((uint32_t)(a) << 16) | ((uint32_t)(b) << 8) | (uint32_t)(c))
+#define TALKER(a, b)           ((uint16_t)(((a) << 8) | (b)))
+
+/* Longest mantissa accumulated without overflowing 64 bits. */
+static const uint8_t MAX_DIGITS = 18;
+
+static const uint64_t POW10[MAX_DIGITS + 1] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL,
+    1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+    1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+    1000000000000000000ULL
+};
+
+static const float KNOTS_TO_MPS = 0.514444f;
+
+/*
+ * Dispatch table: for each supported sentence, the meaning of its fields
+ * (field 1 first) and the routine applying them once the checksum matches.
+ */
+const uint8_t GPSNmeaParser::GGA_FIELDS[] = {
+    FIELD_TIME, FIELD_LAT, FIELD_LAT_HEMI, FIELD_LON, FIELD_LON_HEMI,
+    FIELD_QUALITY, FIELD_IGNORE, FIELD_IGNORE, FIELD_ALTITUDE
+};
+const uint8_t GPSNmeaParser::RMC_FIELDS[] = {
+    FIELD_TIME, FIELD_STATUS, FIELD_LAT, FIELD_LAT_HEMI, FIELD_LON,
+    FIELD_LON_HEMI, FIELD_SPEED_KNOTS, FIELD_COURSE, FIELD_DATE
+};
+const uint8_t GPSNmeaParser::GSV_FIELDS[] = {
+    FIELD_IGNORE, FIELD_MSG_NUM, FIELD_SV_IN_VIEW
+};
+const uint8_t GPSNmeaParser::VTG_FIELDS[] = {
+    FIELD_COURSE, FIELD_IGNORE, FIELD_IGNORE, FIELD_IGNORE, FIELD_SPEED_KNOTS
+};
+const uint8_t GPSNmeaParser::ZDA_FIELDS[] = {
+    FIELD_TIME, FIELD_DAY, FIELD_MONTH, FIELD_YEAR
+};
+
+const GPSNmeaParser::SentenceDesc_t GPSNmeaParser::SENTENCES[] = {
+    { SENTENCE_TYPE('G', 'G', 'A'), GGA_FIELDS, sizeof(GGA_FIELDS), &GPSNmeaParser::commitGGA },
+    { SENTENCE_TYPE('R', 'M', 'C'), RMC_FIELDS, sizeof(RMC_FIELDS), &GPSNmeaParser::commitRMC },
+    { SENTENCE_TYPE('G', 'S', 'V'), GSV_FIELDS, sizeof(GSV_FIELDS), &GPSNmeaParser::commitGSV },
+    { SENTENCE_TYPE('V', 'T', 'G'), VTG_FIELDS, sizeof(VTG_FIELDS), &GPSNmeaParser::commitVTG },
+    { SENTENCE_TYPE('Z', 'D', 'A'), ZDA_FIELDS, sizeof(ZDA_FIELDS), &GPSNmeaParser::commitZDA },
+};
+
+const unsigned GPSNmeaParser::NUM_SENTENCES = sizeof(SENTENCES) / sizeof(SENTENCES[0]);
+
+static int
+hexValue(uint8_t c)
+{
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0';
+    }
+    if ((c >= 'A') && (c <= 'F')) {
+        return c - 'A' + 10;
+    }
+    if ((c >= 'a') && (c <= 'f')) {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+GPSNmeaParser::GPSNmeaParser()
+{
+    reset();
+}
+
+void
+GPSNmeaParser::reset(void)
+{
+    _state = STATE_IDLE;
+    _length = 0;
+    _checksum = 0;
+    _rxChecksum = 0;
+    _address = 0;
+    _talker = 0;
+    _addressLen = 0;
+    _desc = NULL;
+    _fieldIndex = 0;
+    _acc = 0;
+    _digits = 0;
+    _frac = 0;
+    _seenDot = false;
+    _negative = false;
+    _fieldBad = false;
+    _first = '\0';
+    _fieldLen = 0;
+    memset(&_scratch, 0, sizeof(_scratch));
+
+    _haveDate = false;
+    _dateMs = 0;
+    _lastTodMs = 0;
+    _seenGGA = false;
+    _locationUpdated = false;
+    _speed = 0.0f;
+    _course = 0.0f;
+    memset(&_location, 0, sizeof(_location));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void
+GPSNmeaParser::beginSentence(void)
+{
+    if ((_state != STATE_IDLE) && (_state != STATE_SKIP)) {
+        _stats.droppedSentences++; /* a new '$' interrupted the previous sentence */
+    }
+    _state = STATE_ADDRESS;
+    _length = 1;
+    _checksum = 0;
+    _address = 0;
+    _talker = 0;
+    _addressLen = 0;
+    _desc = NULL;
+}
+
+void
+GPSNmeaParser::dropSentence(void)
+{
+    _stats.droppedSentences++;
+    _state = STATE_IDLE;
+}
+
+void
+GPSNmeaParser::lookupSentence(void)
+{
+    _desc = NULL;
+    if (_addressLen == 5) {
+        for (unsigned i = 0; i < NUM_SENTENCES; i++) {
+            if (SENTENCES[i].type == _address) {
+                _desc = &SENTENCES[i];
+                break;
+            }
+        }
+    }
+    memset(&_scratch, 0, sizeof(_scratch));
+    _fieldIndex = 1;
+    _acc = 0;
+    _digits = 0;
+    _frac = 0;
+    _seenDot = false;
+    _negative = false;
+    _fieldBad = false;
+    _fieldLen = 0;
+}
+
+size_t
+GPSNmeaParser::parse(const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        uint8_t c = data[i];
+
+        if (c == '$') {
+            beginSentence();
+            continue;
+        }
+        if (_state == STATE_IDLE) {
+            continue; /* noise or binary frames between sentences */
+        }
+        if (++_length > MAX_SENTENCE_LENGTH) {
+            dropSentence();
+            continue;
+        }
+
+        switch (_state) {
+        case STATE_FIELDS:
+            if ((c >= '0') && (c <= '9')) {
+                _checksum ^= c;
+                if (_digits < MAX_DIGITS) {
+                    _acc = _acc * 10 + (c - '0');
+                    _digits++;
+                    if (_seenDot) {
+                        _frac++;
+                    }
+                } else if (!_seenDot) {
+                    _fieldBad = true;
+                }
+                _fieldLen++;
+            } else if (c == ',') {
+                _checksum ^= c;
+                endField();
+                _fieldIndex++;
+                _acc = 0;
+                _digits = 0;
+                _frac = 0;
+                _seenDot = false;
+                _negative = false;
+                _fieldBad = false;
+                _fieldLen = 0;
+            } else if (c == '*') {
+                endField();
+                _state = STATE_CHECKSUM_HI;
+            } else if ((c == '\r') || (c == '\n')) {
+                _stats.checksumErrors++; /* checksum is mandatory */
+                _state = STATE_IDLE;
+            } else {
+                _checksum ^= c;
+                if (c == '.') {
+                    _seenDot = true;
+                } else if (c == '-') {
+                    _negative = true;
+                }
+                if (_fieldLen == 0) {
+                    _first = (char)c;
+                }
+                _fieldLen++;
+            }
+            break;
+
+        case STATE_ADDRESS:
+            if (c == ',') {
+                _checksum ^= c;
+                lookupSentence();
+                _state = (_desc != NULL) ? STATE_FIELDS : STATE_SKIP;
+            } else if ((c == '*') || (c == '\r') || (c == '\n')) {
+                dropSentence();
+            } else {
+                _checksum ^= c;
+                if (_addressLen < 2) {
+                    _talker = (uint16_t)((_talker << 8) | c);
+                } else {
+                    _address = ((_address << 8) | c) & 0xFFFFFFUL;
+                }
+                _addressLen++;
+            }
+            break;
+
+        case STATE_SKIP:
+            if (c == '*') {
+                _state = STATE_CHECKSUM_HI;
+            } else if ((c == '\r') || (c == '\n')) {
+                _stats.checksumErrors++;
+                _state = STATE_IDLE;
+            } else {
+                _checksum ^= c;
+            }
+            break;
+
+        case STATE_CHECKSUM_HI:
+            if (hexValue(c) < 0) {
+                _stats.checksumErrors++;
+                _state = STATE_IDLE;
+            } else {
+                _rxChecksum = (uint8_t)(hexValue(c) << 4);
+                _state = STATE_CHECKSUM_LO;
+            }
+            break;
+
+        case STATE_CHECKSUM_LO:
+            _state = STATE_IDLE;
+            if ((hexValue(c) < 0) || ((_rxChecksum | hexValue(c)) != _checksum)) {
+                _stats.checksumErrors++;
+                break;
+            }
+            _stats.sentences++;
+            GPS_TRACE_INSTANT(TRACE_SENTENCE, (_desc != NULL) ? _desc->type : 0);
+            if (_desc == NULL) {
+                _stats.unknownSentences++;
+                break;
+            }
+            (this->*(_desc->commit))();
+            if (_locationUpdated) {
+                _stats.locationUpdates++;
+                return i + 1;
+            }
+            break;
+
+        default:
+            _state = STATE_IDLE;
+            break;
+        }
+    }
+
+    return len;
+}
+
+/*
+ * Store the field just terminated into the scratch area according to the
+ * dispatch table.
+ */
+void
+GPSNmeaParser::endField(void)
+{
+    if ((_fieldIndex > _desc->numFields) || (_fieldLen == 0)) {
+        return;
+    }
+    FieldKind_t kind = (FieldKind_t)_desc->fields[_fieldIndex - 1];
+    if ((kind == FIELD_IGNORE) || _fieldBad) {
+        return;
+    }
+
+    uint64_t scale = POW10[_frac];
+    uint64_t whole = _acc / scale;
+
+    switch (kind) {
+    case FIELD_TIME:
+        /* hhmmss[.sss] */
+        _scratch.todMs = (uint32_t)((whole / 10000) * 3600000 +
+                                    ((whole / 100) % 100) * 60000 +
+                                    (whole % 100) * 1000 +
+                                    ((_acc % scale) * 1000) / scale);
+        break;
+    case FIELD_LAT:
+    case FIELD_LON: {
+        /* (d)ddmm.mmmm */
+        uint64_t degrees = whole / 100;
+        double minutes = (double)(_acc - degrees * 100 * scale) / (double)scale;
+        double value = (double)degrees + minutes / 60.0;
+        if (kind == FIELD_LAT) {
+            _scratch.lat = value;
+        } else {
+            _scratch.lon = value;
+        }
+        break;
+    }
+    case FIELD_LAT_HEMI:
+        _scratch.latHemi = _first;
+        break;
+    case FIELD_LON_HEMI:
+        _scratch.lonHemi = _first;
+        break;
+    case FIELD_STATUS:
+        _scratch.status = _first;
+        break;
+    case FIELD_QUALITY:
+        _scratch.quality = (unsigned)whole;
+        break;
+    case FIELD_ALTITUDE:
+        _scratch.altitude = (float)((double)_acc / (double)scale);
+        if (_negative) {
+            _scratch.altitude = -_scratch.altitude;
+        }
+        break;
+    case FIELD_SPEED_KNOTS:
+        _scratch.speedKnots = (float)((double)_acc / (double)scale);
+        break;
+    case FIELD_COURSE:
+        _scratch.course = (float)((double)_acc / (double)scale);
+        break;
+    case FIELD_DATE:
+        _scratch.date = (unsigned)whole;
+        break;
+    case FIELD_DAY:
+        _scratch.day = (unsigned)whole;
+        break;
+    case FIELD_MONTH:
+        _scratch.month = (unsigned)whole;
+        break;
+    case FIELD_YEAR:
+        _scratch.year = (unsigned)whole;
+        break;
+    case FIELD_MSG_NUM:
+        _scratch.msgNum = (unsigned)whole;
+        break;
+    case FIELD_SV_IN_VIEW:
+        _scratch.svInView = (unsigned)whole;
+        break;
+    default:
+        return;
+    }
+    _scratch.present |= (1UL << kind);
+}
+
+void
+GPSNmeaParser::commitGGA(void)
+{
+    _seenGGA = true;
+
+    _location.valid = (_scratch.quality > 0) && has(FIELD_LAT) && has(FIELD_LON);
+    if (_location.valid) {
+        _location.lat = (_scratch.latHemi == 'S') ? -_scratch.lat : _scratch.lat;
+        _location.lon = (_scratch.lonHemi == 'W') ? -_scratch.lon : _scratch.lon;
+        _location.altitude = _scratch.altitude;
+    }
+    _location.utcTime = fixTime();
+    if (_haveDate) {
+        GPSProviderUtils::utcMsToGPSTime(_location.utcTime, _location.gpsTime);
+    }
+    _location.version = 1;
+    _locationUpdated = true;
+}
+
+void
+GPSNmeaParser::commitRMC(void)
+{
+    if (has(FIELD_DATE)) {
+        unsigned dd = _scratch.date / 10000;
+        unsigned mm = (_scratch.date / 100) % 100;
+        unsigned yy = _scratch.date % 100;
+        setDate((uint64_t)GPSProviderUtils::daysFromCivil((int)(2000 + yy), mm, dd) *
+                GPSProviderUtils::MS_PER_DAY);
+    }
+    if (has(FIELD_SPEED_KNOTS)) {
+        _speed = _scratch.speedKnots * KNOTS_TO_MPS;
+    }
+    if (has(FIELD_COURSE)) {
+        _course = _scratch.course;
+    }
+
+    if (_seenGGA) {
+        return; /* GGA drives the location updates when present */
+    }
+
+    _location.valid = (_scratch.status == 'A') && has(FIELD_LAT) && has(FIELD_LON);
+    if (_location.valid) {
+        _location.lat = (_scratch.latHemi == 'S') ? -_scratch.lat : _scratch.lat;
+        _location.lon = (_scratch.lonHemi == 'W') ? -_scratch.lon : _scratch.lon;
+    }
+    _location.utcTime = fixTime();
+    if (_haveDate) {
+        GPSProviderUtils::utcMsToGPSTime(_location.utcTime, _location.gpsTime);
+    }
+    _location.version = 1;
+    _locationUpdated = true;
+}
+
+void
+GPSNmeaParser::commitGSV(void)
+{
+    if ((_scratch.msgNum != 1) || !has(FIELD_SV_IN_VIEW)) {
+        return; /* the satellites-in-view count is repeated by every part */
+    }
+    if (_talker == TALKER('G', 'P')) {
+        _location.numGPSSVs = _scratch.svInView;
+    } else if (_talker == TALKER('G', 'L')) {
+        _location.numGLOSVs = _scratch.svInView;
+    }
+}
+
+void
+GPSNmeaParser::commitVTG(void)
+{
+    if (has(FIELD_SPEED_KNOTS)) {
+        _speed = _scratch.speedKnots * KNOTS_TO_MPS;
+    }
+    if (has(FIELD_COURSE)) {
+        _course = _scratch.course;
+    }
+}
+
+void
+GPSNmeaParser::commitZDA(void)
+{
+    if (has(FIELD_DAY) && has(FIELD_MONTH) && has(FIELD_YEAR)) {
+        setDate((uint64_t)GPSProviderUtils::daysFromCivil((int)_scratch.year,
+                                                          _scratch.month,
+                                                          _scratch.day) *
+                GPSProviderUtils::MS_PER_DAY);
+    }
+}
+
+/*
+ * A dated sentence (RMC, ZDA) sets the date of its own time of day.
+ */
+void
+GPSNmeaParser::setDate(uint64_t dateMs)
+{
+    _dateMs = dateMs;
+    _haveDate = true;
+    if (has(FIELD_TIME)) {
+        _lastTodMs = _scratch.todMs;
+    }
+}
+
+/*
+ * UTC time of the sentence being committed. GGA may cross midnight
+ * before the next RMC tells the new date: a time of day going back by
+ * more than half a day moves the date to the next day until then.
+ */
+uint64_t
+GPSNmeaParser::fixTime(void)
+{
+    if (has(FIELD_TIME)) {
+        if ((uint64_t)_scratch.todMs + GPSProviderUtils::MS_PER_DAY / 2 < _lastTodMs) {
+            _dateMs += GPSProviderUtils::MS_PER_DAY;
+        }
+        _lastTodMs = _scratch.todMs;
+    }
+    return _dateMs + _scratch.todMs;
+}
@@ -0,0 +1,379 @@
+/**
+ ******************************************************************************
+ * @file    GPSOdometer.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Host-side odometer with named trip counters.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "GPSOdometer.h"
+#include "GPSProviderUtils.h"
+#include "GPSTraceRecorder.h"
+
+GPSOdometer::GPSOdometer() :
+    _enabled(false),
+    _haveAnchor(false),
+    _minStep(0.0),
+    _minStepMm(0),
+#if defined(GPS_LOCATION_FIXED_POINT)
+    _totalMm(0),
+#else
+    _sum(0.0),
+    _comp(0.0),
+#endif
+    _alarmDistance(0),
+    _lastUtcTime(0),
+    _trips(NULL),
+    _tripCount(0),
+    _tripCapacity(0),
+    _odoCallback(NULL)
+{
+    memset(&_anchor, 0, sizeof(_anchor));
+    memset(&_odoA, 0, sizeof(_odoA));
+    memset(&_odoB, 0, sizeof(_odoB));
+    memset(&_odoPon, 0, sizeof(_odoPon));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+GPSOdometer::~GPSOdometer()
+{
+    free(_trips);
+}
+
+/*
+ * Counters: distance = base + (total now - total at start)
+ */
+
+void
+GPSOdometer::startCounter(Trip_t &trip) const
+{
+    if (!trip.running) {
+#if defined(GPS_LOCATION_FIXED_POINT)
+        trip.markMm = _totalMm;
+#else
+        trip.markSum = _sum;
+        trip.markComp = _comp;
+#endif
+        trip.running = true;
+    }
+}
+
+void
+GPSOdometer::stopCounter(Trip_t &trip) const
+{
+    if (trip.running) {
+        trip.base = counterDistance(trip);
+        trip.running = false;
+    }
+}
+
+void
+GPSOdometer::resetCounter(Trip_t &trip) const
+{
+    trip.base = 0.0;
+#if defined(GPS_LOCATION_FIXED_POINT)
+    trip.markMm = _totalMm;
+#else
+    trip.markSum = _sum;
+    trip.markComp = _comp;
+#endif
+}
+
+double
+GPSOdometer::counterDistance(const Trip_t &trip) const
+{
+    if (!trip.running) {
+        return trip.base;
+    }
+#if defined(GPS_LOCATION_FIXED_POINT)
+    return trip.base + (double)(_totalMm - trip.markMm) / 1000.0;
+#else
+    return trip.base + ((_sum - trip.markSum) + (_comp - trip.markComp));
+#endif
+}
+
+/*
+ * Subsystem API
+ */
+
+gps_provider_error_t
+GPSOdometer::enableOdo(void)
+{
+    _enabled = true;
+    _haveAnchor = false;
+#if defined(GPS_LOCATION_FIXED_POINT)
+    _totalMm = 0;
+#else
+    _sum = 0.0;
+    _comp = 0.0;
+#endif
+    memset(&_odoA, 0, sizeof(_odoA));
+    memset(&_odoB, 0, sizeof(_odoB));
+    memset(&_odoPon, 0, sizeof(_odoPon));
+    startCounter(_odoB);
+    startCounter(_odoPon);
+    _alarmDistance = 0;
+    for (unsigned i = 0; i < _tripCount; i++) {
+        resetCounter(_trips[i]);
+    }
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSOdometer::startOdo(unsigned alarmDistance)
+{
+    if (!_enabled) {
+        return GPS_ERROR_ODO_START;
+    }
+    resetCounter(_odoA);
+    startCounter(_odoA);
+    _alarmDistance = alarmDistance;
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSOdometer::stopOdo(void)
+{
+    if (!_enabled) {
+        return GPS_ERROR_ODO_STOP;
+    }
+    stopCounter(_odoA);
+    _alarmDistance = 0;
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSOdometer::resetOdo(void)
+{
+    if (!_enabled) {
+        return GPS_ERROR_ODO_RESET;
+    }
+    resetCounter(_odoA);
+    resetCounter(_odoB);
+    return GPS_ERROR_NONE;
+}
+
+double
+GPSOdometer::update(const GPSProvider::LocationUpdateParams_t &location)
+{
+    if (!_enabled || !location.valid) {
+        return update(location, _frame.getPoint());
+    }
+    return update(location, _frame.update(location));
+}
+
+double
+GPSOdometer::update(const GPSProvider::LocationUpdateParams_t &location, const GPSLocalFrame::Point_t &point)
+{
+    if (!_enabled) {
+        return 0.0;
+    }
+    _stats.updates++;
+    if (!location.valid) {
+        _stats.invalid++;
+        return 0.0;
+    }
+    _lastUtcTime = location.utcTime;
+    if (!_haveAnchor) {
+        _anchor = point;
+        _haveAnchor = true;
+        return 0.0;
+    }
+
+#if defined(GPS_LOCATION_FIXED_POINT)
+    uint32_t stepMm = GPSLocalFrame::distanceMm(_anchor, point);
+    if (stepMm < _minStepMm) {
+        _stats.jitter++;
+        return 0.0;
+    }
+    _anchor = point;
+    _totalMm += stepMm;
+    _stats.steps++;
+
+    /* odoA restarts from zero whenever the alarm is armed: its distance is
+     * the total since its mark */
+    if ((_alarmDistance != 0) && (_totalMm - _odoA.markMm >= (uint64_t)_alarmDistance * 1000U)) {
+        _alarmDistance = 0;
+        reportOdo();
+    }
+    return stepMm / 1000.0;
+#else
+    double step = GPSLocalFrame::distance(_anchor, point);
+    if (step < _minStep) {
+        _stats.jitter++;
+        return 0.0;
+    }
+    _anchor = point;
+
+    /* Neumaier: keep the low bits lost by the addition in _comp */
+    double sum = _sum + step;
+    if (fabs(_sum) >= step) {
+        _comp += (_sum - sum) + step;
+    } else {
+        _comp += (step - sum) + _sum;
+    }
+    _sum = sum;
+    _stats.steps++;
+
+    if ((_alarmDistance != 0) && (counterDistance(_odoA) >= (double)_alarmDistance)) {
+        _alarmDistance = 0;
+        reportOdo();
+    }
+    return step;
+#endif
+}
+
+double
+GPSOdometer::getDistance(void) const
+{
+#if defined(GPS_LOCATION_FIXED_POINT)
+    return _totalMm / 1000.0;
+#else
+    return _sum + _comp;
+#endif
+}
+
+void
+GPSOdometer::getOdo(GPSProvider::OdoParams_t &params) const
+{
+    GPSProviderUtils::utcMsToTimestamp(_lastUtcTime, params.timestamp);
+    params.odoA = (unsigned)counterDistance(_odoA);
+    params.odoB = (unsigned)counterDistance(_odoB);
+    params.odoPon = (unsigned)counterDistance(_odoPon);
+}
+
+void
+GPSOdometer::reportOdo(void)
+{
+    if (_odoCallback != NULL) {
+        GPSProvider::OdoParams_t params;
+        getOdo(params);
+        GPS_TRACE_SCOPE(TRACE_ODO_CB, params.odoA);
+        _odoCallback(&params);
+    }
+}
+
+/*
+ * Named trips
+ */
+
+int
+GPSOdometer::findTrip(const char *name) const
+{
+    if (name == NULL) {
+        return -1;
+    }
+    for (unsigned i = 0; i < _tripCount; i++) {
+        if (strcmp(_trips[i].name, name) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+gps_provider_error_t
+GPSOdometer::addTrip(const char *name)
+{
+    if ((name == NULL) || (name[0] == '\0') || (strlen(name) > MAX_NAME) || (findTrip(name) >= 0)) {
+        return GPS_ERROR_ODO_START;
+    }
+    if (_tripCount == _tripCapacity) {
+        unsigned capacity = (_tripCapacity == 0) ? 4 : _tripCapacity * 2;
+        Trip_t *trips = (Trip_t *)realloc(_trips, capacity * sizeof(Trip_t));
+        if (trips == NULL) {
+            return GPS_ERROR_NO_MEM;
+        }
+        _trips = trips;
+        _tripCapacity = capacity;
+    }
+    Trip_t &trip = _trips[_tripCount++];
+    memset(&trip, 0, sizeof(trip));
+    strcpy(trip.name, name);
+    startCounter(trip);
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSOdometer::removeTrip(const char *name)
+{
+    int i = findTrip(name);
+    if (i < 0) {
+        return GPS_ERROR_ODO_RESET;
+    }
+    memmove(&_trips[i], &_trips[i + 1], (_tripCount - (unsigned)i - 1) * sizeof(Trip_t));
+    _tripCount--;
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSOdometer::startTrip(const char *name)
+{
+    int i = findTrip(name);
+    if (i < 0) {
+        return GPS_ERROR_ODO_START;
+    }
+    startCounter(_trips[i]);
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSOdometer::stopTrip(const char *name)
+{
+    int i = findTrip(name);
+    if (i < 0) {
+        return GPS_ERROR_ODO_STOP;
+    }
+    stopCounter(_trips[i]);
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSOdometer::resetTrip(const char *name)
+{
+    int i = findTrip(name);
+    if (i < 0) {
+        return GPS_ERROR_ODO_RESET;
+    }
+    resetCounter(_trips[i]);
+    return GPS_ERROR_NONE;
+}
+
+double
+GPSOdometer::getTripDistance(const char *name) const
+{
+    int i = findTrip(name);
+    return (i < 0) ? -1.0 : counterDistance(_trips[i]);
+}
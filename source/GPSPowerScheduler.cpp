@@ -0,0 +1,223 @@
+/**
+ ******************************************************************************
+ * @file    GPSPowerScheduler.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Motion-driven selection of the power mode and fix interval.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <math.h>
+#include <string.h>
+#include "GPSPowerScheduler.h"
+
+GPSPowerScheduler::GPSPowerScheduler(GPSProvider *gps) :
+    _gps(gps),
+    _dwellUp(5000),
+    _dwellDown(120000),
+    _window(60000),
+    _modeChangeCallback(NULL)
+{
+    setPolicy(MOTION_STATIONARY, GPSProvider::POWER_LOW, 300000);
+    setPolicy(MOTION_WALKING, GPSProvider::POWER_LOW, 10000);
+    setPolicy(MOTION_DRIVING, GPSProvider::POWER_FULL, 1000);
+    setThresholds(0.5, 2.5, 0.25);
+    clear(MOTION_DRIVING);
+}
+
+void
+GPSPowerScheduler::setPolicy(MotionState_t state, GPSProvider::PowerMode_t mode, uint32_t fixIntervalMs)
+{
+    if (state < MOTION_STATES) {
+        _policy[state].mode = mode;
+        _policy[state].fixIntervalMs = (fixIntervalMs == 0) ? 1 : fixIntervalMs;
+    }
+}
+
+void
+GPSPowerScheduler::setThresholds(double walkingSpeed, double drivingSpeed, double hysteresisRatio)
+{
+    double r = (hysteresisRatio > 0.0) ? ((hysteresisRatio < 1.0) ? hysteresisRatio : 0.99) : 0.0;
+    _down[MOTION_STATIONARY] = -1.0;
+    _up[MOTION_STATIONARY] = walkingSpeed * (1.0 + r);
+    _down[MOTION_WALKING] = walkingSpeed * (1.0 - r);
+    _up[MOTION_WALKING] = drivingSpeed * (1.0 + r);
+    _down[MOTION_DRIVING] = drivingSpeed * (1.0 - r);
+    _up[MOTION_DRIVING] = HUGE_VAL;
+}
+
+void
+GPSPowerScheduler::reset(MotionState_t state)
+{
+    clear(state);
+    if (_gps != NULL) {
+        _gps->setPowerMode(_policy[_state].mode);
+        _gps->start();
+    }
+}
+
+void
+GPSPowerScheduler::clear(MotionState_t state)
+{
+    _state = (state < MOTION_STATES) ? state : MOTION_DRIVING;
+    _candidate = _state;
+    _candidateSince = 0;
+    _lastTime = 0;
+    _speed = 0.0;
+    _head = 0;
+    _count = 0;
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+uint64_t
+GPSPowerScheduler::update(const GPSProvider::LocationUpdateParams_t &location)
+{
+    if (!location.valid) {
+        return update(location, _frame.getPoint());
+    }
+    return update(location, _frame.update(location));
+}
+
+uint64_t
+GPSPowerScheduler::update(const GPSProvider::LocationUpdateParams_t &location, const GPSLocalFrame::Point_t &point)
+{
+    uint64_t now = location.utcTime;
+    if (!location.valid) {
+        /* no position: ask again after the current interval */
+        _stats.invalid++;
+        return now + _policy[_state].fixIntervalMs;
+    }
+    _stats.fixes++;
+
+    if ((_lastTime != 0) && (now > _lastTime)) {
+        _stats.timeInState[_state] += now - _lastTime;
+        _stats.timeInMode[_policy[_state].mode] += now - _lastTime;
+    }
+    _lastTime = now;
+
+    /* speed: displacement from the oldest fix within the window, or from
+     * the previous fix when it is older than that */
+    const GPSLocalFrame::Point_t *from = NULL;
+    uint64_t fromTime = 0;
+    for (unsigned i = 1; i <= _count; i++) {
+        unsigned slot = (_head + HISTORY - i) % HISTORY;
+        if ((now < _times[slot]) || ((from != NULL) && (now - _times[slot] > _window))) {
+            break;
+        }
+        from = &_points[slot];
+        fromTime = _times[slot];
+    }
+    bool haveSpeed = (from != NULL) && (now > fromTime);
+    if (haveSpeed) {
+        _speed = GPSLocalFrame::distance(*from, point) * 1000.0 / (double)(now - fromTime);
+    }
+
+    /* keep the history spread over the window, whatever the fix rate */
+    uint64_t newest = _times[(_head + HISTORY - 1) % HISTORY];
+    if ((_count == 0) || (now < newest) || (now - newest >= _window / HISTORY)) {
+        _points[_head] = point;
+        _times[_head] = now;
+        _head = (_head + 1) % HISTORY;
+        if (_count < HISTORY) {
+            _count++;
+        }
+    }
+
+    if (!haveSpeed) {
+        return now + _policy[_state].fixIntervalMs;
+    }
+
+    MotionState_t state = classify(_speed);
+    if (state == _state) {
+        if (_candidate != _state) {
+            _stats.suppressed++;
+            _candidate = _state;
+        }
+    } else {
+        if (state != _candidate) {
+            if (_candidate != _state) {
+                _stats.suppressed++;
+            }
+            _candidate = state;
+            _candidateSince = now;
+        }
+        uint32_t dwell = (state > _state) ? _dwellUp : _dwellDown;
+        if (now - _candidateSince >= dwell) {
+            apply(state, now);
+        } else if (_candidateSince + dwell < now + _policy[_state].fixIntervalMs) {
+            /* confirm the candidate as soon as its dwell time is over */
+            return _candidateSince + dwell;
+        }
+    }
+    return now + _policy[_state].fixIntervalMs;
+}
+
+GPSPowerScheduler::MotionState_t
+GPSPowerScheduler::classify(double speed) const
+{
+    int state = _state;
+    while ((state < MOTION_DRIVING) && (speed > _up[state])) {
+        state++;
+    }
+    while ((state > MOTION_STATIONARY) && (speed < _down[state])) {
+        state--;
+    }
+    return (MotionState_t)state;
+}
+
+void
+GPSPowerScheduler::apply(MotionState_t state, uint64_t utcTime)
+{
+    MotionState_t previous = _state;
+    _state = state;
+    _candidate = state;
+    _stats.transitions++;
+
+    if (_policy[state].mode != _policy[previous].mode) {
+        _stats.modeSwitches++;
+        if (_gps != NULL) {
+            _gps->setPowerMode(_policy[state].mode);
+            _gps->start();
+        }
+    }
+
+    if (_modeChangeCallback) {
+        ModeChangeParams_t params;
+        params.state = state;
+        params.previous = previous;
+        params.mode = _policy[state].mode;
+        params.fixIntervalMs = _policy[state].fixIntervalMs;
+        params.speed = _speed;
+        params.utcTime = utcTime;
+        _modeChangeCallback(&params);
+    }
+}
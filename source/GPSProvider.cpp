@@ -14,7 +14,12 @@
  * limitations under the License.
  */
 
+#if defined(__linux__)
+#include <stdint.h>
+#include <stddef.h>
+#else
 #include "mbed.h"
+#endif
 #include "GPSProviderImplBase.h"
 #include "GPSProvider.h"
 
@@ -66,6 +71,18 @@ GPSProvider::ioctl(uint32_t command, void *arg)
     return impl->ioctl(command, arg);
 }
 
+void
+GPSProvider::getProcessStats(ProcessStats_t &stats) const
+{
+    impl->getProcessStats(stats);
+}
+
+void
+GPSProvider::resetProcessStats(void)
+{
+    impl->resetProcessStats();
+}
+
 bool
 GPSProvider::locationAvailable(void) const
 {
@@ -125,6 +142,34 @@ GPSProvider::geofenceReq(void)
   return impl->geofenceReq();
 }
 
+/** [ST-GNSS] - Geofencing API */
+gps_provider_error_t
+GPSProvider::addGeofence(GPSGeofence *geofence)
+{
+  return impl->addGeofence(geofence);
+}
+
+/** [ST-GNSS] - Geofencing API */
+gps_provider_error_t
+GPSProvider::updateGeofence(GPSGeofence *geofence)
+{
+  return impl->updateGeofence(geofence);
+}
+
+/** [ST-GNSS] - Geofencing API */
+gps_provider_error_t
+GPSProvider::removeGeofence(int id)
+{
+  return impl->removeGeofence(id);
+}
+
+/** [ST-GNSS] - Geofencing API */
+void
+GPSProvider::getGeofenceDeltaStats(GeofenceDeltaStats_t &stats) const
+{
+  impl->getGeofenceDeltaStats(stats);
+}
+
 /** [ST-GNSS] - Geofencing API */
 void
 GPSProvider::onGeofenceCfgMessage(GeofenceCfgMessageCallback_t callback)
@@ -195,6 +240,14 @@ GPSProvider::logReqQuery(LogQueryParams_t &logReqQuery)
   return impl->logReqQuery(logReqQuery);
 }
 
+/** [ST-GNSS] - Datalogging API */
+gps_provider_error_t
+GPSProvider::logReqBulk(LogQueryParams_t &logReqQuery, unsigned skip,
+                        LogQueryRespParams_t *entries, unsigned &count)
+{
+  return impl->logReqBulk(logReqQuery, skip, entries, count);
+}
+
 /** [ST-GNSS] - Datalogging API */
 void
 GPSProvider::onLogStatus(LogStatusCallback_t callback)
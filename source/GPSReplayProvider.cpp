@@ -0,0 +1,875 @@
+/**
+ ******************************************************************************
+ * @file    GPSReplayProvider.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Host-side GPSProviderImplBase replaying recorded GNSS captures.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+#if defined(__linux__)
+
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include "GPSReplayProvider.h"
+#include "GPSTraceRecorder.h"
+
+static const uint64_t NS_PER_MS  = 1000000ULL;
+static const uint64_t NS_PER_DAY = 86400ULL * 1000000000ULL;
+
+const char GPSReplayProvider::TIMESTAMPED_MAGIC[8] = { 'G', 'P', 'S', 'R', 'P', 'L', 'Y', '1' };
+
+GPSReplayProvider::GPSReplayProvider(const char *capturePath,
+                                     ReplayClock_t clock,
+                                     double speedup) :
+    _capturePath(capturePath),
+    _file(NULL),
+    _clock(clock),
+    _speedup((speedup > 0.0) ? speedup : 1.0),
+    _powerMode(GPSProvider::POWER_FULL),
+    _running(false),
+    _ring(_ringStorage, RING_SIZE),
+    _stamps(_stampStorage, STAMP_RING_SIZE),
+    _useThread(false),
+    _threadStarted(false),
+    _geofenceLimit(0),
+    _datalogPath(NULL),
+    _datalogCapacity(0)
+{
+    deviceInfo = "GPS replay backend";
+    locationCallback = NULL;
+    geofenceStatus.currentStatus = NULL;
+    geofenceStatus.numGeofences = 0;
+    geofenceStatus.idAlarm = 0;
+    geofenceCfgMessageCallback = NULL;
+    geofenceStatusMessageCallback = NULL;
+    logStatusCallback = NULL;
+    logQueryCallback = NULL;
+    odoCallback = NULL;
+
+    _ring.setEvent(&_event);
+    _geofences.setIndex(&_geofenceIndex);
+    reset();
+}
+
+GPSReplayProvider::~GPSReplayProvider()
+{
+    stopProducerThread();
+    if (_file != NULL) {
+        fclose(_file);
+    }
+}
+
+uint64_t
+GPSReplayProvider::nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+bool
+GPSReplayProvider::setPowerMode(GPSProvider::PowerMode_t power)
+{
+    _powerMode = power;
+    return true;
+}
+
+void
+GPSReplayProvider::setClock(ReplayClock_t clock, double speedup)
+{
+    _clock = clock;
+    _speedup = (speedup > 0.0) ? speedup : 1.0;
+}
+
+void
+GPSReplayProvider::setProducerThread(bool enable)
+{
+    _useThread = enable;
+}
+
+void
+GPSReplayProvider::reset(void)
+{
+    stopProducerThread();
+    if (_file != NULL) {
+        fclose(_file);
+        _file = NULL;
+    }
+
+    _running = false;
+    _done = false;
+    _timestamped = false;
+    _startNs = 0;
+    _pausedNs = 0;
+    _runStartNs = 0;
+    _originNs = 0;
+    _haveOrigin = false;
+
+    _readPos = 0;
+    _readLen = 0;
+    _recordRemaining = 0;
+
+    _chunkLen = 0;
+    _chunkPending = false;
+    _chunkCaptureNs = 0;
+    _captureNs = 0;
+    _lastTodNs = 0;
+
+    _ring.reset();
+    _stamps.reset();
+    _producedPosition = 0;
+    _producerDone = 0;
+    _producerRun = 0;
+
+    _parser.reset();
+    memset(&lastLocation, 0, sizeof(lastLocation));
+
+    memset(&_stats, 0, sizeof(_stats));
+    _stats.callbackLatencyMinNs = ~(uint64_t)0;
+    _processStats.reset();
+
+    if (!openCapture()) {
+        _producerDone = 1;
+        _done = true;
+    }
+}
+
+void
+GPSReplayProvider::start(void)
+{
+    if (_running) {
+        return;
+    }
+    uint64_t now = nowNs();
+    if (_haveOrigin) {
+        /* resume the capture timeline where stop() left it */
+        _startNs += now - _pausedNs;
+    }
+    _runStartNs = now;
+    _running = true;
+
+    if (_useThread && !_done) {
+        GPS_RING_STORE_RELEASE(&_producerRun, 1U);
+        _threadStarted = (pthread_create(&_thread, NULL, producerThread, this) == 0);
+    }
+}
+
+void
+GPSReplayProvider::stop(void)
+{
+    if (!_running) {
+        return;
+    }
+    stopProducerThread();
+
+    uint64_t now = nowNs();
+    if (!_done) {
+        _stats.elapsedNs += now - _runStartNs;
+    }
+    _pausedNs = now;
+    _running = false;
+}
+
+void
+GPSReplayProvider::process(void)
+{
+    if (!_running || _done) {
+        return;
+    }
+
+    GPS_TRACE_SCOPE(TRACE_PROCESS, 0);
+    uint32_t start = _processStats.now();
+    uint64_t bytes = _stats.bytes;
+    uint64_t sentences = _stats.sentences;
+
+    if (!_threadStarted) {
+        releaseDueChunks();
+    }
+    drain();
+
+    _processStats.recordProcess(start, (uint32_t)(_stats.bytes - bytes), (uint32_t)(_stats.sentences - sentences));
+
+    if (GPS_RING_LOAD_ACQUIRE(&_producerDone) && (_ring.available() == 0)) {
+        _done = true;
+        _stats.elapsedNs += nowNs() - _runStartNs;
+    }
+}
+
+void
+GPSReplayProvider::waitForData(void)
+{
+    if (_threadStarted && !GPS_RING_LOAD_ACQUIRE(&_producerDone)) {
+        _ring.waitForData();
+    }
+}
+
+void
+GPSReplayProvider::lpmGetImmediateLocation(void)
+{
+    if (lastLocation.valid && (locationCallback != NULL)) {
+        locationCallback(&lastLocation);
+    }
+}
+
+uint32_t
+GPSReplayProvider::ioctl(uint32_t command, void *arg)
+{
+    (void)command;
+    (void)arg;
+    return 0;
+}
+
+void
+GPSReplayProvider::setVerboseMode(int level)
+{
+    (void)level;
+}
+
+void
+GPSReplayProvider::getProcessStats(GPSProvider::ProcessStats_t &stats) const
+{
+    _processStats.get(stats);
+}
+
+void
+GPSReplayProvider::resetProcessStats(void)
+{
+    _processStats.reset();
+}
+
+bool
+GPSReplayProvider::isReplayDone(void) const
+{
+    return _done;
+}
+
+const GPSReplayProvider::ReplayStats_t &
+GPSReplayProvider::getReplayStats(void) const
+{
+    return _stats;
+}
+
+/** [ST-GNSS] - Geofencing API */
+gps_provider_error_t
+GPSReplayProvider::enableGeofence(void)
+{
+    /* fences are evaluated in software, nothing to enable */
+    return GPS_ERROR_NONE;
+}
+
+gps_provider_error_t
+GPSReplayProvider::configGeofences(GPSGeofence *geofences[], unsigned geofenceCount)
+{
+    gps_provider_error_t ret = GPS_ERROR_GEOFENCE_MAX_EXCEEDED;
+    if ((_geofenceLimit == 0) || (geofenceCount <= _geofenceLimit)) {
+        /* the set is checked (duplicate ids, memory) before the engine takes
+         * it; both keep the previous one on failure */
+        GPSGeofenceShadow shadow;
+        ret = shadow.reset(geofences, geofenceCount);
+        if (ret == GPS_ERROR_NONE) {
+            ret = _geofences.configGeofences(geofences, geofenceCount);
+        }
+        if (ret == GPS_ERROR_NONE) {
+            _geofenceShadow.swap(shadow);
+        }
+    }
+    geofenceConfigured(ret);
+    return ret;
+}
+
+gps_provider_error_t
+GPSReplayProvider::addGeofence(GPSGeofence *geofence)
+{
+    if ((_geofenceLimit != 0) && (_geofences.getGeofenceCount() >= _geofenceLimit)) {
+        return GPS_ERROR_GEOFENCE_MAX_EXCEEDED;
+    }
+
+    GPSGeofenceShadow::Command_t cmd;
+    gps_provider_error_t ret = _geofenceShadow.diffAdd(geofence, cmd);
+    if (ret != GPS_ERROR_NONE) {
+        return ret;
+    }
+    ret = _geofences.addGeofence(geofence);
+    if (ret != GPS_ERROR_NONE) {
+        _geofenceShadow.diffRemove(geofence->getGeofenceCircle().id, cmd);
+        return ret;
+    }
+    _geofenceShadow.account(GPSGeofenceShadow::CMD_ADD);
+    geofenceConfigured(ret);
+    return ret;
+}
+
+gps_provider_error_t
+GPSReplayProvider::updateGeofence(GPSGeofence *geofence)
+{
+    GPSGeofenceShadow::Command_t cmd;
+    gps_provider_error_t ret = _geofenceShadow.diffUpdate(geofence, cmd);
+    if (ret != GPS_ERROR_NONE) {
+        return ret;
+    }
+    if (cmd != GPSGeofenceShadow::CMD_NONE) {
+        ret = _geofences.updateGeofence(geofence);
+        if (ret != GPS_ERROR_NONE) {
+            /* not applied: the mirror keeps what the engine was last told */
+            _geofenceShadow.revertUpdate();
+            geofenceConfigured(ret);
+            return ret;
+        }
+    }
+    _geofenceShadow.account(cmd);
+    if (cmd != GPSGeofenceShadow::CMD_NONE) {
+        geofenceConfigured(ret);
+    }
+    return ret;
+}
+
+gps_provider_error_t
+GPSReplayProvider::removeGeofence(int id)
+{
+    GPSGeofenceShadow::Command_t cmd;
+    gps_provider_error_t ret = _geofenceShadow.diffRemove(id, cmd);
+    if (ret != GPS_ERROR_NONE) {
+        return ret;
+    }
+    ret = _geofences.removeGeofence(id);
+    _geofenceShadow.account(cmd);
+    geofenceConfigured(ret);
+    return ret;
+}
+
+void
+GPSReplayProvider::getGeofenceDeltaStats(GPSProvider::GeofenceDeltaStats_t &stats) const
+{
+    _geofenceShadow.getStats(stats);
+}
+
+void
+GPSReplayProvider::geofenceConfigured(gps_provider_error_t ret)
+{
+    /* the status array moves as the set grows */
+    geofenceStatus.currentStatus = const_cast<int *>(_geofences.getStatus());
+    geofenceStatus.numGeofences = (int)_geofences.getGeofenceCount();
+    if (geofenceCfgMessageCallback != NULL) {
+        geofenceCfgMessageCallback(ret);
+    }
+}
+
+gps_provider_error_t
+GPSReplayProvider::geofenceReq(void)
+{
+    _geofences.onGeofenceStatusMessage(geofenceStatusMessageCallback);
+    _geofences.reportStatus();
+    return GPS_ERROR_NONE;
+}
+
+/** [ST-GNSS] - Datalogging API */
+gps_provider_error_t
+GPSReplayProvider::enableDatalog(void)
+{
+    if (_datalog.isOpen()) {
+        return GPS_ERROR_NONE;
+    }
+    /* no default store: the application says where the log may live */
+    if (_datalogPath == NULL) {
+        return GPS_ERROR_DATALOG_CFG;
+    }
+    return _datalog.open(_datalogPath, _datalogCapacity);
+}
+
+gps_provider_error_t
+GPSReplayProvider::configDatalog(GPSDatalog *datalog)
+{
+    if (!_datalog.isOpen()) {
+        return GPS_ERROR_DATALOG_CFG;
+    }
+    return _datalog.configDatalog(datalog);
+}
+
+gps_provider_error_t
+GPSReplayProvider::startDatalog(void)
+{
+    _datalog.onLogStatus(logStatusCallback);
+    return _datalog.startDatalog();
+}
+
+gps_provider_error_t
+GPSReplayProvider::stopDatalog(void)
+{
+    return _datalog.stopDatalog();
+}
+
+gps_provider_error_t
+GPSReplayProvider::eraseDatalog(void)
+{
+    return _datalog.eraseDatalog();
+}
+
+gps_provider_error_t
+GPSReplayProvider::logReqStatus(void)
+{
+    _datalog.onLogStatus(logStatusCallback);
+    return _datalog.logReqStatus();
+}
+
+gps_provider_error_t
+GPSReplayProvider::logReqQuery(GPSProvider::LogQueryParams_t &logReqQuery)
+{
+    _datalog.onLogQuery(logQueryCallback);
+    return _datalog.logReqQuery(logReqQuery);
+}
+
+gps_provider_error_t
+GPSReplayProvider::logReqBulk(GPSProvider::LogQueryParams_t &logReqQuery, unsigned skip,
+                              GPSProvider::LogQueryRespParams_t *entries, unsigned &count)
+{
+    return _datalog.logReqBulk(logReqQuery, skip, entries, count);
+}
+
+/** [ST-GNSS] - Odometer API */
+gps_provider_error_t
+GPSReplayProvider::enableOdo(void)
+{
+    return _odometer.enableOdo();
+}
+
+gps_provider_error_t
+GPSReplayProvider::startOdo(unsigned alarmDistance)
+{
+    _odometer.onOdo(odoCallback);
+    return _odometer.startOdo(alarmDistance);
+}
+
+gps_provider_error_t
+GPSReplayProvider::stopOdo(void)
+{
+    return _odometer.stopOdo();
+}
+
+gps_provider_error_t
+GPSReplayProvider::resetOdo(void)
+{
+    return _odometer.resetOdo();
+}
+
+/*
+ * Capture reading
+ */
+
+bool
+GPSReplayProvider::openCapture(void)
+{
+    _file = fopen(_capturePath, "rb");
+    if (_file == NULL) {
+        return false;
+    }
+    if (fillReadBuffer() && (_readLen >= sizeof(TIMESTAMPED_MAGIC)) &&
+        (memcmp(_readBuf, TIMESTAMPED_MAGIC, sizeof(TIMESTAMPED_MAGIC)) == 0)) {
+        _timestamped = true;
+        _readPos = sizeof(TIMESTAMPED_MAGIC);
+    }
+    return true;
+}
+
+bool
+GPSReplayProvider::fillReadBuffer(void)
+{
+    size_t kept = _readLen - _readPos;
+    memmove(_readBuf, &_readBuf[_readPos], kept);
+    _readPos = 0;
+    _readLen = kept + fread(&_readBuf[kept], 1, READ_BUFFER_SIZE - kept, _file);
+    return (_readLen > kept);
+}
+
+bool
+GPSReplayProvider::readNextChunk(void)
+{
+    if (_file == NULL) {
+        return false;
+    }
+    return _timestamped ? readTimestampedChunk() : readRawChunk();
+}
+
+bool
+GPSReplayProvider::readRawChunk(void)
+{
+    _chunkLen = 0;
+    while (_chunkLen < CHUNK_SIZE) {
+        if ((_readPos == _readLen) && !fillReadBuffer()) {
+            break;
+        }
+        size_t n = _readLen - _readPos;
+        if (n > CHUNK_SIZE - _chunkLen) {
+            n = CHUNK_SIZE - _chunkLen;
+        }
+        const uint8_t *nl = (const uint8_t *)memchr(&_readBuf[_readPos], '\n', n);
+        if (nl != NULL) {
+            n = (size_t)(nl - &_readBuf[_readPos]) + 1;
+        }
+        memcpy(&_chunk[_chunkLen], &_readBuf[_readPos], n);
+        _chunkLen += n;
+        _readPos += n;
+        if (nl != NULL) {
+            break;
+        }
+    }
+    if (_chunkLen == 0) {
+        return false;
+    }
+    _chunkCaptureNs = captureNsFromSentence(_chunk, _chunkLen);
+    return true;
+}
+
+bool
+GPSReplayProvider::readTimestampedChunk(void)
+{
+    while (_recordRemaining == 0) {
+        if ((_readLen - _readPos < 6) && !fillReadBuffer()) {
+            return false;
+        }
+        if (_readLen - _readPos < 6) {
+            return false; /* truncated record header */
+        }
+        const uint8_t *hdr = &_readBuf[_readPos];
+        uint32_t delayUs = (uint32_t)hdr[0] | ((uint32_t)hdr[1] << 8) |
+                           ((uint32_t)hdr[2] << 16) | ((uint32_t)hdr[3] << 24);
+        _recordRemaining = (uint32_t)hdr[4] | ((uint32_t)hdr[5] << 8);
+        _readPos += 6;
+        _captureNs += (uint64_t)delayUs * 1000ULL;
+    }
+
+    size_t want = (_recordRemaining < CHUNK_SIZE) ? (size_t)_recordRemaining : (size_t)CHUNK_SIZE;
+    _chunkLen = 0;
+    while (_chunkLen < want) {
+        if ((_readPos == _readLen) && !fillReadBuffer()) {
+            break;
+        }
+        size_t n = _readLen - _readPos;
+        if (n > want - _chunkLen) {
+            n = want - _chunkLen;
+        }
+        memcpy(&_chunk[_chunkLen], &_readBuf[_readPos], n);
+        _chunkLen += n;
+        _readPos += n;
+    }
+    _recordRemaining = (_chunkLen == want) ? (uint32_t)(_recordRemaining - want) : 0;
+    _chunkCaptureNs = _captureNs;
+    return (_chunkLen > 0);
+}
+
+/**
+ * Raw captures carry no timing information: the capture clock advances with
+ * the UTC time field of the sentences reporting one; other lines inherit the
+ * time of the previous timed sentence.
+ */
+uint64_t
+GPSReplayProvider::captureNsFromSentence(const uint8_t *data, size_t len)
+{
+    if ((len < 14) || (data[0] != '$') || (data[6] != ',')) {
+        return _captureNs;
+    }
+    const char *type = (const char *)&data[3];
+    if ((memcmp(type, "GGA", 3) != 0) && (memcmp(type, "RMC", 3) != 0) &&
+        (memcmp(type, "GLL", 3) != 0) && (memcmp(type, "ZDA", 3) != 0) &&
+        (memcmp(type, "GNS", 3) != 0)) {
+        return _captureNs;
+    }
+
+    /* GLL carries the time as field 5, the others as field 1 */
+    const uint8_t *p = &data[7];
+    const uint8_t *end = &data[len];
+    if (memcmp(type, "GLL", 3) == 0) {
+        for (unsigned commas = 0; (p < end) && (commas < 4); p++) {
+            if (*p == ',') {
+                commas++;
+            }
+        }
+    }
+    if ((end - p < 6)) {
+        return _captureNs;
+    }
+    for (unsigned i = 0; i < 6; i++) {
+        if ((p[i] < '0') || (p[i] > '9')) {
+            return _captureNs;
+        }
+    }
+
+    uint64_t todMs = (uint64_t)(((p[0] - '0') * 10 + (p[1] - '0')) * 3600000 +
+                                ((p[2] - '0') * 10 + (p[3] - '0')) * 60000 +
+                                ((p[4] - '0') * 10 + (p[5] - '0')) * 1000);
+    if ((end - p > 7) && (p[6] == '.')) {
+        unsigned scale = 100;
+        for (const uint8_t *q = &p[7]; (q < end) && (*q >= '0') && (*q <= '9') && scale; q++) {
+            todMs += (uint64_t)((*q - '0') * scale);
+            scale /= 10;
+        }
+    }
+
+    uint64_t todNs = todMs * NS_PER_MS;
+    uint64_t dayNs = _captureNs - (_captureNs % NS_PER_DAY);
+    if (todNs + NS_PER_DAY / 2 < _lastTodNs) {
+        dayNs += NS_PER_DAY; /* midnight rollover */
+    }
+    _lastTodNs = todNs;
+    _captureNs = dayNs + todNs;
+    return _captureNs;
+}
+
+/*
+ * Producer side: chunks are released into the ring according to the replay
+ * clock, either from process() or from the producer thread.
+ */
+
+uint64_t
+GPSReplayProvider::chunkReleaseNs(void)
+{
+    if (_clock == REPLAY_FASTEST) {
+        return 0;
+    }
+    if (!_haveOrigin) {
+        _originNs = _chunkCaptureNs;
+        _startNs = nowNs();
+        _haveOrigin = true;
+    }
+    double speedup = (_clock == REPLAY_ACCELERATED) ? _speedup : 1.0;
+    return _startNs + (uint64_t)((double)(_chunkCaptureNs - _originNs) / speedup);
+}
+
+/**
+ * Write the pending chunk into the ring like a UART would: what does not fit
+ * is lost and accounted as an overrun.
+ */
+bool
+GPSReplayProvider::releaseChunk(uint64_t releaseNs)
+{
+    size_t written = _ring.write(_chunk, _chunkLen);
+    _producedPosition += (uint32_t)written;
+    _chunkPending = false;
+    GPS_TRACE_INSTANT(TRACE_RX, (uint32_t)written);
+
+    if (_stamps.space() >= sizeof(ReleaseStamp_t)) {
+        ReleaseStamp_t stamp;
+        stamp.endPosition = _producedPosition;
+        stamp.reserved = 0;
+        stamp.releaseNs = (releaseNs != 0) ? releaseNs : nowNs();
+        _stamps.write((const uint8_t *)&stamp, sizeof(stamp));
+    }
+    return (written == _chunkLen);
+}
+
+void
+GPSReplayProvider::releaseDueChunks(void)
+{
+    uint64_t now = nowNs();
+    for (unsigned n = 0; n < CHUNKS_PER_PROCESS; n++) {
+        if (!_chunkPending) {
+            if (!readNextChunk()) {
+                GPS_RING_STORE_RELEASE(&_producerDone, 1U);
+                return;
+            }
+            _chunkPending = true;
+        }
+
+        uint64_t releaseNs = chunkReleaseNs();
+        if (releaseNs > now) {
+            return; /* not due yet */
+        }
+        if ((_clock == REPLAY_FASTEST) && (_ring.space() < _chunkLen)) {
+            return; /* as fast as possible, but without overrunning */
+        }
+        releaseChunk(releaseNs);
+    }
+}
+
+void *
+GPSReplayProvider::producerThread(void *arg)
+{
+    static_cast<GPSReplayProvider *>(arg)->producerLoop();
+    return NULL;
+}
+
+void
+GPSReplayProvider::producerLoop(void)
+{
+    while (GPS_RING_LOAD_ACQUIRE(&_producerRun)) {
+        if (!_chunkPending) {
+            if (!readNextChunk()) {
+                break;
+            }
+            _chunkPending = true;
+        }
+
+        uint64_t releaseNs = chunkReleaseNs();
+        uint64_t now = nowNs();
+        if (releaseNs > now) {
+            uint64_t delayNs = releaseNs - now;
+            struct timespec ts;
+            if (delayNs > 10000000ULL) {
+                delayNs = 10000000ULL; /* keep polling _producerRun */
+            }
+            ts.tv_sec = 0;
+            ts.tv_nsec = (long)delayNs;
+            nanosleep(&ts, NULL);
+            continue;
+        }
+        if ((_clock == REPLAY_FASTEST) && (_ring.space() < _chunkLen)) {
+            sched_yield();
+            continue;
+        }
+        releaseChunk(releaseNs);
+    }
+
+    if (GPS_RING_LOAD_ACQUIRE(&_producerRun)) {
+        GPS_RING_STORE_RELEASE(&_producerDone, 1U);
+        _ring.wakeup();
+    }
+}
+
+void
+GPSReplayProvider::stopProducerThread(void)
+{
+    if (!_threadStarted) {
+        return;
+    }
+    GPS_RING_STORE_RELEASE(&_producerRun, 0U);
+    pthread_join(_thread, NULL);
+    _threadStarted = false;
+}
+
+/*
+ * Consumer side: the ring is drained span by span straight into the
+ * streaming parser; the location callback is dispatched as soon as a
+ * sentence completes a fix.
+ */
+
+void
+GPSReplayProvider::drain(void)
+{
+    const uint8_t *span;
+    size_t len;
+    while ((len = _ring.readSpan(&span)) > 0) {
+        size_t offset = 0;
+        while (offset < len) {
+            size_t consumed;
+            {
+                GPS_TRACE_SCOPE(TRACE_PARSE, 0);
+                consumed = _parser.parse(&span[offset], len - offset);
+                GPS_TRACE_SCOPE_ARG((uint32_t)consumed);
+            }
+            offset += consumed;
+            if (_parser.takeLocationUpdate()) {
+                emitLocation(_ring.readPosition() + (uint32_t)offset);
+            }
+        }
+        _ring.consume(len);
+        _stats.bytes += len;
+    }
+
+    const GPSNmeaParser::ParserStats_t &parserStats = _parser.getStats();
+    _stats.sentences = parserStats.sentences;
+    _stats.badSentences = parserStats.checksumErrors + parserStats.droppedSentences;
+
+    GPSRingBuffer::RingStats_t ringStats;
+    _ring.getStats(ringStats);
+    _stats.overrunBytes = ringStats.overrunBytes;
+    _stats.overrunEvents = ringStats.overrunEvents;
+
+    _processStats.setErrors(parserStats.checksumErrors, parserStats.droppedSentences,
+                            ringStats.overrunBytes, ringStats.overrunEvents);
+}
+
+void
+GPSReplayProvider::emitLocation(uint32_t position)
+{
+    const GPSProvider::LocationUpdateParams_t &location = _parser.getLocation();
+    if (location.valid) {
+        lastLocation = location;
+        _stats.fixes++;
+    }
+
+    /* the sentence ended with the byte before position: find the release
+     * stamp of the chunk it belongs to */
+    uint64_t releaseNs = 0;
+    const uint8_t *span;
+    while (_stamps.readSpan(&span) >= sizeof(ReleaseStamp_t)) {
+        ReleaseStamp_t stamp;
+        memcpy(&stamp, span, sizeof(stamp));
+        if ((int32_t)(stamp.endPosition - position) >= 0) {
+            releaseNs = stamp.releaseNs;
+            break;
+        }
+        _stamps.consume(sizeof(stamp));
+    }
+
+    if (locationCallback != NULL) {
+        uint32_t start = _processStats.now();
+        if (releaseNs != 0) {
+            _processStats.recordLatency(GPSProcessStats::ticksFromNs(nowNs() - releaseNs));
+        }
+        {
+            GPS_TRACE_SCOPE(TRACE_LOCATION_CB, 0);
+            locationCallback(&location);
+        }
+        _processStats.recordCallback(start);
+    }
+    if (location.valid && (_geofences.getGeofenceCount() > 0)) {
+        GPS_TRACE_SCOPE(TRACE_GEOFENCE, _geofences.getGeofenceCount());
+        _geofences.onGeofenceStatusMessage(geofenceStatusMessageCallback);
+        _geofences.evaluate(location);
+    }
+    /* a single conversion of the fix serves every consumer */
+    const GPSLocalFrame::Point_t &point = location.valid ? _frame.update(location) : _frame.getPoint();
+    if (_datalog.isStarted()) {
+        GPS_TRACE_SCOPE(TRACE_DATALOG, 0);
+        _datalog.logFix(location, _parser.getSpeed(), point);
+    }
+    if (_odometer.isEnabled()) {
+        GPS_TRACE_SCOPE(TRACE_ODOMETER, 0);
+        _odometer.update(location, point);
+    }
+    _stats.locationUpdates++;
+
+    if (releaseNs == 0) {
+        return;
+    }
+
+    uint64_t latencyNs = nowNs() - releaseNs;
+    _stats.callbackLatencySumNs += latencyNs;
+    if (latencyNs < _stats.callbackLatencyMinNs) {
+        _stats.callbackLatencyMinNs = latencyNs;
+    }
+    if (latencyNs > _stats.callbackLatencyMaxNs) {
+        _stats.callbackLatencyMaxNs = latencyNs;
+    }
+}
+
+#endif /* __linux__ */
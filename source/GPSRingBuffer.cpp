@@ -0,0 +1,305 @@
+/**
+ ******************************************************************************
+ * @file    GPSRingBuffer.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Lock-free single-producer/single-consumer byte ring.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+#if !defined(__linux__)
+#include "mbed.h"
+#endif
+#include <string.h>
+#include "GPSRingBuffer.h"
+
+GPSRingBuffer::GPSRingBuffer(uint8_t *storage, size_t capacity) :
+    _storage(storage),
+    _mask(0),
+    _event(NULL)
+{
+    if ((capacity >= 2) && (capacity <= 0x80000000UL) && ((capacity & (capacity - 1)) == 0)) {
+        _mask = (uint32_t)(capacity - 1);
+    }
+    reset();
+}
+
+void
+GPSRingBuffer::reset(void)
+{
+    _head = 0;
+    _cachedTail = 0;
+    _bytesWritten = 0;
+    _overrunBytes = 0;
+    _overrunEvents = 0;
+    _highWater = 0;
+
+    _tail = 0;
+    _cachedHead = 0;
+    _bytesRead = 0;
+    _waiting = 0;
+}
+
+/*
+ * Producer side
+ */
+
+size_t
+GPSRingBuffer::write(const uint8_t *data, size_t len)
+{
+    const uint32_t size = _mask + 1;
+    uint32_t head = _head;
+    uint32_t free = size - (head - _cachedTail);
+    if (free < len) {
+        _cachedTail = GPS_RING_LOAD_ACQUIRE(&_tail);
+        free = size - (head - _cachedTail);
+    }
+
+    size_t n = (len < free) ? len : free;
+    if (n < len) {
+        reportOverrun(len - n);
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    uint32_t offset = head & _mask;
+    size_t first = size - offset;
+    if (first > n) {
+        first = n;
+    }
+    memcpy(&_storage[offset], data, first);
+    memcpy(&_storage[0], &data[first], n - first);
+
+    commitWrite(n);
+    return n;
+}
+
+size_t
+GPSRingBuffer::writeSpan(uint8_t **span)
+{
+    const uint32_t size = _mask + 1;
+    uint32_t head = _head;
+    uint32_t offset = head & _mask;
+    uint32_t free = size - (head - _cachedTail);
+    if (free < size - offset) {
+        _cachedTail = GPS_RING_LOAD_ACQUIRE(&_tail);
+        free = size - (head - _cachedTail);
+    }
+
+    *span = &_storage[offset];
+    return (free < size - offset) ? free : size - offset;
+}
+
+void
+GPSRingBuffer::commitWrite(size_t len)
+{
+    uint32_t head = _head + (uint32_t)len;
+    uint32_t fill = head - _cachedTail;
+    /* counters are read by getStats() from the consumer side */
+    GPS_RING_STORE_RELEASE(&_bytesWritten, _bytesWritten + (uint32_t)len);
+    if (fill > _highWater) {
+        /* the cached tail only bounds the fill: confirm a new maximum */
+        _cachedTail = GPS_RING_LOAD_ACQUIRE(&_tail);
+        fill = head - _cachedTail;
+        if (fill > _highWater) {
+            GPS_RING_STORE_RELEASE(&_highWater, fill);
+        }
+    }
+    GPS_RING_STORE_RELEASE(&_head, head);
+    notifyConsumer();
+}
+
+void
+GPSRingBuffer::reportOverrun(size_t len)
+{
+    GPS_RING_STORE_RELEASE(&_overrunBytes, _overrunBytes + (uint32_t)len);
+    GPS_RING_STORE_RELEASE(&_overrunEvents, _overrunEvents + 1);
+}
+
+size_t
+GPSRingBuffer::space(void) const
+{
+    return (_mask + 1) - (_head - GPS_RING_LOAD_ACQUIRE(&_tail));
+}
+
+void
+GPSRingBuffer::notifyConsumer(void)
+{
+    if (_event == NULL) {
+        return;
+    }
+    /* pairs with the barrier in waitForData(): either the consumer sees the
+     * new head, or we see its waiting flag */
+    GPS_RING_FULL_BARRIER();
+    if (GPS_RING_LOAD_ACQUIRE(&_waiting) != 0) {
+        _event->signal();
+    }
+}
+
+void
+GPSRingBuffer::wakeup(void)
+{
+    if (_event != NULL) {
+        GPS_RING_FULL_BARRIER();
+        _event->signal();
+    }
+}
+
+/*
+ * Consumer side
+ */
+
+size_t
+GPSRingBuffer::readSpan(const uint8_t **span)
+{
+    uint32_t tail = _tail;
+    if (_cachedHead == tail) {
+        _cachedHead = GPS_RING_LOAD_ACQUIRE(&_head);
+    }
+
+    uint32_t n = _cachedHead - tail;
+    uint32_t offset = tail & _mask;
+    if (n > (_mask + 1) - offset) {
+        n = (_mask + 1) - offset;
+    }
+    *span = &_storage[offset];
+    return n;
+}
+
+void
+GPSRingBuffer::consume(size_t len)
+{
+    _bytesRead += (uint32_t)len;
+    GPS_RING_STORE_RELEASE(&_tail, _tail + (uint32_t)len);
+}
+
+size_t
+GPSRingBuffer::available(void) const
+{
+    return GPS_RING_LOAD_ACQUIRE(&_head) - _tail;
+}
+
+bool
+GPSRingBuffer::waitForData(void)
+{
+    if (available() > 0) {
+        return true;
+    }
+    if (_event == NULL) {
+        return false;
+    }
+
+    GPS_RING_STORE_RELEASE(&_waiting, 1U);
+    GPS_RING_FULL_BARRIER();
+    if (available() == 0) {
+        _event->wait();
+    }
+    GPS_RING_STORE_RELEASE(&_waiting, 0U);
+
+    return (available() > 0);
+}
+
+void
+GPSRingBuffer::getStats(RingStats_t &stats) const
+{
+    stats.bytesWritten = GPS_RING_LOAD_ACQUIRE(&_bytesWritten);
+    stats.bytesRead = _bytesRead;
+    stats.overrunBytes = GPS_RING_LOAD_ACQUIRE(&_overrunBytes);
+    stats.overrunEvents = GPS_RING_LOAD_ACQUIRE(&_overrunEvents);
+    stats.highWater = GPS_RING_LOAD_ACQUIRE(&_highWater);
+}
+
+/*
+ * Default wakeup primitive
+ */
+
+#if defined(__linux__)
+
+GPSRingBufferEvent::GPSRingBufferEvent() :
+    _pending(false)
+{
+    pthread_mutex_init(&_mutex, NULL);
+    pthread_cond_init(&_cond, NULL);
+}
+
+GPSRingBufferEvent::~GPSRingBufferEvent()
+{
+    pthread_cond_destroy(&_cond);
+    pthread_mutex_destroy(&_mutex);
+}
+
+void
+GPSRingBufferEvent::wait(void)
+{
+    pthread_mutex_lock(&_mutex);
+    while (!_pending) {
+        pthread_cond_wait(&_cond, &_mutex);
+    }
+    _pending = false;
+    pthread_mutex_unlock(&_mutex);
+}
+
+void
+GPSRingBufferEvent::signal(void)
+{
+    pthread_mutex_lock(&_mutex);
+    _pending = true;
+    pthread_cond_signal(&_cond);
+    pthread_mutex_unlock(&_mutex);
+}
+
+#else
+
+GPSRingBufferEvent::GPSRingBufferEvent()
+{
+    /* empty */
+}
+
+GPSRingBufferEvent::~GPSRingBufferEvent()
+{
+    /* empty */
+}
+
+void
+GPSRingBufferEvent::wait(void)
+{
+    /* the event register latches any SEV or interrupt since the last WFE */
+    __WFE();
+}
+
+void
+GPSRingBufferEvent::signal(void)
+{
+    __SEV();
+}
+
+#endif /* __linux__ */
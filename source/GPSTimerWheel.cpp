@@ -0,0 +1,163 @@
+/**
+ ******************************************************************************
+ * @file    GPSTimerWheel.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Hierarchical timer wheel.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+#include <string.h>
+#include "GPSTimerWheel.h"
+
+GPSTimerWheel::GPSTimerWheel(uint32_t tickMs) :
+    _tickMs((tickMs != 0) ? tickMs : 1),
+    _tick(0),
+    _originMs(0),
+    _started(false),
+    _armed(0)
+{
+    memset(_wheel, 0, sizeof(_wheel));
+}
+
+void
+GPSTimerWheel::insert(Timer_t &timer)
+{
+    uint32_t delta = timer.expiry - _tick;
+    unsigned level = 0;
+    while ((level < LEVELS - 1) && (delta >= (1UL << (LEVEL_BITS * (level + 1))))) {
+        level++;
+    }
+
+    uint32_t slot;
+    if ((level == LEVELS - 1) && (delta >= (1UL << (LEVEL_BITS * LEVELS)) - (1UL << (LEVEL_BITS * level)))) {
+        /* beyond the range: park in the farthest top bucket, it is
+         * re-inserted (closer) when that bucket cascades */
+        slot = ((_tick >> (LEVEL_BITS * level)) - 1) & (SLOTS - 1);
+    } else {
+        slot = (timer.expiry >> (LEVEL_BITS * level)) & (SLOTS - 1);
+    }
+
+    Timer_t **head = &_wheel[level][slot];
+    timer.head = head;
+    timer.prev = NULL;
+    timer.next = *head;
+    if (*head != NULL) {
+        (*head)->prev = &timer;
+    }
+    *head = &timer;
+}
+
+void
+GPSTimerWheel::start(Timer_t &timer, uint32_t delayMs)
+{
+    cancel(timer);
+    uint32_t ticks = (delayMs + _tickMs - 1) / _tickMs;
+    timer.expiry = _tick + ((ticks != 0) ? ticks : 1);
+    insert(timer);
+    _armed++;
+}
+
+void
+GPSTimerWheel::cancel(Timer_t &timer)
+{
+    if (timer.head == NULL) {
+        return;
+    }
+    if (timer.prev != NULL) {
+        timer.prev->next = timer.next;
+    } else {
+        *timer.head = timer.next;
+    }
+    if (timer.next != NULL) {
+        timer.next->prev = timer.prev;
+    }
+    timer.next = timer.prev = NULL;
+    timer.head = NULL;
+    _armed--;
+}
+
+void
+GPSTimerWheel::cascade(unsigned level)
+{
+    unsigned slot = (_tick >> (LEVEL_BITS * level)) & (SLOTS - 1);
+    Timer_t *timer = _wheel[level][slot];
+    _wheel[level][slot] = NULL;
+    while (timer != NULL) {
+        Timer_t *next = timer->next;
+        insert(*timer);
+        timer = next;
+    }
+}
+
+unsigned
+GPSTimerWheel::advance(uint64_t nowMs)
+{
+    if (!_started) {
+        _originMs = nowMs;
+        _started = true;
+        return 0;
+    }
+    if (nowMs <= now()) {
+        return 0;
+    }
+
+    uint64_t ticks = (nowMs - now()) / _tickMs;
+    if (_armed == 0) {
+        /* nothing to run: jump */
+        _tick += (uint32_t)ticks;
+        return 0;
+    }
+
+    unsigned fired = 0;
+    while (ticks-- > 0) {
+        _tick++;
+        for (unsigned level = 1; level < LEVELS; level++) {
+            if ((_tick & ((1UL << (LEVEL_BITS * level)) - 1)) != 0) {
+                break;
+            }
+            cascade(level);
+        }
+
+        Timer_t **head = &_wheel[0][_tick & (SLOTS - 1)];
+        while (*head != NULL) {
+            Timer_t *timer = *head;
+            cancel(*timer);
+            timer->callback(timer->context);
+            fired++;
+        }
+        if (_armed == 0) {
+            _tick += (uint32_t)ticks;
+            break;
+        }
+    }
+    return fired;
+}
@@ -0,0 +1,231 @@
+/**
+ ******************************************************************************
+ * @file    GPSTraceRecorder.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Lock-free event trace of the GPS pipeline stages.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#if defined(__linux__)
+#include <time.h>
+#endif
+#include "GPSTraceRecorder.h"
+
+#if defined(GPS_TRACE)
+
+uintptr_t GPSTraceRecorder::_activeSlot = 0;
+
+static const char *const STAGE_NAMES[GPSTraceRecorder::TRACE_STAGES] = {
+    "rx",
+    "process",
+    "parse",
+    "sentence",
+    "location callback",
+    "geofence",
+    "geofence callback",
+    "datalog",
+    "datalog callback",
+    "odometer",
+    "odometer callback"
+};
+
+/* Chrome trace threads: the receive side stands for the UART ISR. */
+static const unsigned TID_PROCESS = 1;
+static const unsigned TID_RX = 2;
+
+GPSTraceRecorder::GPSTraceRecorder(TraceEvent_t *storage, unsigned capacity) :
+    _events(storage),
+    _mask(0),
+    _next(0)
+{
+    if ((storage != NULL) && (capacity >= 2) && ((capacity & (capacity - 1)) == 0)) {
+        _mask = capacity - 1;
+        clear();
+    }
+}
+
+void
+GPSTraceRecorder::record(Stage_t stage, uint64_t startNs, uint64_t endNs, uint32_t arg, bool instant)
+{
+    if (_mask == 0) {
+        return;
+    }
+    uint32_t claim = GPS_TRACE_FETCH_ADD(&_next);
+    TraceEvent_t &event = _events[claim & _mask];
+
+    /* readers skip the slot until the sequence matches the claim again;
+     * the fence keeps the payload stores from passing the invalidation */
+    GPS_TRACE_STORE_RELEASE(&event.sequence, 0U);
+    GPS_TRACE_RELEASE_FENCE();
+    event.timestampNs = startNs;
+    uint64_t duration = (endNs > startNs) ? endNs - startNs : 0;
+    event.durationNs = (duration > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)duration;
+    event.arg = arg;
+    event.stage = (uint16_t)stage;
+    event.instant = instant ? 1 : 0;
+    GPS_TRACE_STORE_RELEASE(&event.sequence, claim + 1);
+}
+
+unsigned
+GPSTraceRecorder::getCount(void) const
+{
+    uint32_t total = getTotal();
+    return (total > _mask) ? _mask + 1 : total;
+}
+
+bool
+GPSTraceRecorder::getEvent(unsigned index, TraceEvent_t &event) const
+{
+    uint32_t total = getTotal();
+    unsigned count = (total > _mask) ? _mask + 1 : total;
+    if (index >= count) {
+        return false;
+    }
+    uint32_t claim = total - count + index;
+    const TraceEvent_t &slot = _events[claim & _mask];
+    if (GPS_TRACE_LOAD_ACQUIRE(&slot.sequence) != claim + 1) {
+        return false;
+    }
+    event = slot;
+    GPS_TRACE_ACQUIRE_FENCE();
+    /* overwritten while copying? */
+    return GPS_TRACE_LOAD_ACQUIRE(&slot.sequence) == claim + 1;
+}
+
+void
+GPSTraceRecorder::clear(void)
+{
+    if (_events != NULL) {
+        memset(_events, 0, ((size_t)_mask + 1) * sizeof(TraceEvent_t));
+    }
+    GPS_TRACE_STORE_RELEASE(&_next, 0U);
+}
+
+const char *
+GPSTraceRecorder::getStageName(Stage_t stage)
+{
+    return (stage < TRACE_STAGES) ? STAGE_NAMES[stage] : "?";
+}
+
+uint64_t
+GPSTraceRecorder::monotonicNs(void)
+{
+#if defined(__linux__)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+#if defined(__linux__)
+
+int
+GPSTraceRecorder::writeChromeJson(const char *path) const
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return -1;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(file, "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"process()\"}},\n", TID_PROCESS);
+    fprintf(file, "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"receive (ISR)\"}}", TID_RX);
+
+    /* timestamps relative to the earliest start, in microseconds; complete
+     * events are recorded when they end, so that is not always the oldest */
+    unsigned count = getCount();
+    uint64_t originNs = ~0ULL;
+    for (unsigned i = 0; i < count; i++) {
+        TraceEvent_t event;
+        if (getEvent(i, event) && (event.timestampNs < originNs)) {
+            originNs = event.timestampNs;
+        }
+    }
+
+    int written = 0;
+    for (unsigned i = 0; i < count; i++) {
+        TraceEvent_t event;
+        if (!getEvent(i, event) || (event.stage >= TRACE_STAGES)) {
+            continue;
+        }
+        uint64_t ts = (event.timestampNs > originNs) ? event.timestampNs - originNs : 0;
+
+        fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"gps\",\"pid\":1,\"tid\":%u,\"ts\":%llu.%03u",
+                STAGE_NAMES[event.stage], (event.stage == TRACE_RX) ? TID_RX : TID_PROCESS,
+                (unsigned long long)(ts / 1000), (unsigned)(ts % 1000));
+        if (event.instant) {
+            fprintf(file, ",\"ph\":\"i\",\"s\":\"t\"");
+        } else {
+            fprintf(file, ",\"ph\":\"X\",\"dur\":%u.%03u", event.durationNs / 1000, event.durationNs % 1000);
+        }
+        if (event.stage == TRACE_SENTENCE) {
+            char type[4];
+            type[0] = (char)(event.arg >> 16);
+            type[1] = (char)(event.arg >> 8);
+            type[2] = (char)event.arg;
+            type[3] = '\0';
+            for (unsigned c = 0; c < 3; c++) {
+                if ((type[c] < 'A') || (type[c] > 'Z')) {
+                    type[c] = '?';
+                }
+            }
+            fprintf(file, ",\"args\":{\"type\":\"%s\"}}", type);
+        } else {
+            fprintf(file, ",\"args\":{\"arg\":%d}}", (int)event.arg);
+        }
+        written++;
+    }
+
+    fprintf(file, "\n]}\n");
+    if (fclose(file) != 0) {
+        return -1;
+    }
+    return written;
+}
+
+#else
+
+int
+GPSTraceRecorder::writeChromeJson(const char *path) const
+{
+    (void)path;
+    return -1;
+}
+
+#endif /* __linux__ */
+
+#endif /* GPS_TRACE */
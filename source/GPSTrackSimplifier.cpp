@@ -0,0 +1,203 @@
+/**
+ ******************************************************************************
+ * @file    GPSTrackSimplifier.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Online trajectory simplification of location updates.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "GPSTrackSimplifier.h"
+#include "GPSProviderUtils.h"
+
+static const double METERS_PER_DEG = GPS_EARTH_RADIUS_M * GPS_DEG_TO_RAD;
+
+GPSTrackSimplifier::GPSTrackSimplifier(double tolerance, unsigned window) :
+    _maxInterval(0),
+    _window((window == 0) ? 1 : window),
+    _count(0),
+    _haveAnchor(false),
+    _havePending(false),
+    _pointCallback(NULL)
+{
+    setTolerance(tolerance);
+    _x = (double *)malloc(_window * 2 * sizeof(double));
+    if (_x == NULL) {
+        _window = 0;
+    }
+    _y = _x + _window;
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+GPSTrackSimplifier::~GPSTrackSimplifier()
+{
+    free(_x);
+}
+
+bool
+GPSTrackSimplifier::update(const GPSProvider::LocationUpdateParams_t &location)
+{
+    if (!location.valid) {
+        return update(location, _frame.getPoint());
+    }
+    return update(location, _frame.update(location));
+}
+
+bool
+GPSTrackSimplifier::update(const GPSProvider::LocationUpdateParams_t &location, const GPSLocalFrame::Point_t &point)
+{
+    if (!location.valid) {
+        _stats.invalid++;
+        bool emitted = _havePending;
+        flush();
+        _haveAnchor = false;
+        return emitted;
+    }
+    _stats.fixes++;
+
+    if (!_haveAnchor || (_window == 0)) {
+        /* start of a track: emitted right away */
+        _anchor = point;
+        _anchorTime = location.utcTime;
+        _haveAnchor = true;
+        _havePending = false;
+        _count = 0;
+        _stats.emitted++;
+        if (_pointCallback) {
+            _pointCallback(&location);
+        }
+        return true;
+    }
+
+    double x;
+    double y;
+    toAnchor(point, x, y);
+
+    bool emitted = false;
+    if (_havePending) {
+        bool forced = (_count == _window) ||
+                      ((_maxInterval != 0) && (location.utcTime - _anchorTime > _maxInterval));
+        if (forced || !fits(x, y)) {
+            emitPending(forced);
+            toAnchor(point, x, y);
+            emitted = true;
+        } else {
+            /* the pending fix is dropped: it only constrains the window now */
+            _x[_count] = _pendingX;
+            _y[_count] = _pendingY;
+            _count++;
+        }
+    }
+
+    _pending = location;
+    _pendingPoint = point;
+    _pendingX = x;
+    _pendingY = y;
+    _havePending = true;
+    return emitted;
+}
+
+void
+GPSTrackSimplifier::flush(void)
+{
+    if (_havePending) {
+        emitPending(false);
+    }
+}
+
+void
+GPSTrackSimplifier::reset(void)
+{
+    _haveAnchor = false;
+    _havePending = false;
+    _count = 0;
+    _frame.reset();
+}
+
+void
+GPSTrackSimplifier::emitPending(bool forced)
+{
+    _anchor = _pendingPoint;
+    _anchorTime = _pending.utcTime;
+    _havePending = false;
+    _count = 0;
+    _stats.emitted++;
+    if (forced) {
+        _stats.forced++;
+    }
+    if (_pointCallback) {
+        _pointCallback(&_pending);
+    }
+}
+
+/* Equirectangular offset (meters) of point from the anchor. */
+void
+GPSTrackSimplifier::toAnchor(const GPSLocalFrame::Point_t &point, double &x, double &y) const
+{
+    double dLon = point.lon - _anchor.lon;
+    if (dLon > 180.0) {
+        dLon -= 360.0;
+    } else if (dLon < -180.0) {
+        dLon += 360.0;
+    }
+    x = dLon * _anchor.cosLat * METERS_PER_DEG;
+    y = (point.lat - _anchor.lat) * METERS_PER_DEG;
+}
+
+/* true if the segment from the anchor to (x, y) passes within the
+ * tolerance of the pending fix and of every fix of the window. Newest
+ * first: on a turn, those are the fixes that fail. */
+bool
+GPSTrackSimplifier::fits(double x, double y) const
+{
+    double len2 = x * x + y * y;
+    double inv = (len2 > 0.0) ? 1.0 / len2 : 0.0;
+
+    for (unsigned i = _count + 1; i-- > 0; ) {
+        double px = (i < _count) ? _x[i] : _pendingX;
+        double py = (i < _count) ? _y[i] : _pendingY;
+        double t = (px * x + py * y) * inv;
+        if (t < 0.0) {
+            t = 0.0;
+        } else if (t > 1.0) {
+            t = 1.0;
+        }
+        double ex = px - t * x;
+        double ey = py - t * y;
+        if (ex * ex + ey * ey > _tolerance2) {
+            return false;
+        }
+    }
+    return true;
+}
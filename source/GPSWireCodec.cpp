@@ -0,0 +1,450 @@
+/**
+ ******************************************************************************
+ * @file    GPSWireCodec.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Compact delta encoding of location streams for uplink.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#include <string.h>
+#include <math.h>
+#include "GPSWireCodec.h"
+#include "GPSVarint.h"
+#include "GPSProviderUtils.h"
+
+static const uint8_t KEY_MARKER = 0xB5;
+
+/* tag byte; bit 7 stays clear so a tag never looks like KEY_MARKER */
+static const uint8_t TAG_SEQ_MASK   = 0x0F;
+static const uint8_t TAG_SATELLITES = 0x10;
+static const uint8_t TAG_ALTITUDE   = 0x20;
+static const uint8_t TAG_VALID      = 0x40;
+static const uint8_t TAG_RESERVED   = 0x80;
+
+static uint16_t
+crc16(const uint8_t *data, unsigned len)
+{
+    /* CRC-16/CCITT-FALSE */
+    uint16_t crc = 0xFFFF;
+    for (unsigned i = 0; i < len; i++) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (unsigned b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static int32_t
+quantize(double value, double scale)
+{
+    return (int32_t)floor(value * scale + 0.5);
+}
+
+/* Half turn of longitude, in quanta. */
+static int32_t
+halfTurn(uint32_t coordStep)
+{
+    return (int32_t)((1800000000ULL + coordStep / 2) / coordStep);
+}
+
+/* Bring a longitude (quanta) into [-halfTurn, halfTurn). */
+static int32_t
+wrapLon(int64_t lon, int32_t half)
+{
+    if (lon >= half) {
+        lon -= 2 * (int64_t)half;
+    } else if (lon < -(int64_t)half) {
+        lon += 2 * (int64_t)half;
+    }
+    return (int32_t)lon;
+}
+
+/* Difference modulo 2^32, so that any pair round trips. */
+static int32_t
+delta32(int32_t value, int32_t previous)
+{
+    return (int32_t)((uint32_t)value - (uint32_t)previous);
+}
+
+static int32_t
+apply32(int32_t previous, int32_t delta)
+{
+    return (int32_t)((uint32_t)previous + (uint32_t)delta);
+}
+
+/* Bounded reader over a frame being decoded. */
+struct FrameReader {
+    const uint8_t *data;
+    size_t        len;
+    size_t        pos;
+    bool          truncated;
+    bool          malformed;
+
+    FrameReader(const uint8_t *d, size_t l, size_t p) :
+        data(d), len(l), pos(p), truncated(false), malformed(false) {}
+
+    bool ok(void) const {
+        return !truncated && !malformed;
+    }
+
+    void fail(unsigned maxBytes) {
+        if (len - pos < maxBytes) {
+            truncated = true;
+        } else {
+            malformed = true;
+        }
+    }
+
+    uint32_t u32(void) {
+        uint32_t value = 0;
+        if (ok()) {
+            unsigned n = GPSVarint::get32(data + pos, len - pos, value);
+            if (n == 0) {
+                fail(GPSVarint::MAX_BYTES32);
+            }
+            pos += n;
+        }
+        return value;
+    }
+
+    uint64_t u64(void) {
+        uint64_t value = 0;
+        if (ok()) {
+            unsigned n = GPSVarint::get64(data + pos, len - pos, value);
+            if (n == 0) {
+                fail(GPSVarint::MAX_BYTES);
+            }
+            pos += n;
+        }
+        return value;
+    }
+
+    int32_t s32(void) {
+        return GPSVarint::unzigzag32(u32());
+    }
+
+    int64_t s64(void) {
+        return GPSVarint::unzigzag64(u64());
+    }
+};
+
+/*
+ * Encoder
+ */
+
+GPSWireEncoder::GPSWireEncoder(uint32_t coordStep, uint32_t altitudeStep, unsigned keyframeInterval) :
+    _coordStep((coordStep == 0) ? 1 : ((coordStep > MAX_COORD_STEP) ? MAX_COORD_STEP : coordStep)),
+    _altitudeStep((altitudeStep == 0) ? 1 : altitudeStep),
+    _keyframeInterval((keyframeInterval == 0) ? 1 : keyframeInterval)
+{
+    reset();
+}
+
+void
+GPSWireEncoder::reset(void)
+{
+    _sinceKeyframe = _keyframeInterval;
+    _seq = 0;
+    _time = 0;
+    _timeDelta = 0;
+    _lat = 0;
+    _lon = 0;
+    _alt = 0;
+    _numGPSSVs = 0;
+    _numGLOSVs = 0;
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+size_t
+GPSWireEncoder::encode(const GPSProvider::LocationUpdateParams_t &location, uint8_t *out, size_t capacity)
+{
+    if ((out == NULL) || (capacity < MAX_FRAME_SIZE)) {
+        return 0;
+    }
+
+    /* an invalid fix keeps the previous position */
+    int32_t lat = _lat;
+    int32_t lon = _lon;
+    if (location.valid) {
+        double scale = 1e7 / _coordStep;
+        int32_t half = halfTurn(_coordStep);
+        lat = quantize(location.lat, scale);
+        lon = wrapLon(quantize(location.lon, scale), half);
+    }
+    int32_t alt = quantize(location.altitude, 100.0 / _altitudeStep);
+
+    uint8_t tag = (uint8_t)(_seq & TAG_SEQ_MASK);
+    if (location.valid) {
+        tag |= TAG_VALID;
+    }
+
+    size_t n = 0;
+    if (_sinceKeyframe >= _keyframeInterval) {
+        out[n++] = KEY_MARKER;
+        out[n++] = tag;
+        n += GPSVarint::put32(&out[n], _coordStep);
+        n += GPSVarint::put32(&out[n], _altitudeStep);
+        n += GPSVarint::put64(&out[n], location.utcTime);
+        n += GPSVarint::put32(&out[n], GPSVarint::zigzag32(lat));
+        n += GPSVarint::put32(&out[n], GPSVarint::zigzag32(lon));
+        n += GPSVarint::put32(&out[n], GPSVarint::zigzag32(alt));
+        n += GPSVarint::put32(&out[n], (uint32_t)location.numGPSSVs);
+        n += GPSVarint::put32(&out[n], (uint32_t)location.numGLOSVs);
+        uint16_t crc = crc16(out, (unsigned)n);
+        out[n++] = (uint8_t)crc;
+        out[n++] = (uint8_t)(crc >> 8);
+
+        _timeDelta = 0;
+        _sinceKeyframe = 1;
+        _stats.keyframes++;
+    } else {
+        bool altChanged = (alt != _alt);
+        bool svsChanged = (location.numGPSSVs != _numGPSSVs) || (location.numGLOSVs != _numGLOSVs);
+        if (altChanged) {
+            tag |= TAG_ALTITUDE;
+        }
+        if (svsChanged) {
+            tag |= TAG_SATELLITES;
+        }
+
+        int64_t timeDelta = (int64_t)(location.utcTime - _time);
+        out[n++] = tag;
+        n += GPSVarint::put64(&out[n], GPSVarint::zigzag64(timeDelta - _timeDelta));
+        if (location.valid) {
+            n += GPSVarint::put32(&out[n], GPSVarint::zigzag32(delta32(lat, _lat)));
+            n += GPSVarint::put32(&out[n], GPSVarint::zigzag32(wrapLon((int64_t)lon - _lon, halfTurn(_coordStep))));
+        }
+        if (altChanged) {
+            n += GPSVarint::put32(&out[n], GPSVarint::zigzag32(delta32(alt, _alt)));
+        }
+        if (svsChanged) {
+            n += GPSVarint::put32(&out[n], (uint32_t)location.numGPSSVs);
+            n += GPSVarint::put32(&out[n], (uint32_t)location.numGLOSVs);
+        }
+
+        _timeDelta = timeDelta;
+        _sinceKeyframe++;
+    }
+
+    _time = location.utcTime;
+    _lat = lat;
+    _lon = lon;
+    _alt = alt;
+    _numGPSSVs = location.numGPSSVs;
+    _numGLOSVs = location.numGLOSVs;
+    _seq++;
+
+    _stats.fixes++;
+    _stats.bytes += n;
+    return n;
+}
+
+/*
+ * Decoder
+ */
+
+GPSWireDecoder::GPSWireDecoder()
+{
+    reset();
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void
+GPSWireDecoder::reset(void)
+{
+    _synced = false;
+    _locationDecoded = false;
+    _seq = 0;
+    _coordStep = 1;
+    _altitudeStep = 1;
+    _time = 0;
+    _timeDelta = 0;
+    _lat = 0;
+    _lon = 0;
+    _alt = 0;
+    memset(&_location, 0, sizeof(_location));
+}
+
+size_t
+GPSWireDecoder::decode(const uint8_t *data, size_t len)
+{
+    if ((data == NULL) || (len == 0)) {
+        return 0;
+    }
+
+    if (data[0] == KEY_MARKER) {
+        return decodeKeyframe(data, len);
+    }
+
+    if (!_synced) {
+        /* look for the next keyframe */
+        size_t skip = 1;
+        while ((skip < len) && (data[skip] != KEY_MARKER)) {
+            skip++;
+        }
+        _stats.skippedBytes += (uint32_t)skip;
+        return skip;
+    }
+
+    if (data[0] & TAG_RESERVED) {
+        return loseSync();
+    }
+
+    return decodeDelta(data, len);
+}
+
+size_t
+GPSWireDecoder::decodeKeyframe(const uint8_t *data, size_t len)
+{
+    if (len < 2) {
+        return 0;
+    }
+    FrameReader reader(data, len, 2);
+    uint8_t tag = data[1];
+    uint32_t coordStep = reader.u32();
+    uint32_t altitudeStep = reader.u32();
+    uint64_t time = reader.u64();
+    int32_t lat = reader.s32();
+    int32_t lon = reader.s32();
+    int32_t alt = reader.s32();
+    uint32_t numGPSSVs = reader.u32();
+    uint32_t numGLOSVs = reader.u32();
+
+    if (reader.ok() && (len - reader.pos < 2)) {
+        reader.truncated = true;
+    }
+    if (reader.truncated) {
+        return 0;
+    }
+    if (reader.malformed ||
+        (tag & TAG_RESERVED) ||
+        (coordStep == 0) || (coordStep > GPSWireEncoder::MAX_COORD_STEP) || (altitudeStep == 0) ||
+        (data[reader.pos] | (data[reader.pos + 1] << 8)) != crc16(data, (unsigned)reader.pos)) {
+        /* not a keyframe after all: resume the search past the marker */
+        _stats.badFrames++;
+        if (!_synced) {
+            _stats.skippedBytes++;
+        }
+        return 1;
+    }
+
+    _synced = true;
+    _seq = tag & TAG_SEQ_MASK;
+    _coordStep = coordStep;
+    _altitudeStep = altitudeStep;
+    _time = time;
+    _timeDelta = 0;
+    _lat = lat;
+    _lon = lon;
+    _alt = alt;
+    _location.valid = (tag & TAG_VALID) != 0;
+    _location.numGPSSVs = numGPSSVs;
+    _location.numGLOSVs = numGLOSVs;
+    _stats.keyframes++;
+    publish();
+    return reader.pos + 2;
+}
+
+size_t
+GPSWireDecoder::decodeDelta(const uint8_t *data, size_t len)
+{
+    FrameReader reader(data, len, 1);
+    uint8_t tag = data[0];
+    int64_t timeDelta = _timeDelta + reader.s64();
+    int32_t dLat = 0;
+    int32_t dLon = 0;
+    int32_t dAlt = 0;
+    uint32_t numGPSSVs = _location.numGPSSVs;
+    uint32_t numGLOSVs = _location.numGLOSVs;
+    if (tag & TAG_VALID) {
+        dLat = reader.s32();
+        dLon = reader.s32();
+    }
+    if (tag & TAG_ALTITUDE) {
+        dAlt = reader.s32();
+    }
+    if (tag & TAG_SATELLITES) {
+        numGPSSVs = reader.u32();
+        numGLOSVs = reader.u32();
+    }
+
+    if (reader.truncated) {
+        return 0;
+    }
+    if (reader.malformed) {
+        return loseSync();
+    }
+    if ((tag & TAG_SEQ_MASK) != ((_seq + 1) & TAG_SEQ_MASK)) {
+        /* frames were lost: the deltas no longer apply */
+        _synced = false;
+        _stats.lostSync++;
+        _stats.skippedFrames++;
+        return reader.pos;
+    }
+
+    _seq = tag & TAG_SEQ_MASK;
+    _timeDelta = timeDelta;
+    _time += (uint64_t)timeDelta;
+    _lat = apply32(_lat, dLat);
+    _lon = wrapLon((int64_t)_lon + dLon, halfTurn(_coordStep));
+    _alt = apply32(_alt, dAlt);
+    _location.valid = (tag & TAG_VALID) != 0;
+    _location.numGPSSVs = numGPSSVs;
+    _location.numGLOSVs = numGLOSVs;
+    _stats.deltas++;
+    publish();
+    return reader.pos;
+}
+
+size_t
+GPSWireDecoder::loseSync(void)
+{
+    _synced = false;
+    _stats.lostSync++;
+    _stats.badFrames++;
+    _stats.skippedBytes++;
+    return 1;
+}
+
+void
+GPSWireDecoder::publish(void)
+{
+    _location.version = 1;
+    _location.lat = _lat * (_coordStep * 1e-7);
+    _location.lon = _lon * (_coordStep * 1e-7);
+    _location.altitude = (GPSProvider::Altitude_t)(_alt * (_altitudeStep * 0.01));
+    _location.utcTime = _time;
+    GPSProviderUtils::utcMsToGPSTime(_time, _location.gpsTime);
+    _locationDecoded = true;
+}
@@ -0,0 +1,2433 @@
+/**
+ ******************************************************************************
+ * @file    GPSBenchmark.cpp
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Host-side benchmark suite of the GPSProvider code paths.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#if defined(__linux__)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include "GPSBenchmark.h"
+#include "GPSNmeaParser.h"
+#include "GPSGeofenceEngine.h"
+#include "GPSGeofenceIndex.h"
+#include "GPSGeofenceWakeup.h"
+#include "GPSGeofenceVirtualizer.h"
+#include "GPSDatalogEngine.h"
+#include "GPSDatalogMirror.h"
+#include "GPSDatalogDownloader.h"
+#include "GPSDatalogArchive.h"
+#include "GPSLogBlock.h"
+#include "GPSWireCodec.h"
+#include "GPSTrackSimplifier.h"
+#include "GPSDeadReckoning.h"
+#include "GPSPowerScheduler.h"
+#include "GPSOdometer.h"
+#include "GPSReplayProvider.h"
+#include "GPSProviderUtils.h"
+#include "GPSFixedPoint.h"
+#include "GPSLocalFrame.h"
+#include "GPSRingBuffer.h"
+#include "GPSTraceRecorder.h"
+
+/* synthetic track: a winding drive at 10 m/s, one fix per second */
+static const unsigned TRACK_FIXES = 600;
+static const unsigned TRACK_SENTENCE_MAX = 96;
+static const unsigned SMALL_FENCE_COUNT = 64;
+static const unsigned DATALOG_CAPACITY = 16384;
+static const unsigned QUERY_RECORDS = 4096;
+static const unsigned QUERY_ENTRIES = 256;
+static const unsigned KERNEL_FENCES = 1024;
+static const unsigned WAKEUP_FENCES[] = { 5, 30, 200 };
+static const unsigned SIMPLIFIER_TOLERANCES[] = { 1, 5, 10, 25 };
+static const unsigned DR_THRESHOLDS[] = { 25, 50, 100 };
+static const unsigned RING_STRESS_BAUDS[] = { 9600, 115200 };
+static const unsigned DRIFT_KM = 125000;
+static const unsigned DRIFT_BLOCK = 4096;
+static const unsigned ARCHIVE_RECORDS[] = { 10000, 2000000 };
+static const uint64_t MAX_ITERATIONS = 1ULL << 32;
+
+static uint64_t
+nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * Synthetic NMEA
+ */
+
+static size_t
+appendSentence(uint8_t *out, const char *body)
+{
+    uint8_t checksum = 0;
+    for (const char *c = body; *c != '\0'; c++) {
+        checksum ^= (uint8_t)*c;
+    }
+    return (size_t)sprintf((char *)out, "$%s*%02X\r\n", body, checksum);
+}
+
+static void
+formatCoordinate(char *out, double degrees, unsigned degreeDigits)
+{
+    double absolute = fabs(degrees);
+    unsigned whole = (unsigned)absolute;
+    double minutes = (absolute - whole) * 60.0;
+    sprintf(out, "%0*u%07.4f", (int)degreeDigits, whole, minutes);
+}
+
+/*
+ * Callback sinks
+ */
+
+static uint64_t callbacks;
+
+static void
+countLocation(const GPSProvider::LocationUpdateParams_t *params)
+{
+    (void)params;
+    callbacks++;
+}
+
+static void
+countQuery(const GPSProvider::LogQueryRespParams_t *params)
+{
+    (void)params;
+    callbacks++;
+}
+
+/*
+ * Benchmarks: each runs iterations operations (or passes) and returns the
+ * number of operations performed, 0 if it could not run.
+ */
+
+static uint64_t
+benchFacadeProcess(GPSBenchmark &bench, unsigned param, uint64_t iterations)
+{
+    (void)param;
+    bench.pauseTiming();
+    const char *path = bench.getCapturePath();
+    if (path == NULL) {
+        return 0;
+    }
+    /* never started: process() returns at once, only the dispatch is left */
+    GPSReplayProvider replay(path);
+    GPSProvider gps(&replay);
+    bench.resumeTiming();
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        gps.process();
+    }
+    return iterations;
+}
+
+static uint64_t
+benchFacadeLocation(GPSBenchmark &bench, unsigned param, uint64_t iterations)
+{
+    (void)param;
+    bench.pauseTiming();
+    const char *path = bench.getCapturePath();
+    if (path == NULL) {
+        return 0;
+    }
+    GPSReplayProvider replay(path);
+    GPSProvider gps(&replay);
+    gps.start();
+    while (!replay.isReplayDone()) {
+        gps.process();
+    }
+    gps.onLocationUpdate(countLocation);
+    callbacks = 0;
+    bench.resumeTiming();
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        gps.lpmGetImmediateLocation();
+    }
+    bench.pauseTiming();
+    gps.stop();
+    return callbacks;
+}
+
+static uint64_t
+benchNmeaParse(GPSBenchmark &bench, unsigned param, uint64_t iterations)
+{
+    (void)param;
+    size_t len;
+    const uint8_t *capture = bench.getCapture(len);
+    GPSNmeaParser parser;
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        size_t offset = 0;
+        while (offset < len) {
+            offset += parser.parse(&capture[offset], len - offset);
+            if (parser.takeLocationUpdate()) {
+                bench.consume(parser.getLocation().utcTime);
+            }
+        }
+    }
+    return parser.getStats().sentences;
+}
+
+/*
+ * The usual hand-rolled parser the streaming one replaces: each line is
+ * copied out of the stream, checked, copied again and split by strtok().
+ */
+static double
+naiveCoordinate(const char *text, const char *hemisphere)
+{
+    double value = atof(text);
+    double degrees = floor(value / 100.0);
+    double result = degrees + (value - degrees * 100.0) / 60.0;
+    return ((hemisphere[0] == 'S') || (hemisphere[0] == 'W')) ? -result : result;
+}
+
+static bool
+naiveSentence(char *line, GPSProvider::LocationUpdateParams_t &location)
+{
+    char *star = strchr(line, '*');
+    if ((line[0] != '$') || (star == NULL)) {
+        return false;
+    }
+    uint8_t checksum = 0;
+    for (char *c = line + 1; c < star; c++) {
+        checksum ^= (uint8_t)*c;
+    }
+    if (strtoul(star + 1, NULL, 16) != checksum) {
+        return false;
+    }
+    *star = '\0';
+
+    char copy[96];
+    snprintf(copy, sizeof(copy), "%s", line + 1);
+    char *fields[24];
+    unsigned count = 0;
+    for (char *field = strtok(copy, ","); (field != NULL) && (count < 24); field = strtok(NULL, ",")) {
+        fields[count++] = field;
+    }
+    if ((count >= 10) && (strcmp(fields[0] + 2, "GGA") == 0)) {
+        double tod = atof(fields[1]);
+        location.utcTime = (uint64_t)(floor(tod / 10000.0) * 3600000.0 + fmod(floor(tod / 100.0), 100.0) * 60000.0 +
+                                      fmod(tod, 100.0) * 1000.0);
+        location.lat = naiveCoordinate(fields[2], fields[3]);
+        location.lon = naiveCoordinate(fields[4], fields[5]);
+        location.valid = (atoi(fields[6]) > 0);
+        location.numGPSSVs = (unsigned)atoi(fields[7]);
+        location.altitude = (float)atof(fields[9]);
+        return true;
+    }
+    return false;
+}
+
+static uint64_t
+benchNmeaParseNaive(GPSBenchmark &bench, unsigned param, uint64_t iterations)
+{
+    (void)param;
+    size_t len;
+    const uint8_t *capture = bench.getCapture(len);
+    GPSProvider::LocationUpdateParams_t location;
+    memset(&location, 0, sizeof(location));
+    char line[96];
+    uint64_t sentences = 0;
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        size_t lineLen = 0;
+        for (size_t k = 0; k < len; k++) {
+            char c = (char)capture[k];
+            if (c == '\n') {
+                line[lineLen] = '\0';
+                if (naiveSentence(line, location)) {
+                    bench.consume(location.utcTime);
+                }
+                sentences++;
+                lineLen = 0;
+            } else if ((c != '\r') && (lineLen + 1 < sizeof(line))) {
+                line[lineLen++] = c;
+            }
+        }
+    }
+    return sentences;
+}
+
+/*
+ * Circles of 50 to 561 m scattered over the bounding box of the track,
+ * widened by margin degrees.
+ */
+static void
+scatterFences(const GPSProvider::LocationUpdateParams_t *fixes, unsigned fixCount, double margin,
+              GPSGeofence *geofences, GPSGeofence **list, unsigned fenceCount)
+{
+    double minLat = fixes[0].lat, maxLat = fixes[0].lat;
+    double minLon = fixes[0].lon, maxLon = fixes[0].lon;
+    for (unsigned i = 1; i < fixCount; i++) {
+        minLat = (fixes[i].lat < minLat) ? fixes[i].lat : minLat;
+        maxLat = (fixes[i].lat > maxLat) ? fixes[i].lat : maxLat;
+        minLon = (fixes[i].lon < minLon) ? fixes[i].lon : minLon;
+        maxLon = (fixes[i].lon > maxLon) ? fixes[i].lon : maxLon;
+    }
+    minLat -= margin;
+    maxLat += margin;
+    minLon -= margin;
+    maxLon += margin;
+
+    uint32_t seed = 12345;
+    for (unsigned i = 0; i < fenceCount; i++) {
+        GPSGeofence::GeofenceCircle_t circle;
+        seed = seed * 1664525U + 1013904223U;
+        circle.lat = minLat + (maxLat - minLat) * (seed >> 8) / 16777216.0;
+        seed = seed * 1664525U + 1013904223U;
+        circle.lon = minLon + (maxLon - minLon) * (seed >> 8) / 16777216.0;
+        circle.radius = 50 + (seed & 0x1FF);
+        circle.id = (int)i;
+        circle.enabled = true;
+        circle.tolerance = 10;
+        circle.status = 0;
+        geofences[i].setGeofenceCircle(circle);
+        list[i] = &geofences[i];
+    }
+}
+
+static void
+countGeofenceStatus(const GPSProvider::GeofenceStatusParams_t *params, int ret_code)
+{
+    (void)params;
+    (void)ret_code;
+    callbacks++;
+}
+
+static uint64_t
+benchGeofence(GPSBenchmark &bench, unsigned fenceCount, uint64_t iterations)
+{
+    bench.pauseTiming();
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    GPSGeofence *geofences = new GPSGeofence[fenceCount];
+    GPSGeofence **list = new GPSGeofence *[fenceCount];
+    scatterFences(fixes, fixCount, 0.01, geofences, list, fenceCount);
+
+    GPSGeofenceEngine engine;
+    engine.onGeofenceStatusMessage(countGeofenceStatus);
+    callbacks = 0;
+    uint64_t ops = 0;
+    if (engine.configGeofences(list, fenceCount) == GPS_ERROR_NONE) {
+        bench.resumeTiming();
+        for (uint64_t i = 0; i < iterations; i++) {
+            bench.consume(engine.evaluate(fixes[i % fixCount]));
+        }
+        bench.pauseTiming();
+        ops = iterations;
+        bench.reportRate("fences_per_sec", (double)engine.getEvaluatedFences() / (double)iterations);
+        bench.report("callbacks_per_fix", (double)callbacks / (double)iterations);
+    }
+    delete[] list;
+    delete[] geofences;
+    return ops;
+}
+
+/*
+ * GPSGeofenceWakeup against a fixed 1 s poll: the engine is only run at
+ * the checks the planner asks for. A second engine, outside the timed
+ * part, evaluates every fix so the transitions can be compared.
+ */
+static uint64_t
+benchGeofenceWakeup(GPSBenchmark &bench, unsigned fenceCount, uint64_t iterations)
+{
+    bench.pauseTiming();
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    GPSGeofence *geofences = new GPSGeofence[fenceCount];
+    GPSGeofence **list = new GPSGeofence *[fenceCount];
+    scatterFences(fixes, fixCount, 0.002, geofences, list, fenceCount);
+
+    uint64_t checks = 0;
+    uint64_t polls = 0;
+    uint64_t planned = 0;
+    uint64_t reference = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        GPSGeofenceEngine engine;
+        GPSGeofenceEngine everyFix;
+        if ((engine.configGeofences(list, fenceCount) != GPS_ERROR_NONE) ||
+            (everyFix.configGeofences(list, fenceCount) != GPS_ERROR_NONE)) {
+            checks = 0;
+            break;
+        }
+        GPSGeofenceWakeup wakeup(engine);
+        for (unsigned f = 0; f < fixCount; f++) {
+            reference += everyFix.evaluate(fixes[f]);
+        }
+
+        bench.resumeTiming();
+        for (unsigned f = 0; f < fixCount; f++) {
+            if (wakeup.isCheckDue(fixes[f].utcTime)) {
+                planned += engine.evaluate(fixes[f]);
+                wakeup.update(fixes[f]);
+            }
+        }
+        bench.pauseTiming();
+
+        GPSGeofenceWakeup::WakeupStats_t stats;
+        wakeup.getStats(stats);
+        checks += stats.checks;
+        polls += wakeup.getFixedPollingChecks(1000);
+    }
+    delete[] list;
+    delete[] geofences;
+    if ((checks == 0) || (polls == 0)) {
+        return 0;
+    }
+    bench.report("checks_per_poll", (double)checks / (double)polls);
+    bench.report("wakeups_avoided", (double)(polls - checks) / (double)iterations);
+    bench.report("transitions", (double)planned / (double)iterations);
+    bench.report("transitions_every_fix", (double)reference / (double)iterations);
+    return iterations * fixCount;
+}
+
+/*
+ * GPSGeofenceIndex query cost as the fence count grows. The fences are
+ * spread at a constant density of about one per square kilometre around
+ * the track, so the area (not the crowding) grows with the count.
+ */
+static uint64_t
+benchGeofenceIndex(GPSBenchmark &bench, unsigned fenceCount, uint64_t iterations)
+{
+    bench.pauseTiming();
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    double halfSide = sqrt((double)fenceCount) * 0.5 / 111.0;
+    double cosLat = cos(fixes[0].lat * M_PI / 180.0);
+
+    GPSGeofenceIndex index(1000.0);
+    uint32_t seed = 12345;
+    for (unsigned i = 0; i < fenceCount; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        double lat = fixes[0].lat + halfSide * ((seed >> 8) / 8388608.0 - 1.0);
+        seed = seed * 1664525U + 1013904223U;
+        double lon = fixes[0].lon + halfSide / cosLat * ((seed >> 8) / 8388608.0 - 1.0);
+        if (index.insert(i, lat, lon, 50 + (seed & 0x1FF)) != GPS_ERROR_NONE) {
+            return 0;
+        }
+    }
+    bench.resumeTiming();
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        unsigned count;
+        const GPSProvider::LocationUpdateParams_t &fix = fixes[i % fixCount];
+        const uint32_t *candidates = index.query(fix.lat, fix.lon, count);
+        bench.consume((count > 0) ? candidates[0] : count);
+    }
+    bench.pauseTiming();
+
+    GPSGeofenceIndex::IndexStats_t stats;
+    index.getStats(stats);
+    bench.report("candidates_per_query", (double)stats.candidates / (double)stats.queries);
+    bench.report("cells", stats.cells);
+    bench.report("oversize", stats.oversize);
+    return iterations;
+}
+
+/*
+ * Both representations of the per-fence test and of the odometer step,
+ * whatever GPS_LOCATION_FIXED_POINT selected for the components.
+ */
+static uint64_t
+benchFenceTest(GPSBenchmark &bench, unsigned fixedPoint, uint64_t iterations)
+{
+    bench.pauseTiming();
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    GPSGeofence *geofences = new GPSGeofence[KERNEL_FENCES];
+    GPSGeofence **list = new GPSGeofence *[KERNEL_FENCES];
+    scatterFences(fixes, fixCount, 0.01, geofences, list, KERNEL_FENCES);
+
+    static double latRad[KERNEL_FENCES], lonRad[KERNEL_FENCES], cosLat[KERNEL_FENCES];
+    static double inner2[KERNEL_FENCES], outer2[KERNEL_FENCES];
+    static int32_t latUnits[KERNEL_FENCES], lonUnits[KERNEL_FENCES], cosQ30[KERNEL_FENCES];
+    static int64_t inner2Units[KERNEL_FENCES], outer2Units[KERNEL_FENCES];
+    for (unsigned i = 0; i < KERNEL_FENCES; i++) {
+        const GPSGeofence::GeofenceCircle_t &circle = geofences[i].getGeofenceCircle();
+        double inner = (circle.radius - circle.tolerance) / GPSFixedPoint::metersPerUnit();
+        double outer = (circle.radius + circle.tolerance) / GPSFixedPoint::metersPerUnit();
+        latRad[i] = circle.lat * GPS_DEG_TO_RAD;
+        lonRad[i] = circle.lon * GPS_DEG_TO_RAD;
+        cosLat[i] = cos(latRad[i]);
+        inner2[i] = (circle.radius - circle.tolerance) * (circle.radius - circle.tolerance);
+        outer2[i] = (circle.radius + circle.tolerance) * (circle.radius + circle.tolerance);
+        latUnits[i] = GPSFixedPoint::toUnits(circle.lat);
+        lonUnits[i] = GPSFixedPoint::toUnits(circle.lon);
+        cosQ30[i] = GPSFixedPoint::cosQ30(latUnits[i]);
+        inner2Units[i] = (int64_t)(inner * inner);
+        outer2Units[i] = (int64_t)(outer * outer);
+    }
+    delete[] list;
+    delete[] geofences;
+    bench.resumeTiming();
+
+    unsigned inside = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        const GPSProvider::LocationUpdateParams_t &fix = fixes[i % fixCount];
+        if (fixedPoint) {
+            int32_t lat = GPSFixedPoint::toUnits(fix.lat);
+            int32_t lon = GPSFixedPoint::toUnits(fix.lon);
+            for (unsigned k = 0; k < KERNEL_FENCES; k++) {
+                int64_t d2 = GPSFixedPoint::distance2(lat, lon, latUnits[k], lonUnits[k], cosQ30[k]);
+                inside += (d2 <= inner2Units[k]) ? 2 : ((d2 <= outer2Units[k]) ? 1 : 0);
+            }
+        } else {
+            double lat = fix.lat * GPS_DEG_TO_RAD;
+            double lon = fix.lon * GPS_DEG_TO_RAD;
+            for (unsigned k = 0; k < KERNEL_FENCES; k++) {
+                double d2 = GPSFixedPoint::distance2Rad(lat, lon, latRad[k], lonRad[k], cosLat[k]);
+                inside += (d2 <= inner2[k]) ? 2 : ((d2 <= outer2[k]) ? 1 : 0);
+            }
+        }
+    }
+    bench.consume(inside);
+    return iterations * KERNEL_FENCES;
+}
+
+static uint64_t
+benchOdometerStep(GPSBenchmark &bench, unsigned fixedPoint, uint64_t iterations)
+{
+    bench.pauseTiming();
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    GPSLocalFrame::Point_t *points = (GPSLocalFrame::Point_t *)malloc(fixCount * sizeof(GPSLocalFrame::Point_t));
+    int32_t *units = (int32_t *)malloc(fixCount * 3 * sizeof(int32_t));
+    if ((points == NULL) || (units == NULL)) {
+        free(points);
+        free(units);
+        return 0;
+    }
+    GPSLocalFrame frame;
+    for (unsigned i = 0; i < fixCount; i++) {
+        points[i] = frame.update(fixes[i]);
+        units[3 * i] = GPSFixedPoint::toUnits(fixes[i].lat);
+        units[3 * i + 1] = GPSFixedPoint::toUnits(fixes[i].lon);
+        units[3 * i + 2] = (int32_t)(points[i].cosLat * (double)(1L << 30));
+    }
+    bench.resumeTiming();
+
+    if (fixedPoint) {
+        uint64_t totalMm = 0;
+        for (uint64_t i = 0; i < iterations; i++) {
+            unsigned a = (unsigned)(i % (fixCount - 1));
+            const int32_t *p = &units[3 * a];
+            totalMm += GPSFixedPoint::distanceMm(p[0], p[1], p[3], p[4],
+                                                 (int32_t)(((int64_t)p[2] + p[5]) / 2));
+        }
+        bench.consume(totalMm);
+    } else {
+        double total = 0.0;
+        for (uint64_t i = 0; i < iterations; i++) {
+            unsigned a = (unsigned)(i % (fixCount - 1));
+            total += GPSLocalFrame::distance(points[a], points[a + 1]);
+        }
+        bench.consume((uint64_t)total);
+    }
+    bench.pauseTiming();
+    free(points);
+    free(units);
+    return iterations;
+}
+
+static uint64_t
+benchDatalogLog(GPSBenchmark &bench, unsigned param, uint64_t iterations)
+{
+    (void)param;
+    bench.pauseTiming();
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    const char *path = bench.getScratchPath("datalog.bin");
+    GPSDatalogEngine engine;
+    GPSDatalog datalog(false, true, 0, 0, 0, 1);
+    if ((engine.open(path, DATALOG_CAPACITY) != GPS_ERROR_NONE) ||
+        (engine.configDatalog(&datalog) != GPS_ERROR_NONE) ||
+        (engine.startDatalog() != GPS_ERROR_NONE)) {
+        unlink(path);
+        return 0;
+    }
+    uint64_t period = fixes[fixCount - 1].utcTime - fixes[0].utcTime + 1000;
+    bench.resumeTiming();
+
+    uint64_t logged = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        /* keep the time increasing across passes over the track */
+        GPSProvider::LocationUpdateParams_t location = fixes[i % fixCount];
+        location.utcTime += (i / fixCount) * period;
+        logged += engine.logFix(location, 10.0) ? 1 : 0;
+    }
+    bench.pauseTiming();
+    engine.stopDatalog();
+    GPSDatalogEngine::DatalogStats_t stats;
+    engine.getStats(stats);
+    engine.close();
+    unlink(path);
+    if (stats.logged > 0) {
+        bench.report("write_amplification",
+                     (double)stats.bytesWritten / ((double)stats.logged * GPSDatalogEngine::RECORD_SIZE));
+        bench.report("records_per_write", (double)stats.logged / (double)stats.dataWrites);
+    }
+    return logged;
+}
+
+static uint64_t
+benchDatalogQuery(GPSBenchmark &bench, unsigned param, uint64_t iterations)
+{
+    (void)param;
+    bench.pauseTiming();
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    const char *path = bench.getScratchPath("query.bin");
+    GPSDatalogEngine engine;
+    GPSDatalog datalog(false, true, 0, 0, 0, 1);
+    if ((engine.open(path, DATALOG_CAPACITY) != GPS_ERROR_NONE) ||
+        (engine.configDatalog(&datalog) != GPS_ERROR_NONE) ||
+        (engine.startDatalog() != GPS_ERROR_NONE)) {
+        unlink(path);
+        return 0;
+    }
+    uint64_t period = fixes[fixCount - 1].utcTime - fixes[0].utcTime + 1000;
+    for (unsigned i = 0; i < QUERY_RECORDS; i++) {
+        GPSProvider::LocationUpdateParams_t location = fixes[i % fixCount];
+        location.utcTime += (i / fixCount) * period;
+        engine.logFix(location, 10.0);
+    }
+    engine.stopDatalog();
+    engine.onLogQuery(countQuery);
+
+    /* the queries start at successive records of the store */
+    GPSProvider::LogQueryParams_t query;
+    query.entries = QUERY_ENTRIES;
+    callbacks = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        unsigned start = (unsigned)((i * 97) % (QUERY_RECORDS - QUERY_ENTRIES));
+        GPSProviderUtils::utcMsToTimestamp(fixes[start % fixCount].utcTime + (start / fixCount) * period,
+                                           query.startTimestamp);
+        bench.resumeTiming();
+        engine.logReqQuery(query);
+        bench.pauseTiming();
+    }
+    engine.close();
+    unlink(path);
+    return callbacks;
+}
+
+/*
+ * GPSDatalogMirror against pass-through: the replay backend, whose store
+ * has logged the capture, stands in for the receiver; the mirror is synced
+ * once, then the same queries go to the mirror or straight to the backend.
+ * A real link adds a round trip to each pass-through query.
+ */
+static const unsigned MIRROR_ENTRIES = 10;
+
+static GPSDatalogMirror *mirror;
+
+static void
+forwardMirrorStatus(const GPSProvider::LogStatusParams_t *params)
+{
+    mirror->handleStatus(params);
+}
+
+static void
+forwardMirrorQuery(const GPSProvider::LogQueryRespParams_t *params)
+{
+    if (mirror != NULL) {
+        mirror->handleQueryResp(params);
+    } else {
+        callbacks++;
+    }
+}
+
+static uint64_t
+benchDatalogMirror(GPSBenchmark &bench, unsigned passThrough, uint64_t iterations)
+{
+    bench.pauseTiming();
+    const char *capture = bench.getCapturePath();
+    if (capture == NULL) {
+        return 0;
+    }
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    const char *path = bench.getScratchPath("mirror.bin");
+
+    GPSReplayProvider replay(capture);
+    replay.setDatalogStore(path, DATALOG_CAPACITY);
+    GPSProvider gps(&replay);
+    GPSDatalog datalog(false, true, 0, 0, 0, 1);
+    GPSDatalogMirror store(gps, DATALOG_CAPACITY);
+    if ((gps.enableDatalog() != GPS_ERROR_NONE) ||
+        (gps.configDatalog(&datalog) != GPS_ERROR_NONE) ||
+        (gps.startDatalog() != GPS_ERROR_NONE)) {
+        unlink(path);
+        return 0;
+    }
+    gps.start();
+    while (!replay.isReplayDone()) {
+        gps.process();
+    }
+    gps.stop();
+    gps.stopDatalog();
+
+    mirror = &store;
+    gps.onLogStatus(forwardMirrorStatus);
+    gps.onLogQuery(forwardMirrorQuery);
+    store.onLogQuery(countQuery);
+    store.sync();
+    for (unsigned i = 0; (i < 100) && !store.isSynced(); i++) {
+        gps.process();
+        store.process();
+    }
+    bool synced = store.isSynced();
+    if (passThrough) {
+        mirror = NULL;
+    }
+
+    GPSProvider::LogQueryParams_t query;
+    query.entries = MIRROR_ENTRIES;
+    callbacks = 0;
+    for (uint64_t i = 0; synced && (i < iterations); i++) {
+        GPSProviderUtils::utcMsToTimestamp(fixes[(i * 97) % fixCount].utcTime, query.startTimestamp);
+        bench.resumeTiming();
+        if (passThrough) {
+            gps.logReqQuery(query);
+        } else {
+            store.logReqQuery(query);
+        }
+        bench.pauseTiming();
+    }
+
+    GPSDatalogMirror::MirrorStats_t stats;
+    store.getStats(stats);
+    mirror = NULL;
+    unlink(path);
+    if (!synced) {
+        return 0;
+    }
+    bench.report("entries_per_query", (double)callbacks / (double)iterations);
+    bench.report("mirrored", stats.entries);
+    if (!passThrough) {
+        bench.report("forwarded", stats.forwardedQueries);
+    }
+    return iterations;
+}
+
+/*
+ * Whole-store download from the replay backend: GPSDatalogDownloader in
+ * DOWNLOAD_BATCH entry bulk batches, or a single logReqQuery() delivering
+ * one callback per entry.
+ */
+static const unsigned DOWNLOAD_BATCH = 256;
+
+static unsigned
+countBatch(const GPSProvider::LogQueryRespParams_t *entries, unsigned count)
+{
+    (void)entries;
+    callbacks += count;
+    return count;
+}
+
+static uint64_t
+benchDatalogDownload(GPSBenchmark &bench, unsigned perEntry, uint64_t iterations)
+{
+    bench.pauseTiming();
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    const char *capture = bench.getCapturePath();
+    if (capture == NULL) {
+        return 0;
+    }
+    const char *path = bench.getScratchPath("download.bin");
+    GPSReplayProvider replay(capture);
+    replay.setDatalogStore(path, DATALOG_CAPACITY);
+    GPSProvider gps(&replay);
+    GPSDatalog datalog(false, true, 0, 0, 0, 1);
+    if ((gps.enableDatalog() != GPS_ERROR_NONE) ||
+        (gps.configDatalog(&datalog) != GPS_ERROR_NONE) ||
+        (gps.startDatalog() != GPS_ERROR_NONE)) {
+        unlink(path);
+        return 0;
+    }
+    uint64_t period = fixes[fixCount - 1].utcTime - fixes[0].utcTime + 1000;
+    for (unsigned i = 0; i < DATALOG_CAPACITY; i++) {
+        GPSProvider::LocationUpdateParams_t location = fixes[i % fixCount];
+        location.utcTime += (i / fixCount) * period;
+        replay.getDatalog().logFix(location, 10.0);
+    }
+    gps.stopDatalog();
+    gps.onLogQuery(countQuery);
+
+    static GPSProvider::LogQueryRespParams_t batch[DOWNLOAD_BATCH];
+    GPSDatalogDownloader::ResumePoint_t from;
+    GPSProviderUtils::utcMsToTimestamp(fixes[0].utcTime, from.timestamp);
+    from.skip = 0;
+    GPSProvider::LogQueryParams_t query;
+    query.startTimestamp = from.timestamp;
+    query.entries = DATALOG_CAPACITY;
+
+    uint64_t parts = 0;
+    callbacks = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        if (perEntry) {
+            bench.resumeTiming();
+            gps.logReqQuery(query);
+            bench.pauseTiming();
+            parts++;
+            continue;
+        }
+        GPSDatalogDownloader download(gps);
+        bench.resumeTiming();
+        if (download.start(from, batch, DOWNLOAD_BATCH, countBatch) != GPS_ERROR_NONE) {
+            break;
+        }
+        while (!download.isDone() && download.isActive()) {
+            download.process();
+        }
+        bench.pauseTiming();
+        GPSDatalogDownloader::DownloadStats_t stats;
+        download.getStats(stats);
+        parts += stats.requests;
+    }
+    unlink(path);
+    if (callbacks == 0) {
+        return 0;
+    }
+    bench.reportRate("records_per_sec", 1.0);
+    bench.report("requests", (double)parts / (double)iterations);
+    return callbacks;
+}
+
+/*
+ * GPSDatalogArchive on an ARCHIVE_RECORDS[] record export of the track:
+ * open() and close() alone, which only map the file and read its header,
+ * and a full pass (open, read every record, close) timed against the same
+ * fields summed from read() into a buffer. The file is written once per
+ * run of the function and is in the page cache when measured.
+ */
+static const unsigned ARCHIVE_READ_BUFFER = 64 * 1024;
+
+static const char *
+writeArchive(GPSBenchmark &bench, unsigned records)
+{
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    const char *path = bench.getScratchPath("archive.gpa");
+    GPSDatalogArchiveWriter writer;
+    if (writer.create(path) != GPS_ERROR_NONE) {
+        return NULL;
+    }
+    GPSDatalogArchive::Record_t record;
+    memset(&record, 0, sizeof(record));
+    for (unsigned i = 0; i < records; i++) {
+        const GPSProvider::LocationUpdateParams_t &fix = fixes[i % fixCount];
+        record.utcTime = fixes[0].utcTime + (uint64_t)i * 1000;
+        record.lat = (int32_t)(fix.lat * 1e7);
+        record.lon = (int32_t)(fix.lon * 1e7);
+        record.altitude = (int32_t)(fix.altitude * 100.0);
+        record.odo = i * 10;
+        record.fix = 3;
+        record.quality = (uint8_t)fix.numGPSSVs;
+        if (writer.add(record) != GPS_ERROR_NONE) {
+            writer.finish();
+            unlink(path);
+            return NULL;
+        }
+    }
+    if (writer.finish() != GPS_ERROR_NONE) {
+        unlink(path);
+        return NULL;
+    }
+    return path;
+}
+
+static uint64_t
+sumRecord(const GPSDatalogArchive::Record_t &record)
+{
+    return record.utcTime + (uint32_t)record.lat + (uint32_t)record.lon + record.odo;
+}
+
+static uint64_t
+benchArchiveOpen(GPSBenchmark &bench, unsigned records, uint64_t iterations)
+{
+    bench.pauseTiming();
+    const char *path = writeArchive(bench, records);
+    if (path == NULL) {
+        return 0;
+    }
+    GPSDatalogArchive archive;
+    uint64_t opened = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        bench.resumeTiming();
+        if (archive.open(path) == GPS_ERROR_NONE) {
+            opened += archive.getCount();
+        }
+        archive.close();
+        bench.pauseTiming();
+    }
+    unlink(path);
+    if (opened != iterations * records) {
+        return 0;
+    }
+    bench.report("file_mb", (double)(GPSDatalogArchive::HEADER_SIZE +
+                                     (uint64_t)records * sizeof(GPSDatalogArchive::Record_t)) / 1e6);
+    return iterations;
+}
+
+static uint64_t
+benchArchiveScan(GPSBenchmark &bench, unsigned records, uint64_t iterations)
+{
+    bench.pauseTiming();
+    const char *path = writeArchive(bench, records);
+    if (path == NULL) {
+        return 0;
+    }
+    uint8_t *buffer = (uint8_t *)malloc(ARCHIVE_READ_BUFFER);
+    if (buffer == NULL) {
+        unlink(path);
+        return 0;
+    }
+
+    /* whole passes until at least iterations records have been read */
+    GPSDatalogArchive archive;
+    uint64_t scanned = 0;
+    uint64_t mapSum = 0;
+    uint64_t mapNs = 0;
+    while (scanned < iterations) {
+        uint64_t start = nowNs();
+        bench.resumeTiming();
+        if (archive.open(path) != GPS_ERROR_NONE) {
+            bench.pauseTiming();
+            break;
+        }
+        const GPSDatalogArchive::Record_t *record = archive.getRecords();
+        uint64_t count = archive.getCount();
+        for (uint64_t i = 0; i < count; i++) {
+            mapSum += sumRecord(record[i]);
+        }
+        archive.close();
+        bench.pauseTiming();
+        mapNs += nowNs() - start;
+        scanned += count;
+    }
+
+    /* the same passes with read() through a buffer, header skipped */
+    uint64_t readSum = 0;
+    uint64_t readNs = 0;
+    for (uint64_t passes = (records > 0) ? scanned / records : 0; passes > 0; passes--) {
+        uint64_t start = nowNs();
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            break;
+        }
+        uint64_t offset = 0;
+        ssize_t got;
+        while ((got = read(fd, buffer, ARCHIVE_READ_BUFFER)) > 0) {
+            const GPSDatalogArchive::Record_t *record = (const GPSDatalogArchive::Record_t *)buffer;
+            unsigned first = (offset == 0) ? GPSDatalogArchive::HEADER_SIZE / sizeof(*record) : 0;
+            unsigned count = (unsigned)got / sizeof(*record);
+            offset += (uint64_t)got;
+            if (offset > GPSDatalogArchive::HEADER_SIZE + (uint64_t)records * sizeof(*record)) {
+                /* the time index follows the records */
+                uint64_t over = offset - GPSDatalogArchive::HEADER_SIZE - (uint64_t)records * sizeof(*record);
+                count -= (over >= (uint64_t)got) ? count : (unsigned)(over / sizeof(*record));
+            }
+            for (unsigned i = first; i < count; i++) {
+                readSum += sumRecord(record[i]);
+            }
+        }
+        close(fd);
+        readNs += nowNs() - start;
+    }
+    free(buffer);
+    unlink(path);
+
+    if ((scanned == 0) || (readSum != mapSum)) {
+        return 0;
+    }
+    bench.consume(mapSum);
+    bench.reportRate("mb_per_sec", (double)sizeof(GPSDatalogArchive::Record_t) / 1e6);
+    bench.report("read_ns_per_record", (double)readNs / (double)scanned);
+    bench.report("vs_read", (double)readNs / (double)mapNs);
+    return scanned;
+}
+
+/*
+ * GPSLogBlock on the entries of a logged track: encode and decode in
+ * BLOCK_ENTRIES entry blocks, with the compression against the datalog
+ * record and LogQueryRespParams_t.
+ */
+static const unsigned BLOCK_ENTRIES = 256;
+
+static GPSProvider::LogQueryRespParams_t *collected;
+static unsigned collectedCount;
+
+static void
+collectEntry(const GPSProvider::LogQueryRespParams_t *params)
+{
+    if ((params != NULL) && (collectedCount < QUERY_RECORDS)) {
+        collected[collectedCount++] = *params;
+    }
+}
+
+static uint64_t
+benchLogBlock(GPSBenchmark &bench, unsigned decode, uint64_t iterations)
+{
+    bench.pauseTiming();
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    const char *path = bench.getScratchPath("block.bin");
+    GPSDatalogEngine engine;
+    GPSDatalog datalog(false, true, 0, 0, 0, 1);
+    if ((engine.open(path, DATALOG_CAPACITY) != GPS_ERROR_NONE) ||
+        (engine.configDatalog(&datalog) != GPS_ERROR_NONE) ||
+        (engine.startDatalog() != GPS_ERROR_NONE)) {
+        unlink(path);
+        return 0;
+    }
+    uint64_t period = fixes[fixCount - 1].utcTime - fixes[0].utcTime + 1000;
+    for (unsigned i = 0; i < QUERY_RECORDS; i++) {
+        GPSProvider::LocationUpdateParams_t location = fixes[i % fixCount];
+        location.utcTime += (i / fixCount) * period;
+        engine.logFix(location, 10.0);
+    }
+    engine.stopDatalog();
+
+    static GPSProvider::LogQueryRespParams_t entries[QUERY_RECORDS];
+    collected = entries;
+    collectedCount = 0;
+    engine.onLogQuery(collectEntry);
+    GPSProvider::LogQueryParams_t query;
+    GPSProviderUtils::utcMsToTimestamp(fixes[0].utcTime, query.startTimestamp);
+    query.entries = QUERY_RECORDS;
+    engine.logReqQuery(query);
+    engine.close();
+    unlink(path);
+    const unsigned count = collectedCount - collectedCount % BLOCK_ENTRIES;
+    if (count == 0) {
+        return 0;
+    }
+
+    /* the whole set, encoded once for the decode case and the ratios */
+    const size_t blockMax = GPSLogBlockEncoder::getMaxBlockSize(BLOCK_ENTRIES);
+    uint8_t *blocks = (uint8_t *)malloc(blockMax * (count / BLOCK_ENTRIES));
+    if (blocks == NULL) {
+        return 0;
+    }
+    GPSLogBlockEncoder encoder(BLOCK_ENTRIES);
+    size_t size = 0;
+    for (unsigned i = 0; i < count; i++) {
+        encoder.add(entries[i]);
+        if (encoder.isFull()) {
+            size += encoder.finish(&blocks[size], blockMax);
+        }
+    }
+
+    static GPSProvider::LogQueryRespParams_t decoded[BLOCK_ENTRIES];
+    uint64_t ops = 0;
+    bench.resumeTiming();
+    for (uint64_t i = 0; i < iterations; i++) {
+        if (decode) {
+            size_t offset = 0;
+            while (offset < size) {
+                GPSLogBlockDecoder::BlockHeader_t header;
+                if (!GPSLogBlockDecoder::readHeader(&blocks[offset], size - offset, header)) {
+                    break;
+                }
+                ops += GPSLogBlockDecoder::decode(&blocks[offset], header.size, decoded, BLOCK_ENTRIES);
+                offset += header.size;
+            }
+            bench.consume(decoded[0].timestamp.ss);
+        } else {
+            for (unsigned e = 0; e < count; e++) {
+                encoder.add(entries[e]);
+                if (encoder.isFull()) {
+                    bench.consume(encoder.finish(blocks, blockMax));
+                }
+            }
+            ops += count;
+        }
+    }
+    bench.pauseTiming();
+    free(blocks);
+
+    double bytesPerEntry = (double)size / (double)count;
+    bench.report("bytes_per_entry", bytesPerEntry);
+    bench.report("ratio_vs_record", GPSDatalogEngine::RECORD_SIZE / bytesPerEntry);
+    bench.report("ratio_vs_struct", sizeof(GPSProvider::LogQueryRespParams_t) / bytesPerEntry);
+    return ops;
+}
+
+/*
+ * Distance math of the three per-fix consumers (odometer, datalog filter,
+ * wakeup planner): each calling GPSProviderUtils::localDistance(), one
+ * cos() apiece, or sharing one GPSLocalFrame conversion of the fix.
+ */
+static const unsigned FRAME_CONSUMERS = 3;
+
+static uint64_t
+benchLocalFrame(GPSBenchmark &bench, unsigned shared, uint64_t iterations)
+{
+    bench.pauseTiming();
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    GPSLocalFrame frame;
+    GPSLocalFrame::Point_t previous = frame.update(fixes[0]);
+    double sum = 0.0;
+    uint64_t trigCalls = 0;
+    bench.resumeTiming();
+
+    for (uint64_t i = 1; i <= iterations; i++) {
+        const GPSProvider::LocationUpdateParams_t &a = fixes[(i - 1) % fixCount];
+        const GPSProvider::LocationUpdateParams_t &b = fixes[i % fixCount];
+        if (shared) {
+            const GPSLocalFrame::Point_t &point = frame.update(b);
+            for (unsigned c = 0; c < FRAME_CONSUMERS; c++) {
+                sum += GPSLocalFrame::distance(previous, point);
+            }
+            previous = point;
+        } else {
+            for (unsigned c = 0; c < FRAME_CONSUMERS; c++) {
+                sum += GPSProviderUtils::localDistance(a.lat, a.lon, b.lat, b.lon);
+            }
+            trigCalls += FRAME_CONSUMERS;
+        }
+    }
+    bench.pauseTiming();
+    bench.consume((uint64_t)sum);
+
+    if (shared) {
+        GPSLocalFrame::FrameStats_t stats;
+        frame.getStats(stats);
+        trigCalls = stats.trigCalls;
+    }
+    bench.report("trig_calls_per_fix", (double)trigCalls / (double)iterations);
+    return iterations;
+}
+
+static uint64_t
+benchOdometer(GPSBenchmark &bench, unsigned param, uint64_t iterations)
+{
+    (void)param;
+    bench.pauseTiming();
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    GPSOdometer odometer;
+    odometer.enableOdo();
+    odometer.startOdo(0);
+    bench.resumeTiming();
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        odometer.update(fixes[i % fixCount]);
+    }
+    bench.consume((uint64_t)odometer.getDistance());
+    return iterations;
+}
+
+/*
+ * GPSOdometer over DRIFT_KM of driving, 8 to 12 m per fix around 63 km
+ * circles: the total against the length of the generated path, and
+ * against the exact (long double) sum of the steps the odometer returned,
+ * next to what a plain double sum of the same steps would have drifted.
+ * The whole distance is driven whatever the iteration count.
+ */
+static uint64_t
+benchOdometerDrift(GPSBenchmark &bench, unsigned param, uint64_t iterations)
+{
+    (void)param;
+    (void)iterations;
+    bench.pauseTiming();
+    static GPSProvider::LocationUpdateParams_t fixes[DRIFT_BLOCK];
+    static double returned[DRIFT_BLOCK];
+    const double metersPerDeg = GPS_EARTH_RADIUS_M * GPS_DEG_TO_RAD;
+    const double turn = 0.001;   /* rad per fix */
+    const double cosTurn = cos(turn);
+    const double sinTurn = sin(turn);
+    GPSOdometer odometer;
+    odometer.enableOdo();
+    odometer.startOdo(0);
+
+    double lat = 45.0;
+    double lon = 9.0;
+    double north = 1.0;
+    double east = 0.0;
+    uint32_t seed = 12345;
+    long double path = 0.0L;
+    long double exact = 0.0L;
+    double naive = 0.0;
+    uint64_t fixCount = 0;
+    uint64_t utcTime = 0;
+    bool first = true;
+    while (path < DRIFT_KM * 1000.0L) {
+        for (unsigned i = 0; i < DRIFT_BLOCK; i++) {
+            if (!first) {
+                seed = seed * 1664525U + 1013904223U;
+                double step = 8.0 + 4.0 * (seed >> 8) / 16777216.0;
+                double midLat = lat + step * north / (2.0 * metersPerDeg);
+                lat += step * north / metersPerDeg;
+                lon += step * east / (metersPerDeg * cos(midLat * GPS_DEG_TO_RAD));
+                path += step;
+                double rotated = north * cosTurn - east * sinTurn;
+                east = north * sinTurn + east * cosTurn;
+                north = rotated;
+            }
+            first = false;
+            memset(&fixes[i], 0, sizeof(fixes[i]));
+            fixes[i].valid = true;
+            fixes[i].lat = lat;
+            fixes[i].lon = lon;
+            fixes[i].utcTime = (utcTime += 1000);
+        }
+        bench.resumeTiming();
+        for (unsigned i = 0; i < DRIFT_BLOCK; i++) {
+            returned[i] = odometer.update(fixes[i]);
+        }
+        bench.pauseTiming();
+        for (unsigned i = 0; i < DRIFT_BLOCK; i++) {
+            exact += returned[i];
+            naive += returned[i];
+        }
+        fixCount += DRIFT_BLOCK;
+    }
+
+    double total = odometer.getDistance();
+    bench.report("distance_km", total / 1000.0);
+    bench.report("error_ppm", (double)(((long double)total - path) * 1e6L / path));
+    bench.report("sum_drift_m", (double)((long double)total - exact));
+    bench.report("naive_sum_drift_m", (double)((long double)naive - exact));
+    return fixCount;
+}
+
+static uint64_t
+benchReplay(GPSBenchmark &bench, unsigned param, uint64_t iterations)
+{
+    (void)param;
+    bench.pauseTiming();
+    const char *path = bench.getCapturePath();
+    if (path == NULL) {
+        return 0;
+    }
+
+    uint64_t fixes = 0;
+    uint64_t sentences = 0;
+    uint64_t updates = 0;
+    uint64_t latencySumNs = 0;
+    uint64_t latencyMaxNs = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        GPSReplayProvider replay(path);
+        GPSProvider gps(&replay);
+        gps.onLocationUpdate(countLocation);
+        gps.start();
+        bench.resumeTiming();
+        while (!replay.isReplayDone()) {
+            gps.process();
+        }
+        bench.pauseTiming();
+        gps.stop();
+        const GPSReplayProvider::ReplayStats_t &stats = replay.getReplayStats();
+        fixes += stats.fixes;
+        sentences += stats.sentences;
+        updates += stats.locationUpdates;
+        latencySumNs += stats.callbackLatencySumNs;
+        latencyMaxNs = (stats.callbackLatencyMaxNs > latencyMaxNs) ? stats.callbackLatencyMaxNs : latencyMaxNs;
+    }
+    if (fixes == 0) {
+        return 0;
+    }
+    bench.reportRate("sentences_per_sec", (double)sentences / (double)fixes);
+    bench.reportRate("fixes_per_sec", 1.0);
+    bench.report("callback_latency_ns", (double)latencySumNs / (double)updates);
+    bench.report("callback_latency_max_ns", (double)latencyMaxNs);
+    return fixes;
+}
+
+/*
+ * The replay of benchReplay with a geofence, the datalog and the odometer
+ * running, for the instrumentation overhead: the same case built without
+ * and with GPS_PROCESS_STATS or GPS_TRACE, compared with --baseline. With
+ * GPS_TRACE, param 0 leaves the hooks without a recorder and param 1
+ * records every stage.
+ */
+#if defined(GPS_TRACE)
+static const unsigned TRACE_EVENTS = 1U << 16;
+static GPSTraceRecorder::TraceEvent_t traceEvents[TRACE_EVENTS];
+#endif
+
+static uint64_t
+benchInstrumented(GPSBenchmark &bench, unsigned traced, uint64_t iterations)
+{
+    bench.pauseTiming();
+    const char *capture = bench.getCapturePath();
+    if (capture == NULL) {
+        return 0;
+    }
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    GPSGeofence::GeofenceCircle_t circle;
+    circle.id = 0;
+    circle.enabled = true;
+    circle.lat = fixes[fixCount / 2].lat;
+    circle.lon = fixes[fixCount / 2].lon;
+    circle.radius = 200;
+    circle.tolerance = 10;
+    circle.status = 0;
+    GPSGeofence geofence(circle);
+    GPSGeofence *list[1] = { &geofence };
+#if defined(GPS_TRACE)
+    GPSTraceRecorder recorder(traceEvents, TRACE_EVENTS);
+    uint64_t events = 0;
+#else
+    (void)traced;
+#endif
+
+    const char *path = bench.getScratchPath("instrumented.bin");
+    uint64_t fixesDone = 0;
+    GPSProvider::ProcessStats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    for (uint64_t i = 0; i < iterations; i++) {
+        unlink(path);
+        GPSReplayProvider replay(capture);
+        replay.setDatalogStore(path, DATALOG_CAPACITY);
+        GPSProvider gps(&replay);
+        GPSDatalog datalog(false, true, 0, 0, 0, 1);
+        gps.onLocationUpdate(countLocation);
+        gps.onGeofenceStatusMessage(countGeofenceStatus);
+        if ((gps.enableGeofence() != GPS_ERROR_NONE) ||
+            (gps.configGeofences(list, 1) != GPS_ERROR_NONE) ||
+            (gps.enableDatalog() != GPS_ERROR_NONE) ||
+            (gps.configDatalog(&datalog) != GPS_ERROR_NONE) ||
+            (gps.startDatalog() != GPS_ERROR_NONE) ||
+            (gps.enableOdo() != GPS_ERROR_NONE) ||
+            (gps.startOdo(0) != GPS_ERROR_NONE)) {
+            break;
+        }
+#if defined(GPS_TRACE)
+        recorder.clear();
+        GPSTraceRecorder::setActive(traced ? &recorder : NULL);
+#endif
+        gps.start();
+        bench.resumeTiming();
+        while (!replay.isReplayDone()) {
+            gps.process();
+        }
+        bench.pauseTiming();
+#if defined(GPS_TRACE)
+        GPSTraceRecorder::setActive(NULL);
+        events += recorder.getTotal();
+#endif
+        gps.getProcessStats(stats);
+        gps.stop();
+        fixesDone += replay.getReplayStats().fixes;
+    }
+    unlink(path);
+    if (fixesDone == 0) {
+        return 0;
+    }
+#if defined(GPS_TRACE)
+    if (traced) {
+        bench.report("events_per_fix", (double)events / (double)fixesDone);
+    }
+#endif
+    if (stats.enabled && (stats.processTicks.count > 0)) {
+        bench.report("process_mean_ns", (double)stats.processTicks.sum * 1e9 /
+                                        ((double)stats.clockHz * (double)stats.processTicks.count));
+    }
+    return fixesDone;
+}
+
+/*
+ * GPSGeofenceVirtualizer on a replay: VIRTUAL_FENCES fences behind a
+ * receiver holding VIRTUAL_SLOTS. The host wakes up for receiver geofence
+ * messages only; evaluating on the host would wake it at every fix.
+ */
+static const unsigned VIRTUAL_FENCES = 30;
+static const unsigned VIRTUAL_SLOTS = 8;
+
+static GPSGeofenceVirtualizer *virtualizer;
+
+static void
+forwardVirtualizerStatus(const GPSProvider::GeofenceStatusParams_t *params, int ret_code)
+{
+    virtualizer->handleStatus(params, ret_code);
+}
+
+static uint64_t
+benchVirtualizer(GPSBenchmark &bench, unsigned param, uint64_t iterations)
+{
+    (void)param;
+    bench.pauseTiming();
+    const char *path = bench.getCapturePath();
+    if (path == NULL) {
+        return 0;
+    }
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    GPSGeofence geofences[VIRTUAL_FENCES];
+    GPSGeofence *list[VIRTUAL_FENCES];
+    scatterFences(fixes, fixCount, 0.002, geofences, list, VIRTUAL_FENCES);
+
+    uint64_t fixesSeen = 0;
+    uint64_t wakeups = 0;
+    uint64_t transactions = 0;
+    uint64_t recomputations = 0;
+    callbacks = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        GPSReplayProvider replay(path);
+        replay.setGeofenceLimit(VIRTUAL_SLOTS);
+        GPSProvider gps(&replay);
+        GPSGeofenceVirtualizer fences(gps, VIRTUAL_SLOTS);
+        virtualizer = &fences;
+        gps.onGeofenceStatusMessage(forwardVirtualizerStatus);
+        fences.onGeofenceStatusMessage(countGeofenceStatus);
+        if (fences.configGeofences(list, VIRTUAL_FENCES) != GPS_ERROR_NONE) {
+            return 0;
+        }
+        gps.start();
+        bench.resumeTiming();
+        while (!replay.isReplayDone()) {
+            gps.process();
+            fences.process();
+        }
+        bench.pauseTiming();
+        gps.stop();
+
+        GPSGeofenceVirtualizer::VirtualizerStats_t stats;
+        fences.getStats(stats);
+        fixesSeen += replay.getReplayStats().fixes;
+        wakeups += stats.receiverMessages;
+        transactions += stats.configTransactions;
+        recomputations += stats.recomputations;
+    }
+    virtualizer = NULL;
+    if (fixesSeen == 0) {
+        return 0;
+    }
+    bench.report("wakeups_per_fix", (double)wakeups / (double)fixesSeen);
+    bench.report("config_transactions", (double)transactions / (double)iterations);
+    bench.report("recomputations", (double)recomputations / (double)iterations);
+    bench.report("transitions", (double)callbacks / (double)iterations);
+    return fixesSeen;
+}
+
+/*
+ * GPSWireEncoder/GPSWireDecoder with the default quanta on the track: the
+ * stream of one pass is encoded once to measure the bytes per fix and
+ * the round trip error, then either direction is timed.
+ */
+static uint64_t
+benchWireCodec(GPSBenchmark &bench, unsigned decode, uint64_t iterations)
+{
+    bench.pauseTiming();
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    uint8_t *stream = (uint8_t *)malloc((size_t)fixCount * GPSWireEncoder::MAX_FRAME_SIZE);
+    if (stream == NULL) {
+        return 0;
+    }
+    GPSWireEncoder encoder;
+    size_t size = 0;
+    for (unsigned i = 0; i < fixCount; i++) {
+        size += encoder.encode(fixes[i], &stream[size], GPSWireEncoder::MAX_FRAME_SIZE);
+    }
+
+    GPSWireDecoder decoder;
+    unsigned decoded = 0;
+    double maxError = 0.0;
+    for (size_t offset = 0; offset < size; ) {
+        size_t n = decoder.decode(&stream[offset], size - offset);
+        if (n == 0) {
+            break;
+        }
+        offset += n;
+        if (decoder.takeLocation() && (decoded < fixCount)) {
+            const GPSProvider::LocationUpdateParams_t &fix = fixes[decoded++];
+            double error = GPSProviderUtils::localDistance(fix.lat, fix.lon,
+                                                           decoder.getLocation().lat, decoder.getLocation().lon);
+            maxError = (error > maxError) ? error : maxError;
+        }
+    }
+
+    uint64_t ops = 0;
+    bench.resumeTiming();
+    for (uint64_t i = 0; i < iterations; i++) {
+        if (decode) {
+            decoder.reset();
+            size_t offset = 0;
+            while (offset < size) {
+                offset += decoder.decode(&stream[offset], size - offset);
+                if (decoder.takeLocation()) {
+                    ops++;
+                }
+            }
+            bench.consume(decoder.getLocation().utcTime);
+        } else {
+            encoder.reset();
+            size_t offset = 0;
+            for (unsigned f = 0; f < fixCount; f++) {
+                offset += encoder.encode(fixes[f], &stream[offset], GPSWireEncoder::MAX_FRAME_SIZE);
+            }
+            bench.consume(offset);
+            ops += fixCount;
+        }
+    }
+    bench.pauseTiming();
+    free(stream);
+
+    if (decoded != fixCount) {
+        return 0;
+    }
+    bench.report("bytes_per_fix", (double)size / (double)fixCount);
+    bench.report("ratio_vs_struct", sizeof(GPSProvider::LocationUpdateParams_t) * (double)fixCount / (double)size);
+    bench.report("max_error_m", maxError);
+    return ops;
+}
+
+/*
+ * GPSTrackSimplifier on the track at several tolerances, per fix offered.
+ */
+static uint64_t
+benchSimplifier(GPSBenchmark &bench, unsigned tolerance, uint64_t iterations)
+{
+    bench.pauseTiming();
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    uint64_t forced = 0;
+    callbacks = 0;
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        GPSTrackSimplifier simplifier((double)tolerance);
+        if (!simplifier.isValid()) {
+            return 0;
+        }
+        simplifier.onPoint(countLocation);
+        bench.resumeTiming();
+        for (unsigned f = 0; f < fixCount; f++) {
+            simplifier.update(fixes[f]);
+        }
+        simplifier.flush();
+        bench.pauseTiming();
+        GPSTrackSimplifier::SimplifierStats_t stats;
+        simplifier.getStats(stats);
+        forced += stats.forced;
+    }
+    if (callbacks == 0) {
+        return 0;
+    }
+    bench.report("reduction_ratio", (double)(iterations * fixCount) / (double)callbacks);
+    bench.report("forced_per_pass", (double)forced / (double)iterations);
+    return iterations * fixCount;
+}
+
+/*
+ * GPSDeadReckoning in POWER_LOW: the application asks for the position
+ * every DR_QUERY_PERIOD fixes of the track, the receiver delivers a fix
+ * every DR_FIX_PERIOD fixes and, woken by the fix-request callback, at
+ * the next one. Delivered fixes get about 3 m of noise. Without the
+ * estimator every query would wake the receiver.
+ */
+static const unsigned DR_QUERY_PERIOD = 2;
+static const unsigned DR_FIX_PERIOD = 30;
+
+static bool fixRequested;
+
+static void
+requestFix(void)
+{
+    fixRequested = true;
+}
+
+static uint64_t
+benchDeadReckoning(GPSBenchmark &bench, unsigned threshold, uint64_t iterations)
+{
+    bench.pauseTiming();
+    unsigned fixCount;
+    const GPSProvider::LocationUpdateParams_t *fixes = bench.getFixes(fixCount);
+    uint64_t queries = 0;
+    uint64_t inBound = 0;
+    uint64_t wakeups = 0;
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        GPSDeadReckoning dr;
+        dr.setMeasurementNoise(3.0);
+        dr.setErrorThreshold((double)threshold);
+        dr.onFixRequest(requestFix);
+        fixRequested = false;
+        uint32_t seed = 12345;
+        bench.resumeTiming();
+        for (unsigned f = 0; f < fixCount; f++) {
+            if (((f % DR_FIX_PERIOD) == 0) || fixRequested) {
+                if (fixRequested) {
+                    wakeups++;
+                    fixRequested = false;
+                }
+                GPSProvider::LocationUpdateParams_t fix = fixes[f];
+                /* uniform, 3 m standard deviation */
+                double noise[2];
+                for (unsigned k = 0; k < 2; k++) {
+                    seed = seed * 1664525U + 1013904223U;
+                    noise[k] = 3.0 * sqrt(3.0) * ((seed >> 8) / 8388608.0 - 1.0);
+                }
+                fix.lat += noise[0] / (GPS_EARTH_RADIUS_M * GPS_DEG_TO_RAD);
+                fix.lon += noise[1] / (GPS_EARTH_RADIUS_M * GPS_DEG_TO_RAD * cos(fix.lat * GPS_DEG_TO_RAD));
+                dr.update(fix);
+            }
+            if ((f % DR_QUERY_PERIOD) == 0) {
+                GPSDeadReckoning::Estimate_t where;
+                if (dr.locate(fixes[f].utcTime, where)) {
+                    queries++;
+                    if (GPSProviderUtils::localDistance(fixes[f].lat, fixes[f].lon, where.lat, where.lon) <=
+                        where.errorRadius) {
+                        inBound++;
+                    }
+                }
+            }
+        }
+        bench.pauseTiming();
+    }
+    if (queries == 0) {
+        return 0;
+    }
+    bench.report("wakeups_avoided", 1.0 - (double)wakeups / (double)queries);
+    bench.report("in_bound", (double)inBound / (double)queries);
+    return queries;
+}
+
+/*
+ * GPSPowerScheduler fed by a replay, mode changes applied to the replay
+ * backend: the share of the track spent in each power mode, and the fixes
+ * the scheduler would have asked for against those delivered. The replay
+ * is a commute, one fix per second: parked, a walk to the car, a drive, a
+ * walk from the car, parked again (the parked receiver wanders by a few
+ * meters, as a real one does).
+ */
+struct CommuteSegment_t {
+    unsigned seconds;
+    double   speed;      /* m/s, 0: parked */
+};
+
+static const CommuteSegment_t COMMUTE[] = {
+    { 900, 0.0 }, { 300, 1.4 }, { 1200, 13.0 }, { 300, 1.4 }, { 900, 0.0 }
+};
+
+static bool
+writeCommute(const char *path)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+
+    const double metersPerDeg = GPS_EARTH_RADIUS_M * GPS_DEG_TO_RAD;
+    double lat = 45.0;
+    double lon = 9.0;
+    uint32_t seed = 12345;
+    unsigned t = 0;
+    uint8_t sentence[TRACK_SENTENCE_MAX + 8];
+    char body[TRACK_SENTENCE_MAX];
+    char latText[16];
+    char lonText[16];
+    bool ok = true;
+    for (unsigned segment = 0; segment < sizeof(COMMUTE) / sizeof(COMMUTE[0]); segment++) {
+        for (unsigned i = 0; i < COMMUTE[segment].seconds; i++, t++) {
+            double speed = COMMUTE[segment].speed;
+            double course = 90.0 + 30.0 * sin(t / 120.0);
+            lat += speed * cos(course * GPS_DEG_TO_RAD) / metersPerDeg;
+            lon += speed * sin(course * GPS_DEG_TO_RAD) / (metersPerDeg * cos(lat * GPS_DEG_TO_RAD));
+            /* +-3 m of position noise */
+            seed = seed * 1664525U + 1013904223U;
+            double northNoise = 3.0 * ((seed >> 8) / 8388608.0 - 1.0);
+            seed = seed * 1664525U + 1013904223U;
+            double eastNoise = 3.0 * ((seed >> 8) / 8388608.0 - 1.0);
+            formatCoordinate(latText, lat + northNoise / metersPerDeg, 2);
+            formatCoordinate(lonText, lon + eastNoise / (metersPerDeg * cos(lat * GPS_DEG_TO_RAD)), 3);
+
+            snprintf(body, sizeof(body), "GPRMC,%02u%02u%02u.00,A,%s,N,%s,E,%.1f,%.1f,171026,,,A",
+                     8 + t / 3600, (t / 60) % 60, t % 60, latText, lonText, speed * 3600.0 / 1852.0, course);
+            size_t len = appendSentence(sentence, body);
+            ok = ok && (fwrite(sentence, 1, len, file) == len);
+        }
+    }
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    return ok;
+}
+
+static GPSPowerScheduler *scheduler;
+static uint64_t nextWanted;
+static uint64_t fixesWanted;
+
+static void
+forwardSchedulerLocation(const GPSProvider::LocationUpdateParams_t *params)
+{
+    if ((params == NULL) || !params->valid) {
+        return;
+    }
+    if (params->utcTime >= nextWanted) {
+        fixesWanted++;
+    }
+    nextWanted = scheduler->update(*params);
+}
+
+static uint64_t
+benchPowerScheduler(GPSBenchmark &bench, unsigned param, uint64_t iterations)
+{
+    (void)param;
+    bench.pauseTiming();
+    const char *path = bench.getScratchPath("commute.nmea");
+    if (!writeCommute(path)) {
+        unlink(path);
+        return 0;
+    }
+
+    uint64_t fixes = 0;
+    uint64_t timeInMode[2] = { 0, 0 };
+    uint64_t switches = 0;
+    fixesWanted = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        GPSReplayProvider replay(path);
+        GPSProvider gps(&replay);
+        GPSPowerScheduler power(&gps);
+        scheduler = &power;
+        nextWanted = 0;
+        gps.onLocationUpdate(forwardSchedulerLocation);
+        gps.start();
+        bench.resumeTiming();
+        while (!replay.isReplayDone()) {
+            gps.process();
+        }
+        bench.pauseTiming();
+        gps.stop();
+
+        GPSPowerScheduler::SchedulerStats_t stats;
+        power.getStats(stats);
+        fixes += replay.getReplayStats().fixes;
+        timeInMode[GPSProvider::POWER_FULL] += stats.timeInMode[GPSProvider::POWER_FULL];
+        timeInMode[GPSProvider::POWER_LOW] += stats.timeInMode[GPSProvider::POWER_LOW];
+        switches += stats.modeSwitches;
+    }
+    scheduler = NULL;
+    unlink(path);
+    uint64_t span = timeInMode[GPSProvider::POWER_FULL] + timeInMode[GPSProvider::POWER_LOW];
+    if ((fixes == 0) || (span == 0)) {
+        return 0;
+    }
+    bench.report("full_power_share", (double)timeInMode[GPSProvider::POWER_FULL] / (double)span);
+    bench.report("low_power_share", (double)timeInMode[GPSProvider::POWER_LOW] / (double)span);
+    bench.report("fixes_wanted_ratio", (double)fixesWanted / (double)fixes);
+    bench.report("mode_switches", (double)switches / (double)iterations);
+    return fixes;
+}
+
+/*
+ * GPSRingBuffer under load: a thread stands in for the UART ISR and pushes
+ * the capture in DMA-sized chunks, the caller parses it as the driver
+ * would. The blocking producer waits for room (flow control) and runs
+ * flat out, which gives the ring throughput. The UART producers never
+ * wait, as an ISR cannot, and release each chunk when a line at that baud
+ * rate would have delivered it (10 bits per byte) for at least a second;
+ * what they lose is what the consumer failed to keep up with.
+ */
+
+static const unsigned RING_STRESS_SIZE = 1024;
+static const unsigned RING_STRESS_CHUNK = 64;
+static const unsigned RING_STRESS_LINE_MS = 1000;   /* least line time of a paced run */
+
+struct RingProducer_t {
+    GPSRingBuffer  *ring;
+    const uint8_t  *capture;
+    size_t         captureLen;
+    uint64_t       bytes;
+    unsigned       baud;       /* 0: blocking, unpaced */
+    uint32_t       done;
+};
+
+static void *
+ringProducer(void *arg)
+{
+    RingProducer_t *producer = (RingProducer_t *)arg;
+    size_t offset = 0;
+    uint64_t sent = 0;
+    struct timespec release;
+    clock_gettime(CLOCK_MONOTONIC, &release);
+
+    while (sent < producer->bytes) {
+        size_t len = producer->captureLen - offset;
+        if (len > RING_STRESS_CHUNK) {
+            len = RING_STRESS_CHUNK;
+        }
+        if (producer->baud == 0) {
+            while (producer->ring->space() < len) {
+                sched_yield();
+            }
+        } else {
+            /* absolute deadlines: a late wakeup does not slow the line down */
+            uint64_t ns = (uint64_t)release.tv_nsec + len * 10ULL * 1000000000ULL / producer->baud;
+            release.tv_sec += (time_t)(ns / 1000000000ULL);
+            release.tv_nsec = (long)(ns % 1000000000ULL);
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &release, NULL) != 0) {
+                /* interrupted: sleep again until the deadline */
+            }
+        }
+        producer->ring->write(&producer->capture[offset], len);
+        sent += len;
+        offset += len;
+        if (offset == producer->captureLen) {
+            offset = 0;
+        }
+    }
+    __atomic_store_n(&producer->done, 1U, __ATOMIC_RELEASE);
+    producer->ring->wakeup();
+    return NULL;
+}
+
+static uint64_t
+benchRingStress(GPSBenchmark &bench, unsigned baud, uint64_t iterations)
+{
+    bench.pauseTiming();
+    size_t len;
+    const uint8_t *capture = bench.getCapture(len);
+    static uint8_t storage[RING_STRESS_SIZE];
+    GPSRingBuffer ring(storage, sizeof(storage));
+    GPSRingBufferEvent event;
+    ring.setEvent(&event);
+    GPSNmeaParser parser;
+
+    RingProducer_t producer;
+    producer.ring = &ring;
+    producer.capture = capture;
+    producer.captureLen = len;
+    producer.bytes = iterations;
+    producer.baud = baud;
+    if (baud != 0) {
+        uint64_t minimum = (uint64_t)baud / 10 * RING_STRESS_LINE_MS / 1000;
+        if (producer.bytes < minimum) {
+            producer.bytes = minimum;
+        }
+    }
+    producer.done = 0;
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, ringProducer, &producer) != 0) {
+        return 0;
+    }
+    bench.resumeTiming();
+
+    uint64_t received = 0;
+    for (;;) {
+        ring.waitForData();
+        const uint8_t *span;
+        size_t n;
+        while ((n = ring.readSpan(&span)) > 0) {
+            size_t used = 0;
+            while (used < n) {
+                used += parser.parse(&span[used], n - used);
+                if (parser.takeLocationUpdate()) {
+                    bench.consume(parser.getLocation().utcTime);
+                }
+            }
+            ring.consume(n);
+            received += n;
+        }
+        if ((__atomic_load_n(&producer.done, __ATOMIC_ACQUIRE) != 0) && (ring.available() == 0)) {
+            break;
+        }
+    }
+    bench.pauseTiming();
+    pthread_join(thread, NULL);
+
+    GPSRingBuffer::RingStats_t stats;
+    ring.getStats(stats);
+    const GPSNmeaParser::ParserStats_t &parsed = parser.getStats();
+    bench.reportRate("bytes_per_sec", 1.0);
+    bench.report("overrun_ratio", (double)stats.overrunBytes / (double)(stats.overrunBytes + stats.bytesWritten));
+    bench.report("overrun_events", stats.overrunEvents);
+    bench.report("high_water", stats.highWater);
+    bench.report("bad_sentences", parsed.checksumErrors + parsed.droppedSentences);
+    return received;
+}
+
+/*
+ * Command line
+ */
+
+static int
+usage(const char *program)
+{
+    fprintf(stderr, "usage: %s [--json path] [--baseline path] [--threshold percent]\n"
+            "    [--filter text] [--fences count] [--min-time ms] [--repetitions n]\n"
+            "    [--capture path] [--tmpdir dir]\n", program);
+    return 2;
+}
+
+/*
+ * GPSBenchmark
+ */
+
+GPSBenchmark::GPSBenchmark() :
+    _minTimeNs(100000000ULL),
+    _repetitions(5),
+    _fenceCount(4096),
+    _filter(NULL),
+    _tempDir("/tmp"),
+    _capture(NULL),
+    _captureLen(0),
+    _captureSentences(0),
+    _fixes(NULL),
+    _fixCount(0),
+    _resultCount(0),
+    _metricCount(0),
+    _startNs(0),
+    _elapsedNs(0),
+    _timing(false),
+    _sink(0)
+{
+    _capturePath[0] = '\0';
+    _scratchPath[0] = '\0';
+}
+
+GPSBenchmark::~GPSBenchmark()
+{
+    if (_capturePath[0] != '\0') {
+        unlink(_capturePath);
+    }
+    free(_capture);
+    free(_fixes);
+}
+
+void
+GPSBenchmark::setRepetitions(unsigned repetitions)
+{
+    if (repetitions < 1) {
+        repetitions = 1;
+    }
+    _repetitions = (repetitions > MAX_REPETITIONS) ? MAX_REPETITIONS : repetitions;
+}
+
+bool
+GPSBenchmark::setCapture(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t *capture = (size > 0) ? (uint8_t *)malloc((size_t)size) : NULL;
+    bool ok = (capture != NULL) && (fread(capture, 1, (size_t)size, file) == (size_t)size);
+    fclose(file);
+    if (!ok) {
+        free(capture);
+        return false;
+    }
+
+    free(_capture);
+    _capture = capture;
+    _captureLen = (size_t)size;
+    if (_capturePath[0] != '\0') {
+        unlink(_capturePath);
+        _capturePath[0] = '\0';
+    }
+    return loadFixes();
+}
+
+void
+GPSBenchmark::generateTrack(void)
+{
+    free(_capture);
+    _capture = (uint8_t *)malloc(TRACK_FIXES * 4 * TRACK_SENTENCE_MAX);
+    _captureLen = 0;
+    if (_capture == NULL) {
+        return;
+    }
+
+    double lat = 45.0;
+    double lon = 9.0;
+    const double speed = 10.0;
+    char body[TRACK_SENTENCE_MAX];
+    char latText[16];
+    char lonText[16];
+    for (unsigned i = 0; i < TRACK_FIXES; i++) {
+        double course = 90.0 + 60.0 * sin(i / 60.0);
+        lat += speed * cos(course * GPS_DEG_TO_RAD) / (GPS_EARTH_RADIUS_M * GPS_DEG_TO_RAD);
+        lon += speed * sin(course * GPS_DEG_TO_RAD) /
+               (GPS_EARTH_RADIUS_M * GPS_DEG_TO_RAD * cos(lat * GPS_DEG_TO_RAD));
+        formatCoordinate(latText, lat, 2);
+        formatCoordinate(lonText, lon, 3);
+        unsigned hh = 12 + i / 3600;
+        unsigned mm = (i / 60) % 60;
+        unsigned ss = i % 60;
+        double knots = speed * 3600.0 / 1852.0;
+
+        sprintf(body, "GPRMC,%02u%02u%02u.00,A,%s,N,%s,E,%.1f,%.1f,171026,,,A",
+                hh, mm, ss, latText, lonText, knots, course);
+        _captureLen += appendSentence(&_capture[_captureLen], body);
+        sprintf(body, "GPGGA,%02u%02u%02u.00,%s,N,%s,E,1,08,0.9,%.1f,M,47.0,M,,",
+                hh, mm, ss, latText, lonText, 120.0 + 5.0 * sin(i / 30.0));
+        _captureLen += appendSentence(&_capture[_captureLen], body);
+        sprintf(body, "GPGSV,3,%u,11,01,40,083,46,02,17,308,41,12,07,344,39,14,22,228,45",
+                i % 3 + 1);
+        _captureLen += appendSentence(&_capture[_captureLen], body);
+        sprintf(body, "GPVTG,%.1f,T,,M,%.1f,N,%.1f,K,A", course, knots, speed * 3.6);
+        _captureLen += appendSentence(&_capture[_captureLen], body);
+    }
+}
+
+bool
+GPSBenchmark::loadFixes(void)
+{
+    GPSNmeaParser parser;
+    unsigned capacity = 0;
+    _fixCount = 0;
+    size_t offset = 0;
+    while (offset < _captureLen) {
+        offset += parser.parse(&_capture[offset], _captureLen - offset);
+        if (!parser.takeLocationUpdate() || !parser.getLocation().valid) {
+            continue;
+        }
+        if (_fixCount == capacity) {
+            capacity = (capacity > 0) ? capacity * 2 : 256;
+            GPSProvider::LocationUpdateParams_t *fixes = (GPSProvider::LocationUpdateParams_t *)
+                realloc(_fixes, capacity * sizeof(GPSProvider::LocationUpdateParams_t));
+            if (fixes == NULL) {
+                return false;
+            }
+            _fixes = fixes;
+        }
+        _fixes[_fixCount++] = parser.getLocation();
+    }
+    _captureSentences = parser.getStats().sentences;
+    return _fixCount > 0;
+}
+
+const char *
+GPSBenchmark::getCapturePath(void)
+{
+    if (_capturePath[0] != '\0') {
+        return _capturePath;
+    }
+    snprintf(_capturePath, sizeof(_capturePath), "%s/gpsbench-%d.nmea", _tempDir, (int)getpid());
+    FILE *file = fopen(_capturePath, "wb");
+    bool ok = (file != NULL) && (fwrite(_capture, 1, _captureLen, file) == _captureLen);
+    if ((file != NULL) && (fclose(file) != 0)) {
+        ok = false;
+    }
+    if (!ok) {
+        unlink(_capturePath);
+        _capturePath[0] = '\0';
+        return NULL;
+    }
+    return _capturePath;
+}
+
+const char *
+GPSBenchmark::getScratchPath(const char *suffix)
+{
+    snprintf(_scratchPath, sizeof(_scratchPath), "%s/gpsbench-%d-%s", _tempDir, (int)getpid(), suffix);
+    unlink(_scratchPath);
+    return _scratchPath;
+}
+
+void
+GPSBenchmark::pauseTiming(void)
+{
+    if (_timing) {
+        _elapsedNs += nowNs() - _startNs;
+        _timing = false;
+    }
+}
+
+void
+GPSBenchmark::resumeTiming(void)
+{
+    if (!_timing) {
+        _timing = true;
+        _startNs = nowNs();
+    }
+}
+
+void
+GPSBenchmark::report(const char *metric, double value)
+{
+    for (unsigned i = 0; i < _metricCount; i++) {
+        if (strcmp(_metrics[i].name, metric) == 0) {
+            _metrics[i].value = value;
+            _rates[i] = false;
+            return;
+        }
+    }
+    if (_metricCount < MAX_METRICS) {
+        _metrics[_metricCount].name = metric;
+        _metrics[_metricCount].value = value;
+        _rates[_metricCount++] = false;
+    }
+}
+
+void
+GPSBenchmark::reportRate(const char *metric, double perOp)
+{
+    report(metric, perOp);
+    for (unsigned i = 0; i < _metricCount; i++) {
+        if (strcmp(_metrics[i].name, metric) == 0) {
+            _rates[i] = true;
+        }
+    }
+}
+
+bool
+GPSBenchmark::selected(const char *name) const
+{
+    return (_filter == NULL) || (strstr(name, _filter) != NULL);
+}
+
+uint64_t
+GPSBenchmark::measure(BenchmarkFunction_t function, unsigned param, uint64_t iterations)
+{
+    _elapsedNs = 0;
+    _timing = false;
+    resumeTiming();
+    uint64_t ops = function(*this, param, iterations);
+    pauseTiming();
+    return ops;
+}
+
+void
+GPSBenchmark::runBenchmark(const char *name, const char *op, BenchmarkFunction_t function, unsigned param)
+{
+    if (!selected(name) || (_resultCount == MAX_RESULTS)) {
+        return;
+    }
+
+    /* grow the iteration count until a run takes a tenth of the target,
+     * then scale it to the target */
+    _metricCount = 0;
+    uint64_t iterations = 1;
+    for (;;) {
+        if (measure(function, param, iterations) == 0) {
+            printf("%-26s failed\n", name);
+            return;
+        }
+        if ((_elapsedNs >= _minTimeNs / 10) || (iterations >= MAX_ITERATIONS)) {
+            break;
+        }
+        iterations *= 10;
+    }
+    double scaled = (double)iterations * (double)_minTimeNs / (double)((_elapsedNs > 0) ? _elapsedNs : 1);
+    iterations = (scaled < 1.0) ? 1 : ((scaled > (double)MAX_ITERATIONS) ? MAX_ITERATIONS : (uint64_t)scaled);
+
+    double samples[MAX_REPETITIONS];
+    uint64_t ops = 0;
+    for (unsigned r = 0; r < _repetitions; r++) {
+        ops = measure(function, param, iterations);
+        double sample = (ops > 0) ? (double)_elapsedNs / (double)ops : 0.0;
+        /* insertion sort: the best is first, the median in the middle */
+        unsigned k = r;
+        while ((k > 0) && (samples[k - 1] > sample)) {
+            samples[k] = samples[k - 1];
+            k--;
+        }
+        samples[k] = sample;
+    }
+
+    Result_t &result = _results[_resultCount++];
+    snprintf(result.name, sizeof(result.name), "%s", name);
+    result.op = op;
+    result.nsPerOp = samples[0];
+    result.medianNsPerOp = samples[_repetitions / 2];
+    result.opsPerRep = ops;
+    result.repetitions = _repetitions;
+    result.metricCount = _metricCount;
+    for (unsigned i = 0; i < _metricCount; i++) {
+        result.metrics[i] = _metrics[i];
+        if (_rates[i]) {
+            result.metrics[i].value = (result.nsPerOp > 0.0) ? _metrics[i].value * 1e9 / result.nsPerOp : 0.0;
+        }
+    }
+    printf("%-26s %12.1f ns/%-9s (median %.1f, %llu x %u)\n", result.name, result.nsPerOp, op,
+           result.medianNsPerOp, (unsigned long long)ops, _repetitions);
+    for (unsigned i = 0; i < result.metricCount; i++) {
+        printf("    %-22s %14.4g\n", result.metrics[i].name, result.metrics[i].value);
+    }
+    fflush(stdout);
+}
+
+unsigned
+GPSBenchmark::runAll(void)
+{
+    if (_fixes == NULL) {
+        generateTrack();
+        if (!loadFixes()) {
+            printf("no fix in the capture\n");
+            return 0;
+        }
+    }
+
+    unsigned first = _resultCount;
+    char name[sizeof(_results[0].name)];
+    runBenchmark("facade.process", "call", benchFacadeProcess, 0);
+    runBenchmark("facade.location_cb", "callback", benchFacadeLocation, 0);
+    runBenchmark("nmea.parse", "sentence", benchNmeaParse, 0);
+    runBenchmark("nmea.parse_naive", "sentence", benchNmeaParseNaive, 0);
+    snprintf(name, sizeof(name), "geofence.evaluate.%u", SMALL_FENCE_COUNT);
+    runBenchmark(name, "fix", benchGeofence, SMALL_FENCE_COUNT);
+    if (_fenceCount != SMALL_FENCE_COUNT) {
+        snprintf(name, sizeof(name), "geofence.evaluate.%u", _fenceCount);
+        runBenchmark(name, "fix", benchGeofence, _fenceCount);
+    }
+    for (unsigned count = 1000; count <= 1000000; count *= 10) {
+        snprintf(name, sizeof(name), "geofence.index.%u", count);
+        runBenchmark(name, "query", benchGeofenceIndex, count);
+    }
+    for (unsigned i = 0; i < sizeof(WAKEUP_FENCES) / sizeof(WAKEUP_FENCES[0]); i++) {
+        snprintf(name, sizeof(name), "geofence.wakeup.%u", WAKEUP_FENCES[i]);
+        runBenchmark(name, "fix", benchGeofenceWakeup, WAKEUP_FENCES[i]);
+    }
+    runBenchmark("kernel.fence_test.double", "test", benchFenceTest, 0);
+    runBenchmark("kernel.fence_test.fixed", "test", benchFenceTest, 1);
+    runBenchmark("kernel.odo_step.double", "step", benchOdometerStep, 0);
+    runBenchmark("kernel.odo_step.fixed", "step", benchOdometerStep, 1);
+    runBenchmark("datalog.log", "fix", benchDatalogLog, 0);
+    runBenchmark("datalog.query", "entry", benchDatalogQuery, 0);
+    runBenchmark("datalog.mirror.local", "query", benchDatalogMirror, 0);
+    runBenchmark("datalog.mirror.passthrough", "query", benchDatalogMirror, 1);
+    runBenchmark("datalog.download.bulk", "record", benchDatalogDownload, 0);
+    runBenchmark("datalog.download.per_entry", "record", benchDatalogDownload, 1);
+    for (unsigned i = 0; i < sizeof(ARCHIVE_RECORDS) / sizeof(ARCHIVE_RECORDS[0]); i++) {
+        snprintf(name, sizeof(name), "datalog.archive.open.%u", ARCHIVE_RECORDS[i]);
+        runBenchmark(name, "open", benchArchiveOpen, ARCHIVE_RECORDS[i]);
+    }
+    runBenchmark("datalog.archive.scan", "record", benchArchiveScan,
+                 ARCHIVE_RECORDS[sizeof(ARCHIVE_RECORDS) / sizeof(ARCHIVE_RECORDS[0]) - 1]);
+    runBenchmark("logblock.encode", "entry", benchLogBlock, 0);
+    runBenchmark("logblock.decode", "entry", benchLogBlock, 1);
+    runBenchmark("wire.encode", "fix", benchWireCodec, 0);
+    runBenchmark("wire.decode", "fix", benchWireCodec, 1);
+    for (unsigned i = 0; i < sizeof(SIMPLIFIER_TOLERANCES) / sizeof(SIMPLIFIER_TOLERANCES[0]); i++) {
+        snprintf(name, sizeof(name), "track.simplify.%um", SIMPLIFIER_TOLERANCES[i]);
+        runBenchmark(name, "fix", benchSimplifier, SIMPLIFIER_TOLERANCES[i]);
+    }
+    for (unsigned i = 0; i < sizeof(DR_THRESHOLDS) / sizeof(DR_THRESHOLDS[0]); i++) {
+        snprintf(name, sizeof(name), "deadreckoning.%um", DR_THRESHOLDS[i]);
+        runBenchmark(name, "query", benchDeadReckoning, DR_THRESHOLDS[i]);
+    }
+    runBenchmark("power.scheduler", "fix", benchPowerScheduler, 0);
+    runBenchmark("odometer.update", "fix", benchOdometer, 0);
+    runBenchmark("odometer.drift", "fix", benchOdometerDrift, 0);
+    runBenchmark("frame.local_distance", "fix", benchLocalFrame, 0);
+    runBenchmark("frame.shared", "fix", benchLocalFrame, 1);
+    runBenchmark("replay.pipeline", "fix", benchReplay, 0);
+    runBenchmark("replay.instrumented", "fix", benchInstrumented, 0);
+#if defined(GPS_TRACE)
+    runBenchmark("replay.instrumented.traced", "fix", benchInstrumented, 1);
+#endif
+    runBenchmark("geofence.virtualizer", "fix", benchVirtualizer, 0);
+    runBenchmark("ring.stress.blocking", "byte", benchRingStress, 0);
+    for (unsigned i = 0; i < sizeof(RING_STRESS_BAUDS) / sizeof(RING_STRESS_BAUDS[0]); i++) {
+        snprintf(name, sizeof(name), "ring.stress.uart.%u", RING_STRESS_BAUDS[i]);
+        runBenchmark(name, "byte", benchRingStress, RING_STRESS_BAUDS[i]);
+    }
+    return _resultCount - first;
+}
+
+int
+GPSBenchmark::writeJson(const char *path) const
+{
+    bool toStdout = (strcmp(path, "-") == 0);
+    FILE *file = toStdout ? stdout : fopen(path, "w");
+    if (file == NULL) {
+        return -1;
+    }
+
+#if defined(GPS_LOCATION_FIXED_POINT)
+    const char *representation = "fixed";
+#else
+    const char *representation = "double";
+#endif
+#if defined(GPS_PROCESS_STATS) && defined(GPS_TRACE)
+    const char *instrumentation = "stats+trace";
+#elif defined(GPS_PROCESS_STATS)
+    const char *instrumentation = "stats";
+#elif defined(GPS_TRACE)
+    const char *instrumentation = "trace";
+#else
+    const char *instrumentation = "none";
+#endif
+    fprintf(file, "{\n  \"suite\": \"GPSProvider\",\n  \"representation\": \"%s\",\n"
+            "  \"instrumentation\": \"%s\",\n  \"results\": [",
+            representation, instrumentation);
+    for (unsigned i = 0; i < _resultCount; i++) {
+        const Result_t &result = _results[i];
+        fprintf(file, "%s\n    {\"name\": \"%s\", \"op\": \"%s\", \"ns_per_op\": %.3f, "
+                "\"median_ns_per_op\": %.3f, \"ops_per_rep\": %llu, \"repetitions\": %u",
+                (i > 0) ? "," : "", result.name, result.op, result.nsPerOp,
+                result.medianNsPerOp, (unsigned long long)result.opsPerRep, result.repetitions);
+        if (result.metricCount > 0) {
+            fprintf(file, ", \"metrics\": {");
+            for (unsigned m = 0; m < result.metricCount; m++) {
+                fprintf(file, "%s\"%s\": %.6g", (m > 0) ? ", " : "", result.metrics[m].name,
+                        result.metrics[m].value);
+            }
+            fprintf(file, "}");
+        }
+        fprintf(file, "}");
+    }
+    fprintf(file, "\n  ]\n}\n");
+
+    if (toStdout) {
+        return (fflush(file) == 0) ? 0 : -1;
+    }
+    return (fclose(file) == 0) ? 0 : -1;
+}
+
+int
+GPSBenchmark::compareBaseline(const char *path, double maxRegression) const
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *text = (size > 0) ? (char *)malloc((size_t)size + 1) : NULL;
+    bool ok = (text != NULL) && (fread(text, 1, (size_t)size, file) == (size_t)size);
+    fclose(file);
+    if (!ok) {
+        free(text);
+        return -1;
+    }
+    text[size] = '\0';
+
+    int regressions = 0;
+    printf("%-26s %12s %12s %9s\n", "benchmark", "baseline", "current", "change");
+    for (unsigned i = 0; i < _resultCount; i++) {
+        const Result_t &result = _results[i];
+        char key[sizeof(result.name) + 16];
+        snprintf(key, sizeof(key), "\"name\": \"%s\"", result.name);
+
+        /* the value is looked up within the object of the name only */
+        const char *entry = strstr(text, key);
+        const char *end = (entry != NULL) ? strchr(entry, '}') : NULL;
+        const char *value = (entry != NULL) ? strstr(entry, "\"median_ns_per_op\":") : NULL;
+        if ((value == NULL) || (end == NULL) || (value > end)) {
+            printf("%-26s %12s %12.1f\n", result.name, "-", result.medianNsPerOp);
+            continue;
+        }
+        double baseline = strtod(value + strlen("\"median_ns_per_op\":"), NULL);
+        if (baseline <= 0.0) {
+            continue;
+        }
+
+        double change = (result.medianNsPerOp - baseline) * 100.0 / baseline;
+        bool regressed = (change > maxRegression);
+        regressions += regressed ? 1 : 0;
+        printf("%-26s %12.1f %12.1f %+8.1f%%%s\n", result.name, baseline, result.medianNsPerOp, change,
+               regressed ? "  REGRESSION" : "");
+    }
+    free(text);
+    return regressions;
+}
+
+int
+GPSBenchmark::run(int argc, char **argv)
+{
+    GPSBenchmark bench;
+    const char *jsonPath = NULL;
+    const char *baselinePath = NULL;
+    double threshold = 10.0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (value == NULL) {
+            return usage(argv[0]);
+        }
+        i++;
+        if (strcmp(arg, "--json") == 0) {
+            jsonPath = value;
+        } else if (strcmp(arg, "--baseline") == 0) {
+            baselinePath = value;
+        } else if (strcmp(arg, "--threshold") == 0) {
+            threshold = atof(value);
+        } else if (strcmp(arg, "--filter") == 0) {
+            bench.setFilter(value);
+        } else if (strcmp(arg, "--fences") == 0) {
+            bench.setFenceCount((unsigned)atoi(value));
+        } else if (strcmp(arg, "--min-time") == 0) {
+            bench.setMinTime((unsigned)atoi(value));
+        } else if (strcmp(arg, "--repetitions") == 0) {
+            bench.setRepetitions((unsigned)atoi(value));
+        } else if (strcmp(arg, "--tmpdir") == 0) {
+            bench.setTempDir(value);
+        } else if (strcmp(arg, "--capture") == 0) {
+            if (!bench.setCapture(value)) {
+                fprintf(stderr, "%s: cannot load a capture with fixes\n", value);
+                return 2;
+            }
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    if (bench.runAll() == 0) {
+        return 2;
+    }
+    if ((jsonPath != NULL) && (bench.writeJson(jsonPath) != 0)) {
+        fprintf(stderr, "%s: write error\n", jsonPath);
+        return 2;
+    }
+    if (baselinePath != NULL) {
+        int regressions = bench.compareBaseline(baselinePath, threshold);
+        if (regressions < 0) {
+            fprintf(stderr, "%s: cannot read the baseline\n", baselinePath);
+            return 2;
+        }
+        if (regressions > 0) {
+            printf("%d benchmark(s) slower than the baseline by more than %.1f%%\n", regressions, threshold);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#endif /* __linux__ */
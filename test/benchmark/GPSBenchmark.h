@@ -0,0 +1,316 @@
+/**
+ ******************************************************************************
+ * @file    GPSBenchmark.h
+ * @author  AST/CL
+ * @version V1.1.0
+ * @date    Oct, 2026
+ * @brief   Host-side benchmark suite of the GPSProvider code paths.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *   1. Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimer in the documentation
+ *      and/or other materials provided with the distribution.
+ *   3. Neither the name of STMicroelectronics nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef __GPS_BENCHMARK_H__
+#define __GPS_BENCHMARK_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "GPSProvider.h"
+
+//
+// Host-only (Linux) micro- and macro-benchmarks of the code paths the
+// applications depend on:
+//
+//      facade.process          GPSProvider::process() dispatch to the backend
+//      facade.location_cb      lpmGetImmediateLocation() down to the callback
+//      nmea.parse              GPSNmeaParser, per sentence
+//      nmea.parse_naive        copy-then-strtok() parser, for comparison
+//      geofence.evaluate.<N>   GPSGeofenceEngine against N fences, per fix
+//      geofence.wakeup.<N>     GPSGeofenceWakeup planned checks vs 1 s polling
+//      geofence.index.<N>      GPSGeofenceIndex query, 1k to 1M fences
+//      kernel.fence_test.*     per-fence test, double and fixed point
+//      kernel.odo_step.*       distance between fixes, double and fixed point
+//      datalog.log             GPSDatalogEngine record encode and append
+//      datalog.query           GPSDatalogEngine query, per entry returned
+//      datalog.mirror.*        GPSDatalogMirror vs the backend, per 10-entry query
+//      datalog.download.*      GPSDatalogDownloader bulk vs per-entry callbacks
+//      datalog.archive.open.<N> GPSDatalogArchive open() and close() of an N record file
+//      datalog.archive.scan    GPSDatalogArchive open and full read of 2M records vs read(), per record
+//      logblock.encode/decode  GPSLogBlock columnar format, per entry
+//      wire.encode/decode      GPSWireEncoder/GPSWireDecoder stream, per fix
+//      track.simplify.<T>m     GPSTrackSimplifier at a T meter tolerance, per fix
+//      deadreckoning.<T>m      GPSDeadReckoning with a T meter error threshold, per query
+//      power.scheduler         GPSPowerScheduler time in mode on a commute replay, per fix
+//      odometer.update         GPSOdometer, per fix
+//      odometer.drift          GPSOdometer total over 125,000 km against reference sums, per fix
+//      frame.*                 three per-fix distances, own cos() vs GPSLocalFrame
+//      replay.pipeline         GPSReplayProvider capture-to-callback, per fix
+//      replay.instrumented     the replay with a geofence, the datalog and the odometer, per fix
+//      replay.instrumented.traced  the same recording every stage (GPS_TRACE builds)
+//      geofence.virtualizer    GPSGeofenceVirtualizer on a replay, per fix
+//      ring.stress.blocking    GPSRingBuffer fed by a flow-controlled producer thread, per byte
+//      ring.stress.uart.<B>    the same fed at B baud without flow control, per byte
+//
+// The suite is a test program of its own, kept out of the library
+// sources; main.cpp forwards to run() and the Makefile builds it on the
+// host:
+//
+//      make -C test/benchmark
+//      gpsbench --json results.json                    # record
+//      gpsbench --baseline results.json --threshold 5  # compare
+//
+// Every benchmark is calibrated to last about setMinTime() and repeated
+// setRepetitions() times; the fastest repetition is the reported value,
+// the least disturbed by the rest of the system. The input is a synthetic
+// track, or the NMEA capture given to setCapture().
+//
+// The kernel.* cases time both location representations in any build;
+// the components use the one selected by GPS_LOCATION_FIXED_POINT, which
+// the JSON output records ("representation"), so the two builds of a
+// target can be compared with --baseline.
+//
+// GPS_PROCESS_STATS and GPS_TRACE are build options as well ("instrumentation"
+// in the JSON output); their overhead is the replay.instrumented change
+// between a plain build and an instrumented one:
+//
+//      make -C test/benchmark -B
+//      gpsbench --filter replay.instrumented --json plain.json
+//      make -C test/benchmark -B DEFINES=-DGPS_TRACE
+//      gpsbench --filter replay.instrumented --baseline plain.json
+//
+// Besides its time per operation, a benchmark may report figures of merit
+// (ratios, counts, rates such as fences/s) with report()/reportRate();
+// they are printed and written to the JSON "metrics" object.
+//
+// compareBaseline() fails a benchmark whose median time per operation
+// exceeds the baseline median by more than the threshold; run() then
+// returns 1. The median is compared rather than the fastest repetition,
+// which a single lucky run can set.
+//
+
+class GPSBenchmark {
+public:
+    static const unsigned MAX_METRICS = 6;
+
+    /** Figure of merit reported by a benchmark besides its time */
+    struct Metric_t {
+        const char *name;
+        double   value;
+    };
+
+    /** Result of one benchmark */
+    struct Result_t {
+        char     name[32];
+        const char *op;        /**< what one operation is, e.g. "fix" */
+        double   nsPerOp;      /**< fastest repetition */
+        double   medianNsPerOp;
+        uint64_t opsPerRep;
+        unsigned repetitions;
+        Metric_t metrics[MAX_METRICS];
+        unsigned metricCount;
+    };
+
+    typedef uint64_t (*BenchmarkFunction_t)(GPSBenchmark &bench, unsigned param, uint64_t iterations);
+
+    static const unsigned MAX_RESULTS = 64;
+    static const unsigned MAX_REPETITIONS = 31;
+
+    GPSBenchmark();
+    virtual ~GPSBenchmark();
+
+    /**
+     * Time each repetition is calibrated to (default 100 ms).
+     */
+    void setMinTime(unsigned ms) {
+        _minTimeNs = (uint64_t)((ms > 0) ? ms : 1) * 1000000ULL;
+    }
+
+    /**
+     * Repetitions per benchmark, 1 to MAX_REPETITIONS (default 5).
+     */
+    void setRepetitions(unsigned repetitions);
+
+    /**
+     * Fence count of the large geofence benchmark (default 4096).
+     */
+    void setFenceCount(unsigned count) {
+        _fenceCount = (count > 0) ? count : 1;
+    }
+
+    /**
+     * Run only the benchmarks whose name contains filter (NULL: all).
+     */
+    void setFilter(const char *filter) {
+        _filter = filter;
+    }
+
+    /**
+     * Use an NMEA capture instead of the synthetic track.
+     *
+     * @return false if the file cannot be read or holds no fix.
+     */
+    bool setCapture(const char *path);
+
+    /**
+     * Directory for the scratch datalog and capture files (default /tmp).
+     */
+    void setTempDir(const char *dir) {
+        _tempDir = dir;
+    }
+
+    /**
+     * Run the selected benchmarks; results are printed as they complete.
+     *
+     * @return the number of benchmarks run.
+     */
+    unsigned runAll(void);
+
+    unsigned getResultCount(void) const {
+        return _resultCount;
+    }
+
+    const Result_t &getResult(unsigned index) const {
+        return _results[index];
+    }
+
+    /**
+     * Write the results as JSON; "-" writes to stdout.
+     *
+     * @return 0 on success, -1 on I/O error.
+     */
+    int writeJson(const char *path) const;
+
+    /**
+     * Compare the results with a JSON file written by writeJson() and print
+     * the differences. Benchmarks missing from either side are skipped.
+     *
+     * @param  maxRegression allowed slowdown, percent.
+     * @return the number of regressions, -1 if the baseline cannot be read.
+     */
+    int compareBaseline(const char *path, double maxRegression) const;
+
+    /**
+     * Command line entry point: [--json path] [--baseline path]
+     * [--threshold percent] [--filter text] [--fences count]
+     * [--min-time ms] [--repetitions n] [--capture path] [--tmpdir dir].
+     *
+     * @return 0 on success, 1 on regression, 2 on usage or I/O error.
+     */
+    static int run(int argc, char **argv);
+
+    /* -- for the benchmark functions -- */
+
+    /** Exclude what follows (setup) from the measured time. */
+    void pauseTiming(void);
+
+    /** Measure again from now. */
+    void resumeTiming(void);
+
+    /**
+     * Attach a figure of merit (ratio, count...) to the benchmark; the
+     * value of the last repetition is kept.
+     */
+    void report(const char *metric, double value);
+
+    /**
+     * Attach a rate: perOp items per operation, reported per second of
+     * the fastest repetition.
+     */
+    void reportRate(const char *metric, double perOp);
+
+    /** Keep a computed value alive so the work is not optimized out. */
+    void consume(uint64_t value) {
+        _sink += value;
+    }
+
+    const uint8_t *getCapture(size_t &len) const {
+        len = _captureLen;
+        return _capture;
+    }
+
+    unsigned getCaptureSentences(void) const {
+        return _captureSentences;
+    }
+
+    /**
+     * @return the capture written to a scratch file, NULL on I/O error.
+     */
+    const char *getCapturePath(void);
+
+    /**
+     * @return the path of a scratch file named after suffix (removed).
+     */
+    const char *getScratchPath(const char *suffix);
+
+    /**
+     * @return the capture fixes, decoded once.
+     */
+    const GPSProvider::LocationUpdateParams_t *getFixes(unsigned &count) const {
+        count = _fixCount;
+        return _fixes;
+    }
+
+private:
+    bool loadFixes(void);
+    void generateTrack(void);
+    bool selected(const char *name) const;
+    uint64_t measure(BenchmarkFunction_t function, unsigned param, uint64_t iterations);
+    void runBenchmark(const char *name, const char *op, BenchmarkFunction_t function, unsigned param);
+
+    uint64_t                _minTimeNs;
+    unsigned                _repetitions;
+    unsigned                _fenceCount;
+    const char              *_filter;
+    const char              *_tempDir;
+
+    uint8_t                 *_capture;
+    size_t                  _captureLen;
+    unsigned                _captureSentences;
+    GPSProvider::LocationUpdateParams_t *_fixes;
+    unsigned                _fixCount;
+    char                    _capturePath[256];
+    char                    _scratchPath[256];
+
+    Result_t                _results[MAX_RESULTS];
+    unsigned                _resultCount;
+    Metric_t                _metrics[MAX_METRICS];
+    bool                    _rates[MAX_METRICS];
+    unsigned                _metricCount;
+
+    uint64_t                _startNs;
+    uint64_t                _elapsedNs;
+    bool                    _timing;
+    volatile uint64_t       _sink;
+
+    /* disallow copy constructor and assignment operators */
+    GPSBenchmark(const GPSBenchmark&);
+    GPSBenchmark & operator= (const GPSBenchmark&);
+};
+
+#endif /* __GPS_BENCHMARK_H__ */